@@ -185,32 +185,21 @@ struct OptimizerParameters {
   double stepLength = 1.0;
 };
 
-template<unsigned dimensionality, typename FloatType, bool SIMD>
-boost::optional<unsigned> eigenRefine(
-  const Eigen::MatrixXd& squaredBounds,
-  const std::vector<DistanceGeometry::ChiralConstraint>& chiralConstraints,
-  const std::vector<DistanceGeometry::DihedralConstraint>& dihedralConstraints,
-  const Eigen::MatrixXd& positions,
-  OptimizerParameters optimizerParameters = {}
+/* Chiral inversion and fourth dimension compression stages, the latter until
+ * the gradient norm falls below gradNorm
+ */
+template<typename RefinementType>
+boost::optional<unsigned> refineStages(
+  RefinementType& refinementFunctor,
+  typename RefinementType::VectorType& transformedPositions,
+  const double gradNorm,
+  OptimizerParameters optimizerParameters
 ) {
-  unsigned iterationCount = 0;
+  using FloatType = typename RefinementType::FloatingPointType;
+  constexpr unsigned dimensionality = DistanceGeometry::RefinementTraits<RefinementType>::DimensionalityConstant::value;
+  const unsigned N = transformedPositions.size() / dimensionality;
 
-  using FullRefinementType = DistanceGeometry::EigenRefinementProblem<dimensionality, FloatType, SIMD>;
-
-  const unsigned N = positions.size() / dimensionality;
-  /* Transfer positions into vector form */
-
-  Eigen::MatrixXd copiedPositions = positions;
-  typename FullRefinementType::VectorType transformedPositions = Eigen::Map<Eigen::VectorXd>(
-    copiedPositions.data(),
-    copiedPositions.cols() * copiedPositions.rows()
-  ).template cast<FloatType>().eval();
-
-  FullRefinementType refinementFunctor {
-    squaredBounds,
-    chiralConstraints,
-    dihedralConstraints
-  };
+  unsigned iterationCount = 0;
 
   double initiallyCorrectChiralConstraints = refinementFunctor.calculateProportionChiralConstraintsCorrectSign(transformedPositions);
 
@@ -228,7 +217,7 @@ boost::optional<unsigned> eigenRefine(
 
   /* First stage: Invert all chiral constraints */
   if(initiallyCorrectChiralConstraints < 1) {
-    InversionOrIterLimitStop<FullRefinementType> inversionChecker {refinementFunctor};
+    InversionOrIterLimitStop<RefinementType> inversionChecker {refinementFunctor};
 
     unsigned iterations;
     try {
@@ -257,6 +246,7 @@ boost::optional<unsigned> eigenRefine(
   refinementFunctor.compressFourthDimension = true;
 
   GradientOrIterLimitStop<FloatType> gradientChecker;
+  gradientChecker.gradNorm = gradNorm;
 
   unsigned iterations;
   try {
@@ -283,8 +273,109 @@ boost::optional<unsigned> eigenRefine(
   return iterationCount;
 }
 
-
 template<unsigned dimensionality, typename FloatType, bool SIMD>
+boost::optional<unsigned> eigenRefine(
+  const Eigen::MatrixXd& squaredBounds,
+  const std::vector<DistanceGeometry::ChiralConstraint>& chiralConstraints,
+  const std::vector<DistanceGeometry::DihedralConstraint>& dihedralConstraints,
+  const Eigen::MatrixXd& positions,
+  const bool pruneDistanceTerms = true,
+  OptimizerParameters optimizerParameters = {}
+) {
+  using FullRefinementType = DistanceGeometry::EigenRefinementProblem<dimensionality, FloatType, SIMD>;
+
+  /* Transfer positions into vector form */
+  Eigen::MatrixXd copiedPositions = positions;
+  typename FullRefinementType::VectorType transformedPositions = Eigen::Map<Eigen::VectorXd>(
+    copiedPositions.data(),
+    copiedPositions.cols() * copiedPositions.rows()
+  ).template cast<FloatType>().eval();
+
+  FullRefinementType refinementFunctor {
+    squaredBounds,
+    chiralConstraints,
+    dihedralConstraints
+  };
+  refinementFunctor.pruneDistanceTerms = pruneDistanceTerms;
+
+  return refineStages(
+    refinementFunctor,
+    transformedPositions,
+    1e-5,
+    optimizerParameters
+  );
+}
+
+/* Both stages in single precision to a loose gradient, then polishing in
+ * double precision to the same gradient as eigenRefine
+ */
+template<unsigned dimensionality>
+boost::optional<unsigned> mixedPrecisionRefine(
+  const Eigen::MatrixXd& squaredBounds,
+  const std::vector<DistanceGeometry::ChiralConstraint>& chiralConstraints,
+  const std::vector<DistanceGeometry::DihedralConstraint>& dihedralConstraints,
+  const Eigen::MatrixXd& positions
+) {
+  using SingleRefinementType = DistanceGeometry::EigenRefinementProblem<dimensionality, float, false>;
+  using DoubleRefinementType = DistanceGeometry::EigenRefinementProblem<dimensionality, double, false>;
+
+  Eigen::MatrixXd copiedPositions = positions;
+  typename SingleRefinementType::VectorType singlePositions = Eigen::Map<Eigen::VectorXd>(
+    copiedPositions.data(),
+    copiedPositions.cols() * copiedPositions.rows()
+  ).template cast<float>().eval();
+
+  SingleRefinementType singleRefinementFunctor {
+    squaredBounds,
+    chiralConstraints,
+    dihedralConstraints
+  };
+
+  auto singleIterations = refineStages(
+    singleRefinementFunctor,
+    singlePositions,
+    1e-3,
+    OptimizerParameters {}
+  );
+  if(!singleIterations) {
+    return boost::none;
+  }
+
+  typename DoubleRefinementType::VectorType transformedPositions = singlePositions.template cast<double>();
+  DoubleRefinementType refinementFunctor {
+    squaredBounds,
+    chiralConstraints,
+    dihedralConstraints
+  };
+  refinementFunctor.compressFourthDimension = true;
+
+  Temple::Lbfgs<double, 32> optimizer;
+  GradientOrIterLimitStop<double> gradientChecker;
+
+  unsigned iterations;
+  try {
+    auto result = optimizer.minimize(
+      transformedPositions,
+      refinementFunctor,
+      gradientChecker
+    );
+    iterations = result.iterations;
+  } catch (...) {
+    return boost::none;
+  }
+
+  if(iterations >= refinementStepLimit) {
+    return boost::none;
+  }
+
+  if(refinementFunctor.proportionChiralConstraintsCorrectSign < 1) {
+    return boost::none;
+  }
+
+  return singleIterations.value() + iterations;
+}
+
+template<unsigned dimensionality, typename FloatType, bool SIMD, bool pruned = true>
 struct EigenFunctor final : public TimingFunctor {
   boost::optional<unsigned> value(
     const Eigen::MatrixXd& squaredBounds,
@@ -296,7 +387,8 @@ struct EigenFunctor final : public TimingFunctor {
       squaredBounds,
       chiralConstraints,
       dihedralConstraints,
-      positions
+      positions,
+      pruned
     );
   }
 
@@ -311,14 +403,37 @@ struct EigenFunctor final : public TimingFunctor {
 
     if(SIMD) {
       composite += "1>";
-    } else {
+    } else if(pruned) {
       composite += "0>";
+    } else {
+      composite += "0, unpruned>";
     }
 
     return composite;
   }
 };
 
+template<unsigned dimensionality>
+struct MixedPrecisionFunctor final : public TimingFunctor {
+  boost::optional<unsigned> value(
+    const Eigen::MatrixXd& squaredBounds,
+    const std::vector<DistanceGeometry::ChiralConstraint>& chiralConstraints,
+    const std::vector<DistanceGeometry::DihedralConstraint>& dihedralConstraints,
+    const Eigen::MatrixXd& positions
+  ) final {
+    return mixedPrecisionRefine<dimensionality>(
+      squaredBounds,
+      chiralConstraints,
+      dihedralConstraints,
+      positions
+    );
+  }
+
+  std::string name() final {
+    return "Eigen<" + std::to_string(dimensionality) + ", flt/dbl, 0>";
+  }
+};
+
 void writeHeaders(
   std::ofstream& benchmarkFile
 ) {
@@ -327,7 +442,11 @@ void writeHeaders(
     "N",
     "E",
     "Eigen",
-    "EigenSIMD"
+    "EigenFloat",
+    "EigenSIMD",
+    "EigenSIMDFloat",
+    "EigenUnpruned",
+    "EigenMixed"
   };
 
   for(unsigned i = 0; i < 2; ++i) {
@@ -351,7 +470,9 @@ enum class Algorithm {
   EigenDouble,
   EigenFloat,
   EigenSIMDDouble,
-  EigenSIMDFloat
+  EigenSIMDFloat,
+  EigenUnprunedDouble,
+  EigenMixed
 };
 
 void benchmark(
@@ -425,6 +546,22 @@ void benchmark(
     );
   }
 
+  if(algorithmChoice == Algorithm::All || algorithmChoice == Algorithm::EigenUnprunedDouble) {
+    functors.emplace_back(
+      std::make_unique<
+        EigenFunctor<4, double, false, false>
+      >()
+    );
+  }
+
+  if(algorithmChoice == Algorithm::All || algorithmChoice == Algorithm::EigenMixed) {
+    functors.emplace_back(
+      std::make_unique<
+        MixedPrecisionFunctor<4>
+      >()
+    );
+  }
+
   auto results = timeFunctors<nExperiments>(molecule, functors);
 
   double smallestAverage = std::min_element(
@@ -475,7 +612,9 @@ const std::string algorithmChoices =
   "  1 - Eigen<dimensionality=4, double, SIMD=false>\n"
   "  2 - Eigen<dimensionality=4, float, SIMD=false>\n"
   "  3 - Eigen<dimensionality=4, double, SIMD=true>\n"
-  "  4 - Eigen<dimensionality=4, float, SIMD=true>\n";
+  "  4 - Eigen<dimensionality=4, float, SIMD=true>\n"
+  "  5 - Eigen<dimensionality=4, double, SIMD=false> without distance term pruning\n"
+  "  6 - Eigen<dimensionality=4, float then double, SIMD=false>\n";
 
 constexpr const char* description =
   "Benchmarks various refinement error functions and optimizer combinations\n"
@@ -523,7 +662,7 @@ int main(int argc, char* argv[]) {
   if(options_variables_map.count("c") > 0) {
     unsigned combination = options_variables_map["c"].as<unsigned>();
 
-    if(combination > 4) {
+    if(combination > 6) {
       std::cout << "Specified algorithm is out of bounds. Valid choices are:" << nl
         << algorithmChoices;
       return 0;
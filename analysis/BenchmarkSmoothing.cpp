@@ -0,0 +1,247 @@
+/*!@file
+ * @copyright This code is licensed under the 3-clause BSD license.
+ *   Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.
+ *   See LICENSE.txt for details.
+ */
+
+#define BOOST_FILESYSTEM_NO_DEPRECATED
+
+#include "boost/filesystem.hpp"
+#include "boost/program_options.hpp"
+
+#include "Molassembler/DistanceGeometry/DistanceBoundsMatrix.h"
+#include "Molassembler/DistanceGeometry/SpatialModel.h"
+#include "Molassembler/Graph/PrivateGraph.h"
+#include "Molassembler/IO.h"
+#include "Molassembler/Molecule.h"
+#include "Molassembler/Options.h"
+#include "Molassembler/Temple/Functional.h"
+#include "Molassembler/Temple/Random.h"
+#include "Molassembler/Temple/constexpr/Numeric.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace Scine;
+using namespace Molassembler;
+
+constexpr std::size_t nExperiments = 5;
+
+std::ostream& nl(std::ostream& os) {
+  os << '\n';
+  return os;
+}
+
+/* Unblocked triple loop Floyd's algorithm as previously implemented by
+ * DistanceBoundsMatrix::smooth, for reference
+ */
+void referenceSmooth(Eigen::Ref<Eigen::MatrixXd> matrix) {
+  const unsigned N = matrix.cols();
+
+  for(AtomIndex k = 0; k < N; ++k) {
+    for(AtomIndex i = 0; i < N - 1; ++i) {
+      auto upperLowerIK = (i < k
+        ? std::pair<double&, double&>(matrix(i, k), matrix(k, i))
+        : std::pair<double&, double&>(matrix(k, i), matrix(i, k))
+      );
+      double& upperIK = upperLowerIK.first;
+      double& lowerIK = upperLowerIK.second;
+
+      if(lowerIK > upperIK) {
+        throw std::runtime_error("Triangle smoothing encountered bound inversion");
+      }
+
+      for(AtomIndex j = i + 1; j < N; ++j) {
+        double& upperIJ = matrix(i, j);
+        double& lowerIJ = matrix(j, i);
+
+        auto upperLowerJK = (j < k
+          ? std::pair<double&, double&>(matrix(j, k), matrix(k, j))
+          : std::pair<double&, double&>(matrix(k, j), matrix(j, k))
+        );
+        double& upperJK = upperLowerJK.first;
+        double& lowerJK = upperLowerJK.second;
+
+        if(upperIJ > upperIK + upperJK) {
+          upperIJ = upperIK + upperJK;
+        }
+
+        if(lowerIJ < lowerIK - upperJK) {
+          lowerIJ = lowerIK - upperJK;
+        } else if(lowerIJ < lowerJK - upperIK) {
+          lowerIJ = lowerJK - upperIK;
+        }
+
+        if(lowerIJ > upperIJ) {
+          throw std::runtime_error("Triangle smoothing encountered bound inversion");
+        }
+      }
+    }
+  }
+}
+
+/* Bounds matrix for random points in a cube: Tight bounds for close pairs and
+ * a few distant pairs, default bounds for all others
+ */
+Eigen::MatrixXd syntheticBounds(const unsigned N) {
+  const Eigen::MatrixXd points = Eigen::MatrixXd::Random(3, N) * 2 * std::cbrt(N);
+  Eigen::MatrixXd bounds(N, N);
+  bounds.diagonal().setZero();
+  for(unsigned i = 0; i < N; ++i) {
+    for(unsigned j = i + 1; j < N; ++j) {
+      const double distance = (points.col(i) - points.col(j)).norm();
+      if(distance < 3 || Temple::Random::getSingle<double>(0.0, 1.0, randomnessEngine()) < 0.02) {
+        bounds(i, j) = 1.05 * distance;
+        bounds(j, i) = 0.95 * distance;
+      } else {
+        bounds(i, j) = DistanceGeometry::DistanceBoundsMatrix::defaultUpper;
+        bounds(j, i) = 1.0;
+      }
+    }
+  }
+  return bounds;
+}
+
+template<typename Smoothing>
+std::pair<double, double> timeSmoothing(
+  const Eigen::MatrixXd& bounds,
+  Smoothing&& smoothing,
+  Eigen::MatrixXd& result
+) {
+  using namespace std::chrono;
+
+  std::vector<double> timings;
+  for(std::size_t n = 0; n < nExperiments; ++n) {
+    result = bounds;
+    const auto start = steady_clock::now();
+    smoothing(result);
+    const auto end = steady_clock::now();
+    timings.push_back(duration_cast<microseconds>(end - start).count());
+  }
+
+  const double average = Temple::average(timings);
+  return {average, Temple::stddev(timings, average)};
+}
+
+void benchmark(
+  const std::string& name,
+  const Eigen::MatrixXd& bounds,
+  const bool withReference,
+  std::ofstream& benchmarkFile
+) {
+  Eigen::MatrixXd blocked;
+  const auto blockedTimings = timeSmoothing(
+    bounds,
+    [](Eigen::MatrixXd& m) { DistanceGeometry::DistanceBoundsMatrix::smooth(m); },
+    blocked
+  );
+
+  std::cout << std::fixed << std::setprecision(0)
+    << std::setw(30) << name
+    << std::setw(8) << bounds.cols()
+    << std::setw(14) << blockedTimings.first
+    << std::setw(12) << blockedTimings.second;
+
+  benchmarkFile << "\"" << name << "\", " << bounds.cols() << ", "
+    << blockedTimings.first << ", " << blockedTimings.second;
+
+  if(withReference) {
+    Eigen::MatrixXd reference;
+    const auto referenceTimings = timeSmoothing(bounds, referenceSmooth, reference);
+    const double maxDeviation = (blocked - reference).cwiseAbs().maxCoeff();
+
+    std::cout
+      << std::setw(14) << referenceTimings.first
+      << std::setw(12) << referenceTimings.second
+      << std::setw(10) << std::setprecision(2) << (referenceTimings.first / blockedTimings.first)
+      << std::setw(12) << std::scientific << std::setprecision(1) << maxDeviation;
+
+    benchmarkFile << ", " << referenceTimings.first << ", " << referenceTimings.second;
+  }
+
+  std::cout << nl;
+  benchmarkFile << nl;
+}
+
+constexpr const char* description =
+  "Benchmarks blocked triangle smoothing of distance bounds against the\n"
+  "previous unblocked implementation on bounds of MOLFiles in a directory\n"
+  "and on synthetic bounds matrices of a chosen size. Times are given in\n"
+  "microseconds. Use OMP_NUM_THREADS to control parallelism.\n";
+
+int main(int argc, char* argv[]) {
+  // Set up option parsing
+  boost::program_options::options_description options_description("Recognized options");
+  options_description.add_options()
+    ("help", "Produce help message")
+    ("m", boost::program_options::value<std::string>(), "Path to MOLFiles to benchmark")
+    ("n", boost::program_options::value<unsigned>()->default_value(5000), "Size of synthetic bounds matrix, zero to skip")
+    ("no-reference", "Skip timing of the unblocked reference implementation")
+  ;
+
+  // Parse
+  boost::program_options::variables_map options_variables_map;
+  boost::program_options::store(
+    boost::program_options::parse_command_line(argc, argv, options_description),
+    options_variables_map
+  );
+  boost::program_options::notify(options_variables_map);
+
+  if(options_variables_map.count("help") > 0) {
+    std::cout << description << "\n" << options_description << std::endl;
+    return 0;
+  }
+
+  const bool withReference = options_variables_map.count("no-reference") == 0;
+
+  std::ofstream benchmarkFile("smoothing_timings.csv");
+  benchmarkFile << "\"Name\", \"N\", \"Blocked\", \"Blocked sigma\"";
+  if(withReference) {
+    benchmarkFile << ", \"Reference\", \"Reference sigma\"";
+  }
+  benchmarkFile << nl;
+
+  std::cout
+    << std::setw(30) << "Name"
+    << std::setw(8) << "N"
+    << std::setw(14) << "Blocked"
+    << std::setw(12) << "sigma";
+  if(withReference) {
+    std::cout
+      << std::setw(14) << "Reference"
+      << std::setw(12) << "sigma"
+      << std::setw(10) << "Speedup"
+      << std::setw(12) << "Max. dev.";
+  }
+  std::cout << nl;
+
+  if(options_variables_map.count("m") > 0) {
+    const std::string molPath = options_variables_map["m"].as<std::string>();
+    for(
+      const boost::filesystem::path& currentFilePath :
+      boost::filesystem::recursive_directory_iterator(molPath)
+    ) {
+      if(currentFilePath.extension() != ".mol") {
+        continue;
+      }
+
+      const Molecule molecule = IO::read(currentFilePath.string());
+      DistanceGeometry::SpatialModel spatialModel {molecule, DistanceGeometry::Configuration {}};
+      const DistanceGeometry::DistanceBoundsMatrix bounds {
+        molecule.graph().inner(),
+        spatialModel.makePairwiseBounds()
+      };
+
+      benchmark(currentFilePath.stem().string(), bounds.access(), withReference, benchmarkFile);
+    }
+  }
+
+  const unsigned syntheticSize = options_variables_map["n"].as<unsigned>();
+  if(syntheticSize > 0) {
+    benchmark("synthetic", syntheticBounds(syntheticSize), withReference, benchmarkFile);
+  }
+
+  return 0;
+}
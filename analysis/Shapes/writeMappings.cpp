@@ -144,6 +144,8 @@ int main(int argc, char* argv[]) {
     ("s", boost::program_options::value<unsigned>(), "Source shape index")
     ("t", boost::program_options::value<unsigned>(), "Target shape index")
     ("a", boost::program_options::value<bool>(), "Calculate ambiguity of lowest mappings")
+    ("table", boost::program_options::value<std::string>(), "Write binary table of all transition mappings to file")
+    ("max-size", boost::program_options::value<unsigned>()->default_value(8), "Largest shape size in the binary table")
   ;
 
   // Parse
@@ -234,6 +236,16 @@ int main(int argc, char* argv[]) {
     }
   }
 
+  if(options_variables_map.count("table") > 0) {
+    const std::string filename = options_variables_map["table"].as<std::string>();
+    Shapes::populateMappings(options_variables_map["max-size"].as<unsigned>());
+    const std::vector<std::uint8_t> table = Shapes::dumpMappings();
+
+    std::ofstream file(filename, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(table.data()), table.size());
+    std::cout << "Wrote table of " << table.size() << " bytes to " << filename << nl;
+  }
+
   if(options_variables_map.count("a") > 0) {
     std::vector<AmbiguityEntry> ambiguities;
 
@@ -497,7 +497,7 @@ MoleculeDGInformation gatherDGInformation(
 
   // Extract gathered data
   MoleculeDGInformation data;
-  data.bounds = spatialModel.makePairwiseBounds();
+  SpatialModel::BoundsMatrix bounds = spatialModel.makePairwiseBounds();
   data.chiralConstraints = spatialModel.getChiralConstraints();
   data.dihedralConstraints = spatialModel.getDihedralConstraints();
   data.rotatableGroups = MoleculeDGInformation::make(data.dihedralConstraints, molecule);
@@ -507,8 +507,8 @@ MoleculeDGInformation gatherDGInformation(
     const AtomIndex N = molecule.graph().N();
     for(AtomIndex i = 0; i < N; ++i) {
       for(AtomIndex j = i + 1; j < N; ++j) {
-        double& lower = data.bounds(j, i);
-        double& upper = data.bounds(i, j);
+        double& lower = bounds(j, i);
+        double& upper = bounds(i, j);
 
         if(lower == 0.0 && upper == 0.0) {
           double vdwLowerBound = (
@@ -523,9 +523,9 @@ MoleculeDGInformation gatherDGInformation(
     }
 
     // Triangle smooth
-    DistanceBoundsMatrix::smooth(data.bounds);
+    DistanceBoundsMatrix::smooth(bounds);
     // Tetrangle smooth
-    unsigned iterations = tetrangleSmooth(data.bounds);
+    unsigned iterations = tetrangleSmooth(bounds);
     std::cout << "Applied " << iterations << " iterations of tetrangle smoothing\n";
   }
 
@@ -535,8 +535,8 @@ MoleculeDGInformation gatherDGInformation(
       auto iGraphDistances = distance(i, molecule.graph());
 
       for(AtomIndex j = i + 1; j < N; ++j) {
-        const double lower = data.bounds(j, i);
-        const double upper = data.bounds(i, j);
+        const double lower = bounds(j, i);
+        const double upper = bounds(i, j);
 
         if(lower != 0.0 || upper != 0.0) {
           std::cout << i << " - " << j
@@ -547,6 +547,7 @@ MoleculeDGInformation gatherDGInformation(
     }
   }
 
+  data.boundsPtr = std::make_shared<SparseBounds>(molecule.graph().inner(), bounds);
   return data;
 }
 
@@ -632,7 +633,7 @@ std::list<RefinementData> debugRefinement(
 
     ExplicitBoundsGraph explicitGraph {
       molecule.graph().inner(),
-      DgData.bounds
+      *DgData.boundsPtr
     };
 
     auto distanceBoundsResult = explicitGraph.makeDistanceBounds();
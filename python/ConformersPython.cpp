@@ -5,6 +5,7 @@
  */
 #include "TypeCasters.h"
 #include "pybind11/eigen.h"
+#include "pybind11/functional.h"
 
 #include "Molassembler/Conformers.h"
 #include "Molassembler/Molecule.h"
@@ -30,6 +31,32 @@ ConformerVariantType variantCast(outcome::result<Utils::PositionCollection> resu
 
 namespace {
 
+using EnsembleCallbackType = std::function<void(unsigned, ConformerVariantType)>;
+
+/* Adapts a python callback to an ensemble callback. The GIL must be released
+ * during ensemble generation since the callback is invoked from worker
+ * threads, which acquire the GIL to call into python.
+ */
+EnsembleCallback ensembleCallback(const EnsembleCallbackType& callback) {
+  return [&callback](unsigned index, outcome::result<Utils::PositionCollection> result) {
+    callback(index, variantCast(std::move(result)));
+  };
+}
+
+using BudgetedVariantType = boost::variant<std::vector<Utils::PositionCollection>, DgError>;
+
+BudgetedVariantType budgetedVariantCast(outcome::result<std::vector<Utils::PositionCollection>> result) {
+  if(result) {
+    return std::move(result.value());
+  }
+
+  if(result.error().category().name() != Detail::DGError_category().name()) {
+    throw std::invalid_argument("Error is not of expected category!");
+  }
+
+  return DgError(result.error().value());
+}
+
 void init_partiality(pybind11::module& dg) {
   pybind11::enum_<DistanceGeometry::Partiality>(
     dg,
@@ -71,6 +98,38 @@ void init_configuration(pybind11::module& dg) {
     "Sets the gradient at which a refinement is considered complete. Defaults to 1e-5."
   );
 
+  configuration.def_readwrite(
+    "mixed_precision_refinement",
+    &DistanceGeometry::Configuration::mixedPrecisionRefinement,
+    "Run the chiral inversion and fourth dimension compression refinement "
+    "stages in single precision, and only the final stage in double precision. "
+    "Defaults to false."
+  );
+
+  configuration.def_readwrite(
+    "trust_region_polishing",
+    &DistanceGeometry::Configuration::trustRegionPolishing,
+    "Switch to a trust region Newton optimizer if progress in the final "
+    "refinement stage stalls. Defaults to false."
+  );
+
+  configuration.def_readwrite(
+    "fixed_atom_elimination",
+    &DistanceGeometry::Configuration::fixedAtomElimination,
+    "Place fixed atoms exactly before refinement and refine only the "
+    "positions of free atoms. Worthwhile if most atoms are fixed. Defaults "
+    "to false."
+  );
+
+  configuration.def_readwrite(
+    "fragment_size",
+    &DistanceGeometry::Configuration::fragmentSize,
+    "Embed molecules with more atoms than this in fragments of approximately "
+    "this size along bridge bonds, then refine the assembled fragments "
+    "jointly. Ignored if fixed positions are set. Defaults to zero, which "
+    "disables fragment embedding."
+  );
+
   configuration.def_readwrite(
     "spatial_model_loosening",
     &DistanceGeometry::Configuration::spatialModelLoosening,
@@ -114,6 +173,60 @@ void init_configuration(pybind11::module& dg) {
   );
 }
 
+void init_ensemble_budget(pybind11::module& dg) {
+  pybind11::class_<DistanceGeometry::EnsembleBudget> budget(
+    dg,
+    "EnsembleBudget",
+    R"delim(
+      Limits on the effort spent in budgeted ensemble generation
+
+      Budgeted ensemble generation keeps attempting new structures until any
+      of its limits is reached. Structures still being generated at that point
+      are cancelled.
+    )delim"
+  );
+
+  budget.def(
+    pybind11::init<>(),
+    "Default-initialize an EnsembleBudget"
+  );
+
+  budget.def_readwrite(
+    "successes",
+    &DistanceGeometry::EnsembleBudget::successes,
+    "Number of successfully generated structures after which to stop. "
+    "Defaults to one."
+  );
+
+  budget.def_readwrite(
+    "time_limit",
+    &DistanceGeometry::EnsembleBudget::timeLimit,
+    "Wall-clock time limit in seconds. By default, or if not positive, there "
+    "is no time limit."
+  );
+
+  budget.def_readwrite(
+    "max_attempts",
+    &DistanceGeometry::EnsembleBudget::maxAttempts,
+    "Maximum number of attempted structures. By default, or if zero, the "
+    "number of attempts is not limited."
+  );
+
+  budget.def_readwrite(
+    "max_failure_rate",
+    &DistanceGeometry::EnsembleBudget::maxFailureRate,
+    "Failure rate above which further attempts are deemed futile. Setting "
+    "this to one disables the check. Defaults to 0.9."
+  );
+
+  budget.def_readwrite(
+    "failure_rate_min_attempts",
+    &DistanceGeometry::EnsembleBudget::failureRateMinAttempts,
+    "Number of finished attempts before the failure rate is considered. "
+    "Defaults to 20."
+  );
+}
+
 void init_error(pybind11::module& dg) {
   pybind11::enum_<DgError> error(
     dg,
@@ -280,6 +393,7 @@ void init_conformers(pybind11::module& m) {
 
   init_partiality(dg);
   init_configuration(dg);
+  init_ensemble_budget(dg);
   init_error(dg);
 
   dg.def(
@@ -386,6 +500,306 @@ void init_conformers(pybind11::module& m) {
     )delim"
   );
 
+  dg.def(
+    "generate_random_ensembles",
+    [](
+      const std::vector<Molecule>& molecules,
+      const std::vector<unsigned>& numStructures,
+      const std::vector<DistanceGeometry::Configuration>& configs
+    ) -> std::vector<std::vector<ConformerVariantType>> {
+      return Temple::map(
+        generateRandomEnsembles(molecules, numStructures, configs),
+        [](std::vector<outcome::result<Utils::PositionCollection>> results) {
+          return Temple::map(std::move(results), variantCast);
+        }
+      );
+    },
+    pybind11::arg("molecules"),
+    pybind11::arg("num_structures"),
+    pybind11::arg("configurations") = std::vector<DistanceGeometry::Configuration> {},
+    R"delim(
+      Generate sets of 3D positions for each of several molecules.
+
+      Batched variant of :func:`generate_random_ensemble`. All structures of
+      all molecules are generated in a single parallel section, so that many
+      small molecules can make full use of available threads.
+
+      .. note::
+         This function is parallelized and will utilize ``OMP_NUM_THREADS``
+         threads.
+
+      .. note::
+         This function advances ``molassembler``'s global PRNG state.
+
+      :param molecules: Molecules to generate positions for
+      :param num_structures: Number of desired structures for each molecule
+      :param configurations: Detailed Distance Geometry settings for each
+        molecule. If empty, the default settings are used for all molecules.
+      :rtype: A list of results as returned by
+        :func:`generate_random_ensemble` for each molecule
+      :raises ValueError: If ``num_structures`` or non-empty
+        ``configurations`` do not match ``molecules`` in length
+
+      >>> butane = io.experimental.from_smiles("CCCC")
+      >>> ethane = io.experimental.from_smiles("CC")
+      >>> results = generate_random_ensembles([butane, ethane], [4, 2])
+      >>> [len(r) for r in results]
+      [4, 2]
+    )delim"
+  );
+
+  dg.def(
+    "generate_ensembles",
+    [](
+      const std::vector<Molecule>& molecules,
+      const std::vector<unsigned>& numStructures,
+      const unsigned seed,
+      const std::vector<DistanceGeometry::Configuration>& configs
+    ) -> std::vector<std::vector<ConformerVariantType>> {
+      return Temple::map(
+        generateEnsembles(molecules, numStructures, seed, configs),
+        [](std::vector<outcome::result<Utils::PositionCollection>> results) {
+          return Temple::map(std::move(results), variantCast);
+        }
+      );
+    },
+    pybind11::arg("molecules"),
+    pybind11::arg("num_structures"),
+    pybind11::arg("seed"),
+    pybind11::arg("configurations") = std::vector<DistanceGeometry::Configuration> {},
+    R"delim(
+      Generate sets of 3D positions for each of several molecules.
+
+      Batched variant of :func:`generate_ensemble`. All structures of all
+      molecules are generated in a single parallel section, so that many small
+      molecules can make full use of available threads.
+
+      .. note::
+         This function is parallelized and will utilize ``OMP_NUM_THREADS``
+         threads. Each molecule's results are reproducible given the same seed
+         and independent of the other molecules.
+
+      :param molecules: Molecules to generate positions for
+      :param num_structures: Number of desired structures for each molecule
+      :param seed: Seed with which to initialize a PRNG with for the conformer
+        generation procedure.
+      :param configurations: Detailed Distance Geometry settings for each
+        molecule. If empty, the default settings are used for all molecules.
+      :rtype: A list of results as returned by :func:`generate_ensemble` for
+        each molecule
+      :raises ValueError: If ``num_structures`` or non-empty
+        ``configurations`` do not match ``molecules`` in length
+
+      >>> butane = io.experimental.from_smiles("CCCC")
+      >>> ethane = io.experimental.from_smiles("CC")
+      >>> results = generate_ensembles([butane, ethane], [4, 2], 1010)
+      >>> [len(r) for r in results]
+      [4, 2]
+    )delim"
+  );
+
+  dg.def(
+    "generate_random_ensemble",
+    [](
+      const Molecule& molecule,
+      const unsigned numStructures,
+      const EnsembleCallbackType& callback,
+      const DistanceGeometry::Configuration& config
+    ) {
+      pybind11::gil_scoped_release release;
+      generateRandomEnsemble(molecule, numStructures, ensembleCallback(callback), config);
+    },
+    pybind11::arg("molecule"),
+    pybind11::arg("num_structures"),
+    pybind11::arg("callback"),
+    pybind11::arg("configuration") = DistanceGeometry::Configuration {},
+    R"delim(
+      Generate a set of 3D positions for a molecule, delivering each as soon as
+      it is generated.
+
+      Streaming variant of the ensemble-returning overload. Each structure is
+      passed to the callback as soon as its generation finishes, so the
+      ensemble need not be held in memory.
+
+      .. note::
+         This function is parallelized and will utilize ``OMP_NUM_THREADS``
+         threads. Callback invocations are unsequenced but the arguments are
+         reproducible given the same global PRNG state.
+
+      .. note::
+         This function advances ``molassembler``'s global PRNG state.
+
+      :param molecule: Molecule to generate positions for. May not contain
+        stereopermutators with zero assignments (no feasible stereopermutations).
+      :param num_structures: Number of desired structures to generate
+      :param callback: Function called exactly once for each structure index
+        with the index and either a position result or an error. Never called
+        simultaneously. If it raises, no further structures are generated and
+        the exception is propagated.
+      :param configuration: Detailed Distance Geometry settings. Defaults are
+        usually fine.
+
+      >>> butane = io.experimental.from_smiles("CCCC")
+      >>> results = {}
+      >>> def store(index, result):
+      ...     results[index] = result
+      >>> generate_random_ensemble(butane, 10, store)
+      >>> sorted(results.keys()) == list(range(10))
+      True
+    )delim"
+  );
+
+  dg.def(
+    "generate_ensemble",
+    [](
+      const Molecule& molecule,
+      const unsigned numStructures,
+      const unsigned seed,
+      const EnsembleCallbackType& callback,
+      const DistanceGeometry::Configuration& config
+    ) {
+      pybind11::gil_scoped_release release;
+      generateEnsemble(molecule, numStructures, seed, ensembleCallback(callback), config);
+    },
+    pybind11::arg("molecule"),
+    pybind11::arg("num_structures"),
+    pybind11::arg("seed"),
+    pybind11::arg("callback"),
+    pybind11::arg("configuration") = DistanceGeometry::Configuration {},
+    R"delim(
+      Generate a set of 3D positions for a molecule, delivering each as soon as
+      it is generated.
+
+      Streaming variant of the ensemble-returning overload. Each structure
+      index yields the same result as the same index of the ensemble-returning
+      overload with an identical seed.
+
+      .. note::
+         This function is parallelized and will utilize ``OMP_NUM_THREADS``
+         threads. Callback invocations are unsequenced but the arguments are
+         reproducible given the same seed.
+
+      :param molecule: Molecule to generate positions for. May not contain
+        stereopermutators with zero assignments (no feasible stereopermutations).
+      :param num_structures: Number of desired structures to generate
+      :param seed: Seed with which to initialize a PRNG with for the conformer
+        generation procedure.
+      :param callback: Function called exactly once for each structure index
+        with the index and either a position result or an error. Never called
+        simultaneously. If it raises, no further structures are generated and
+        the exception is propagated.
+      :param configuration: Detailed Distance Geometry settings. Defaults are
+        usually fine.
+
+      >>> butane = io.experimental.from_smiles("CCCC")
+      >>> failures = []
+      >>> def count_failures(index, result):
+      ...     if isinstance(result, Error):
+      ...         failures.append(index)
+      >>> generate_ensemble(butane, 10, 1010, count_failures)
+      >>> len(failures)
+      0
+    )delim"
+  );
+
+  dg.def(
+    "generate_random_ensemble",
+    [](
+      const Molecule& molecule,
+      const DistanceGeometry::EnsembleBudget& budget,
+      const DistanceGeometry::Configuration& config
+    ) -> BudgetedVariantType {
+      return budgetedVariantCast(generateRandomEnsemble(molecule, budget, config));
+    },
+    pybind11::arg("molecule"),
+    pybind11::arg("budget"),
+    pybind11::arg("configuration") = DistanceGeometry::Configuration {},
+    R"delim(
+      Generate sets of 3D positions for a molecule within a budget.
+
+      Keeps attempting new structures until the desired number of structures
+      is successfully generated or any other limit of the budget is reached,
+      e.g. a time limit or a failure rate indicating that further attempts are
+      futile. Unlike the other overloads, failures are not returned alongside
+      successes.
+
+      .. note::
+         This function is parallelized and will utilize ``OMP_NUM_THREADS``
+         threads. Which structures are successfully generated before the
+         budget is exhausted depends on the timing of their generation.
+
+      .. note::
+         This function advances ``molassembler``'s global PRNG state.
+
+      :param molecule: Molecule to generate positions for. May not contain
+        stereopermutators with zero assignments (no feasible stereopermutations).
+      :param budget: Limits on the effort spent in ensemble generation
+      :param configuration: Detailed Distance Geometry settings. Defaults are
+        usually fine.
+      :rtype: Either a list of up to ``budget.successes`` position results or,
+        if no structure was generated successfully, the error of the first
+        failed attempt.
+
+      >>> butane = io.experimental.from_smiles("CCCC")
+      >>> budget = EnsembleBudget()
+      >>> budget.successes = 5
+      >>> budget.time_limit = 60
+      >>> results = generate_random_ensemble(butane, budget)
+      >>> len(results)
+      5
+    )delim"
+  );
+
+  dg.def(
+    "generate_ensemble",
+    [](
+      const Molecule& molecule,
+      const DistanceGeometry::EnsembleBudget& budget,
+      const unsigned seed,
+      const DistanceGeometry::Configuration& config
+    ) -> BudgetedVariantType {
+      return budgetedVariantCast(generateEnsemble(molecule, budget, seed, config));
+    },
+    pybind11::arg("molecule"),
+    pybind11::arg("budget"),
+    pybind11::arg("seed"),
+    pybind11::arg("configuration") = DistanceGeometry::Configuration {},
+    R"delim(
+      Generate sets of 3D positions for a molecule within a budget.
+
+      Keeps attempting new structures until the desired number of structures
+      is successfully generated or any other limit of the budget is reached,
+      e.g. a time limit or a failure rate indicating that further attempts are
+      futile. Unlike the other overloads, failures are not returned alongside
+      successes.
+
+      .. note::
+         This function is parallelized and will utilize ``OMP_NUM_THREADS``
+         threads. Which structures are successfully generated before the
+         budget is exhausted depends on the timing of their generation, but
+         the i-th attempt yields the same result as the i-th structure of the
+         unbudgeted overload with the same seed.
+
+      :param molecule: Molecule to generate positions for. May not contain
+        stereopermutators with zero assignments (no feasible stereopermutations).
+      :param budget: Limits on the effort spent in ensemble generation
+      :param seed: Seed with which to initialize a PRNG with for the conformer
+        generation procedure.
+      :param configuration: Detailed Distance Geometry settings. Defaults are
+        usually fine.
+      :rtype: Either a list of up to ``budget.successes`` position results or,
+        if no structure was generated successfully, the error of the first
+        failed attempt.
+
+      >>> butane = io.experimental.from_smiles("CCCC")
+      >>> budget = EnsembleBudget()
+      >>> budget.successes = 5
+      >>> results = generate_ensemble(butane, budget, 1010)
+      >>> isinstance(results, Error)
+      False
+    )delim"
+  );
+
   dg.def(
     "generate_random_conformation",
     [](
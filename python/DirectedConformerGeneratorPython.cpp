@@ -21,6 +21,8 @@ using ConformerVariantType = boost::variant<
   DgError
 >;
 extern ConformerVariantType variantCast(outcome::result<Scine::Utils::PositionCollection>);
+extern std::vector<std::uint8_t> binaryFromPythonBytes(const pybind11::bytes& bytes);
+extern pybind11::bytes pythonBytesFromBinary(const std::vector<std::uint8_t>& binary);
 
 void init_directed_conformer_generator(pybind11::module& m) {
   pybind11::class_<DirectedConformerGenerator> dirConfGen(
@@ -323,6 +325,25 @@ void init_directed_conformer_generator(pybind11::module& m) {
     )delim"
   );
 
+  dirConfGen.def(
+    "get_decision_lists",
+    &DirectedConformerGenerator::getDecisionLists,
+    pybind11::arg("frames"),
+    pybind11::arg("fitting_mode") = BondStereopermutator::FittingMode::Nearest,
+    R"delim(
+      Infer decision lists for the relevant bonds of many frames at once.
+
+      Equivalent to calling get_decision_list on each frame, except that only
+      atom stereopermutators constituting relevant bonds are checked. Frames
+      are processed in parallel.
+
+      :param frames: Positions of all frames in bohr, stacked vertically. Rows
+        ``f * N`` through ``(f + 1) * N - 1`` are the positions of frame ``f``.
+      :param fitting_mode: Mode altering how decisions are fitted.
+      :returns: Matrix whose rows are the decision lists of each frame
+    )delim"
+  );
+
   dirConfGen.def_property_readonly_static(
     "UNKNOWN_DECISION",
     [](pybind11::object /* self */) {
@@ -438,12 +459,63 @@ void init_directed_conformer_generator(pybind11::module& m) {
     )delim"
   );
 
+  dirConfGen.def(
+    "checkpoint",
+    [](const DirectedConformerGenerator& generator) -> pybind11::bytes {
+      return pythonBytesFromBinary(generator.checkpoint());
+    },
+    R"delim(
+      Serializes enumeration progress
+
+      Stores the considered bonds, the seed of the last enumeration and the
+      set of finished decision lists compactly as CBOR. Safe to call from
+      within the enumeration callback.
+    )delim"
+  );
+
+  dirConfGen.def(
+    "resume_enumeration",
+    [](
+      DirectedConformerGenerator& generator,
+      const pybind11::bytes& checkpoint,
+      std::function<void(const DirectedConformerGenerator::DecisionList&, Scine::Utils::PositionCollection)> callback,
+      const DirectedConformerGenerator::EnumerationSettings& settings
+    ) {
+      const auto binary = binaryFromPythonBytes(checkpoint);
+      pybind11::gil_scoped_release release;
+      generator.resumeEnumeration(binary, std::move(callback), settings);
+    },
+    pybind11::arg("checkpoint"),
+    pybind11::arg("callback"),
+    pybind11::arg("settings") = DirectedConformerGenerator::EnumerationSettings {},
+    R"delim(
+      Continues an enumeration from a checkpoint
+
+      Enumerates conformers of all decision lists not finished in the
+      checkpoint. With the same settings as the checkpointed enumeration, the
+      conformers yielded are identical to those of an uninterrupted
+      enumeration.
+
+      :param checkpoint: Result of :meth:`checkpoint`
+      :param callback: Function called with decision list and conformer
+        positions for each successfully generated pair.
+      :param settings: Further parameters for enumeration algorithms
+    )delim"
+  );
+
   dirConfGen.def(
     "relabeler",
     &DirectedConformerGenerator::relabeler,
     "Generate a Relabeler for the underlying molecule and bonds"
   );
 
+  dirConfGen.def(
+    "streaming_relabeler",
+    &DirectedConformerGenerator::streamingRelabeler,
+    pybind11::arg("resolution") = 720,
+    "Generate a StreamingRelabeler for the underlying molecule and bonds"
+  );
+
   dirConfGen.def(
     "bin_midpoint_integers",
     &DirectedConformerGenerator::binMidpointIntegers,
@@ -553,4 +625,83 @@ void init_directed_conformer_generator(pybind11::module& m) {
     &DirectedConformerGenerator::Relabeler::observedDihedrals,
     "Observed dihedrals at each bond in added structures"
   );
+
+  pybind11::class_<DirectedConformerGenerator::StreamingRelabeler> streamingRelabeler(
+    dirConfGen,
+    "StreamingRelabeler",
+    R"delim(
+      Two-pass relabeling of decision lists with bounded memory
+
+      Yields the same bins and labels as :class:`Relabeler`, but instead of
+      storing all observed dihedrals, accumulates them into histograms. In a
+      first pass, add all structures and generate bins. In a second pass,
+      determine the bin indices of each structure individually.
+
+      >>> # Assuming a generator and a function yielding structures
+      >>> relabeler = generator.streaming_relabeler()
+      >>> for positions in structures():
+      ...     relabeler.add(positions)
+      >>> bins = relabeler.bins()
+      >>> for positions in structures():
+      ...     indices = relabeler.bin_indices(positions, bins)
+    )delim"
+  );
+
+  streamingRelabeler.def(
+    "cell_width",
+    &DirectedConformerGenerator::StreamingRelabeler::cellWidth,
+    "Width of histogram cells in radians"
+  );
+
+  streamingRelabeler.def(
+    "add",
+    &DirectedConformerGenerator::StreamingRelabeler::add,
+    pybind11::arg("positions"),
+    "Add a particular position to the histograms"
+  );
+
+  streamingRelabeler.def(
+    "bins",
+    &DirectedConformerGenerator::StreamingRelabeler::bins,
+    pybind11::arg("delta") = M_PI / 6,
+    R"delim(
+      Generate bins for all observed dihedrals
+
+      :param delta: Maximum dihedral distance between dihedral values to
+        include in the same bin in radians. Must be at least the cell width.
+    )delim"
+  );
+
+  streamingRelabeler.def(
+    "bin_indices",
+    &DirectedConformerGenerator::StreamingRelabeler::binIndices,
+    pybind11::arg("positions"),
+    pybind11::arg("bins"),
+    R"delim(
+      Determine bin membership indices of a single structure
+
+      :param positions: Positions of a structure added in the first pass
+      :param bins: Bin intervals for all observed bonds (see bins function)
+    )delim"
+  );
+
+  streamingRelabeler.def(
+    "bin_midpoint_integers",
+    &DirectedConformerGenerator::StreamingRelabeler::binMidpointIntegers,
+    pybind11::arg("bin_indices"),
+    pybind11::arg("bins"),
+    R"delim(
+      Relabel a single structure's bin indices into the rounded dihedral value
+      of their bin midpoint
+
+      :param bin_indices: The structure's bin indices (see bin_indices)
+      :param bins: Bin intervals for all observed bonds (see bins function)
+    )delim"
+  );
+
+  streamingRelabeler.def_readonly(
+    "sequences",
+    &DirectedConformerGenerator::StreamingRelabeler::sequences,
+    "Dominant index sequences at each considered bond"
+  );
 }
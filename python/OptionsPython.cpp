@@ -99,6 +99,70 @@ void init_options(pybind11::module& m) {
     "Global chiral state preservation setting of the library. Defaults to effortless and unique"
   );
 
+  options.def_readwrite_static(
+    "abstract_stereopermutation_cache_capacity",
+    &Options::abstractStereopermutationCacheCapacity,
+    R"delim(
+      Maximum number of entries in the process-wide cache of abstract
+      stereopermutations. These depend only on shape and the ranking
+      characters and links of sites and are memoized across all molecules.
+      Zero disables memoization. Defaults to 1024.
+    )delim"
+  );
+
+  options.def_readwrite_static(
+    "composite_cache_capacity",
+    &Options::compositeCacheCapacity,
+    R"delim(
+      Maximum number of entries in the process-wide cache of bond
+      stereopermutation lists. These depend only on the composed shapes, the
+      ranking characters of their vertices and the alignment and are memoized
+      across all composites. Zero disables memoization. Defaults to 256.
+    )delim"
+  );
+
+  pybind11::class_<CacheStatistics> cacheStatistics(
+    m,
+    "CacheStatistics",
+    "Usage statistics of a process-wide cache"
+  );
+  cacheStatistics.def_readonly(
+    "hits",
+    &CacheStatistics::hits,
+    "Number of lookups answered by a cached entry"
+  );
+  cacheStatistics.def_readonly(
+    "misses",
+    &CacheStatistics::misses,
+    "Number of lookups that required computation"
+  );
+  cacheStatistics.def_readonly(
+    "size",
+    &CacheStatistics::size,
+    "Number of currently cached entries"
+  );
+
+  m.def(
+    "abstract_stereopermutation_cache_statistics",
+    &abstractStereopermutationCacheStatistics,
+    "Usage statistics of the process-wide abstract stereopermutation cache"
+  );
+  m.def(
+    "clear_abstract_stereopermutation_cache",
+    &clearAbstractStereopermutationCache,
+    "Empties the abstract stereopermutation cache and resets its statistics"
+  );
+  m.def(
+    "composite_cache_statistics",
+    &compositeCacheStatistics,
+    "Usage statistics of the process-wide composite stereopermutation cache"
+  );
+  m.def(
+    "clear_composite_cache",
+    &clearCompositeCache,
+    "Empties the composite stereopermutation cache and resets its statistics"
+  );
+
   /* Access to the PRNG instance */
   m.def("randomness_engine", &randomnessEngine);
 }
@@ -6,9 +6,95 @@
 
 #include "Molassembler/Temple/Functional.h"
 #include "Molassembler/DistanceGeometry/ConformerGeneration.h"
+#include "Molassembler/DistanceGeometry/Error.h"
 
 namespace Scine {
 namespace Molassembler {
+namespace {
+
+outcome::result<
+  std::vector<Utils::PositionCollection>
+> budgetedEnsemble(
+  const Molecule& molecule,
+  const DistanceGeometry::EnsembleBudget& budget,
+  const boost::optional<unsigned> seedOption,
+  const DistanceGeometry::Configuration& configuration
+) {
+  // Successes are collected with their attempt index to order them afterwards
+  std::vector<
+    std::pair<unsigned, Utils::PositionCollection>
+  > successes;
+  boost::optional<std::pair<unsigned, std::error_code>> firstFailure;
+
+  DistanceGeometry::run(
+    molecule,
+    budget,
+    configuration,
+    seedOption,
+    [&](const unsigned i, outcome::result<AngstromPositions> positionResult) {
+      if(positionResult) {
+        successes.emplace_back(i, positionResult.value().getBohr());
+      } else if(!firstFailure || i < firstFailure->first) {
+        firstFailure = std::make_pair(i, positionResult.error());
+      }
+    }
+  );
+
+  if(successes.empty()) {
+    if(firstFailure) {
+      return firstFailure->second;
+    }
+
+    return DgError::Cancelled;
+  }
+
+  Temple::sort(successes, [](const auto& a, const auto& b) { return a.first < b.first; });
+  return Temple::map(successes, [](auto&& p) -> Utils::PositionCollection { return std::move(p.second); });
+}
+
+std::vector<
+  std::vector<
+    outcome::result<Utils::PositionCollection>
+  >
+> batchedEnsembles(
+  const std::vector<Molecule>& molecules,
+  const std::vector<unsigned>& numStructures,
+  const boost::optional<unsigned> seedOption,
+  const std::vector<DistanceGeometry::Configuration>& configurations
+) {
+  if(numStructures.size() != molecules.size()) {
+    throw std::invalid_argument("Number of structure counts does not match number of molecules");
+  }
+
+  if(!configurations.empty() && configurations.size() != molecules.size()) {
+    throw std::invalid_argument("Number of configurations does not match number of molecules");
+  }
+
+  auto results = DistanceGeometry::run(
+    molecules,
+    numStructures,
+    configurations.empty()
+      ? std::vector<DistanceGeometry::Configuration>(molecules.size())
+      : configurations,
+    seedOption
+  );
+
+  return Temple::map(results,
+    [](auto&& moleculeResults) {
+      return Temple::map(moleculeResults,
+        [](auto&& positionResult) -> outcome::result<Utils::PositionCollection> {
+          if(positionResult) {
+            return positionResult.value().getBohr();
+          }
+
+          return positionResult.as_failure();
+        }
+      );
+    }
+  );
+}
+
+} // namespace
 
 std::vector<
   outcome::result<Utils::PositionCollection>
@@ -67,6 +153,95 @@ std::vector<
   return converted;
 }
 
+void generateRandomEnsemble(
+  const Molecule& molecule,
+  const unsigned numStructures,
+  const EnsembleCallback& callback,
+  const DistanceGeometry::Configuration& configuration
+) {
+  DistanceGeometry::run(
+    molecule,
+    numStructures,
+    configuration,
+    boost::none,
+    [&callback](const unsigned i, outcome::result<AngstromPositions> positionResult) {
+      if(positionResult) {
+        callback(i, positionResult.value().getBohr());
+      } else {
+        callback(i, positionResult.as_failure());
+      }
+    }
+  );
+}
+
+void generateEnsemble(
+  const Molecule& molecule,
+  const unsigned numStructures,
+  const unsigned seed,
+  const EnsembleCallback& callback,
+  const DistanceGeometry::Configuration& configuration
+) {
+  DistanceGeometry::run(
+    molecule,
+    numStructures,
+    configuration,
+    seed,
+    [&callback](const unsigned i, outcome::result<AngstromPositions> positionResult) {
+      if(positionResult) {
+        callback(i, positionResult.value().getBohr());
+      } else {
+        callback(i, positionResult.as_failure());
+      }
+    }
+  );
+}
+
+std::vector<
+  std::vector<
+    outcome::result<Utils::PositionCollection>
+  >
+> generateRandomEnsembles(
+  const std::vector<Molecule>& molecules,
+  const std::vector<unsigned>& numStructures,
+  const std::vector<DistanceGeometry::Configuration>& configurations
+) {
+  return batchedEnsembles(molecules, numStructures, boost::none, configurations);
+}
+
+std::vector<
+  std::vector<
+    outcome::result<Utils::PositionCollection>
+  >
+> generateEnsembles(
+  const std::vector<Molecule>& molecules,
+  const std::vector<unsigned>& numStructures,
+  const unsigned seed,
+  const std::vector<DistanceGeometry::Configuration>& configurations
+) {
+  return batchedEnsembles(molecules, numStructures, seed, configurations);
+}
+
+outcome::result<
+  std::vector<Utils::PositionCollection>
+> generateRandomEnsemble(
+  const Molecule& molecule,
+  const DistanceGeometry::EnsembleBudget& budget,
+  const DistanceGeometry::Configuration& configuration
+) {
+  return budgetedEnsemble(molecule, budget, boost::none, configuration);
+}
+
+outcome::result<
+  std::vector<Utils::PositionCollection>
+> generateEnsemble(
+  const Molecule& molecule,
+  const DistanceGeometry::EnsembleBudget& budget,
+  const unsigned seed,
+  const DistanceGeometry::Configuration& configuration
+) {
+  return budgetedEnsemble(molecule, budget, seed, configuration);
+}
+
 outcome::result<Utils::PositionCollection> generateRandomConformation(
   const Molecule& molecule,
   const DistanceGeometry::Configuration& configuration
@@ -11,6 +11,7 @@
 #include "Molassembler/Types.h"
 #include "Utils/Typenames.h"
 #include "outcome/outcome.hpp"
+#include <functional>
 #include <vector>
 
 namespace Scine {
@@ -99,6 +100,58 @@ struct MASM_EXPORT Configuration {
    */
   double refinementGradientTarget {1e-5};
 
+  /**
+   * @brief Run the first refinement stages in single precision
+   *
+   * The chiral inversion and fourth dimension compression stages of
+   * refinement only need to reach the right basin. If set, these are carried
+   * out in single precision, halving memory traffic, and only the final stage
+   * including dihedral terms is carried out in double precision.
+   *
+   * Single precision stages may fail slightly more often for large molecules.
+   * Defaults to false.
+   */
+  bool mixedPrecisionRefinement {false};
+
+  /**
+   * @brief Polish stalled refinements with a trust region Newton optimizer
+   *
+   * If progress of the final refinement stage stalls, switches from L-BFGS
+   * to a trust region Newton optimizer using analytic hessian-vector
+   * products. This can reduce the number of refinement iterations and
+   * failures due to the refinement step limit for strained structures.
+   * Defaults to false.
+   */
+  bool trustRegionPolishing {false};
+
+  /**
+   * @brief Refine only the positions of atoms that are not fixed
+   *
+   * By default, all atoms are refined and the result is superimposed onto
+   * any fixed positions afterwards. If set and fixed positions are given,
+   * the embedded structure is instead superimposed onto the fixed positions
+   * beforehand and fixed atoms are placed exactly. Fixed atoms are then
+   * removed from refinement, so that its cost scales with the number of free
+   * atoms, and terms between fixed atoms only are skipped. This is
+   * worthwhile if most atoms are fixed. Defaults to false.
+   */
+  bool fixedAtomElimination {false};
+
+  /**
+   * @brief Embed large molecules in fragments of approximately this size
+   *
+   * Metrization and embedding scale cubically with the number of atoms. If
+   * set and a molecule has more atoms than this, it is split into fragments
+   * along bridge bonds, preferably rotatable ones. Fragments are embedded and
+   * refined independently, then assembled and refined jointly. Fragments of
+   * a single conformer are processed in parallel, those of ensemble members
+   * sequentially since the ensemble is already parallel. Fragments can be larger if a molecule has no suitable bridge
+   * bonds. Ignored if fixed positions are set.
+   *
+   * Defaults to zero, which disables fragment embedding.
+   */
+  unsigned fragmentSize {0};
+
   /**
    * @brief Sets the loosening of the spatial model
    *
@@ -129,6 +182,47 @@ struct MASM_EXPORT Configuration {
   > fixedPositions;
 };
 
+/**
+ * @brief Limits on the effort spent in budgeted ensemble generation
+ *
+ * Budgeted ensemble generation keeps attempting new structures until any of
+ * its limits is reached. Structures still being generated at that point are
+ * cancelled.
+ */
+struct MASM_EXPORT EnsembleBudget {
+  //! @brief Number of successfully generated structures after which to stop
+  unsigned successes {1};
+
+  /**
+   * @brief Wall-clock time limit in seconds
+   *
+   * By default, or if not positive, there is no time limit.
+   */
+  double timeLimit {0.0};
+
+  /**
+   * @brief Maximum number of attempted structures
+   *
+   * By default, or if zero, the number of attempts is not limited.
+   */
+  unsigned maxAttempts {0};
+
+  /**
+   * @brief Failure rate above which further attempts are deemed futile
+   *
+   * Generation stops once the proportion of failed attempts exceeds this
+   * value. Setting this to one disables the check.
+   */
+  double maxFailureRate {0.9};
+
+  /**
+   * @brief Number of finished attempts before the failure rate is considered
+   *
+   * Prevents giving up early due to a few unlucky failures.
+   */
+  unsigned failureRateMinAttempts {20};
+};
+
 } // namespace DistanceGeometry
 
 /*! @brief Generate multiple sets of positional data for a Molecule
@@ -245,6 +339,277 @@ MASM_EXPORT std::vector<
   const DistanceGeometry::Configuration& configuration = DistanceGeometry::Configuration {}
 );
 
+/*! @brief Callback type for structures delivered during ensemble generation
+ *
+ * Called with the index of the structure within the ensemble and its
+ * generation result (positions in Bohr length units).
+ */
+using EnsembleCallback = std::function<
+  void(unsigned, outcome::result<Utils::PositionCollection>)
+>;
+
+/*! @brief Generate multiple sets of positional data for a Molecule, delivering
+ *   each as soon as it is generated
+ *
+ * Streaming variant of generateRandomEnsemble. Instead of collecting all
+ * structures and returning them once the slowest one has finished, each
+ * structure is passed to @p callback as soon as its generation finishes, so
+ * that processing can start immediately and the ensemble need not be held in
+ * memory.
+ *
+ * @param molecule The molecule for which to generate sets of three-dimensional
+ *   positions. This molecule may not contain stereopermutators with zero
+ *   assignments.
+ * @param numStructures The number of desired structures to generate
+ * @param callback Function called exactly once for each structure index with
+ *   the structure's generation result. It is guaranteed that the callback is
+ *   never called simultaneously even in parallel execution. If it throws, no
+ *   further structures are generated and the exception is rethrown from this
+ *   function.
+ * @param configuration The configuration object to control Distance Geometry
+ *   in detail. The defaults are usually fine.
+ *
+ * @pre @p molecule may not contain stereopermutators with zero assignments as
+ *   this means that the molecule is not representable in three dimensions.
+ * @pre @p configuration's preconditions must be met
+ *
+ * @complexity{Roughly @math{O(C \cdot N^3)} where @math{C} is the number of
+ * conformers and @math{N} is the number of atoms in @p molecule}
+ *
+ * @parblock @note This function is parallelized. Use the OMP_NUM_THREADS
+ * environment variable to control the number of threads used. Callback
+ * invocations are unsequenced but the arguments are reproducible.
+ * @endparblock
+ *
+ * @parblock @note This function advances the state of the global PRNG.
+ * @endparblock
+ */
+MASM_EXPORT void generateRandomEnsemble(
+  const Molecule& molecule,
+  unsigned numStructures,
+  const EnsembleCallback& callback,
+  const DistanceGeometry::Configuration& configuration = DistanceGeometry::Configuration {}
+);
+
+/*! @brief Generate multiple sets of positional data for a Molecule, delivering
+ *   each as soon as it is generated
+ *
+ * Streaming variant of generateEnsemble. Each structure index yields the same
+ * result as the same index of generateEnsemble with an identical seed.
+ *
+ * @param molecule The molecule for which to generate sets of three-dimensional
+ *   positions. This molecule may not contain stereopermutators with zero
+ *   assignments.
+ * @param numStructures The number of desired structures to generate
+ * @param seed A number to seed the pseudo-random number generator used in
+ *   conformer generation with
+ * @param callback Function called exactly once for each structure index with
+ *   the structure's generation result. It is guaranteed that the callback is
+ *   never called simultaneously even in parallel execution. If it throws, no
+ *   further structures are generated and the exception is rethrown from this
+ *   function.
+ * @param configuration The configuration object to control Distance Geometry
+ *   in detail. The defaults are usually fine.
+ *
+ * @pre @p molecule may not contain stereopermutators with zero assignments as
+ *   this means that the molecule is not representable in three dimensions.
+ * @pre @p configuration's preconditions must be met
+ *
+ * @complexity{Roughly @math{O(C \cdot N^3)} where @math{C} is the number of
+ * conformers and @math{N} is the number of atoms in @p molecule}
+ *
+ * @parblock @note This function is parallelized. Use the OMP_NUM_THREADS
+ * environment variable to control the number of threads used. Callback
+ * invocations are unsequenced but the arguments are reproducible.
+ * @endparblock
+ *
+ * @code{.cpp}
+ * generateEnsemble(mol, 10000, 42,
+ *   [&](unsigned index, outcome::result<Utils::PositionCollection> conformerResult) {
+ *     if(conformerResult) {
+ *       IO::write(std::to_string(index) + ".xyz", mol, conformerResult.value());
+ *     }
+ *   }
+ * );
+ * @endcode
+ */
+MASM_EXPORT void generateEnsemble(
+  const Molecule& molecule,
+  unsigned numStructures,
+  unsigned seed,
+  const EnsembleCallback& callback,
+  const DistanceGeometry::Configuration& configuration = DistanceGeometry::Configuration {}
+);
+
+/*! @brief Generate multiple sets of positional data for each of several
+ *   Molecules
+ *
+ * Batched variant of generateRandomEnsemble. All structures of all molecules
+ * are generated in a single parallel section, so that many small molecules can
+ * make full use of available threads.
+ *
+ * @param molecules The molecules for which to generate sets of
+ *   three-dimensional positions
+ * @param numStructures The number of desired structures to generate for each
+ *   molecule
+ * @param configurations The configuration objects to control Distance
+ *   Geometry for each molecule. If empty, the default configuration is used
+ *   for all molecules.
+ *
+ * @throws std::invalid_argument If @p numStructures or non-empty
+ *   @p configurations do not match @p molecules in size
+ *
+ * @complexity{Roughly @math{O(\sum_m C_m \cdot N_m^3)} where @math{C_m} is
+ * the number of conformers and @math{N_m} is the number of atoms of the m-th
+ * molecule}
+ *
+ * @parblock @note This function is parallelized. Use the OMP_NUM_THREADS
+ * environment variable to control the number of threads used.
+ * @endparblock
+ *
+ * @parblock @note This function advances the state of the global PRNG.
+ * @endparblock
+ *
+ * @returns A result vector as in generateRandomEnsemble for each molecule
+ */
+MASM_EXPORT std::vector<
+  std::vector<
+    outcome::result<Utils::PositionCollection>
+  >
+> generateRandomEnsembles(
+  const std::vector<Molecule>& molecules,
+  const std::vector<unsigned>& numStructures,
+  const std::vector<DistanceGeometry::Configuration>& configurations = {}
+);
+
+/*! @brief Generate multiple sets of positional data for each of several
+ *   Molecules
+ *
+ * Batched variant of generateEnsemble. All structures of all molecules are
+ * generated in a single parallel section, so that many small molecules can
+ * make full use of available threads.
+ *
+ * @param molecules The molecules for which to generate sets of
+ *   three-dimensional positions
+ * @param numStructures The number of desired structures to generate for each
+ *   molecule
+ * @param seed A number to seed the pseudo-random number generator used in
+ *   conformer generation with
+ * @param configurations The configuration objects to control Distance
+ *   Geometry for each molecule. If empty, the default configuration is used
+ *   for all molecules.
+ *
+ * @throws std::invalid_argument If @p numStructures or non-empty
+ *   @p configurations do not match @p molecules in size
+ *
+ * @complexity{Roughly @math{O(\sum_m C_m \cdot N_m^3)} where @math{C_m} is
+ * the number of conformers and @math{N_m} is the number of atoms of the m-th
+ * molecule}
+ *
+ * @parblock @note This function is parallelized. Use the OMP_NUM_THREADS
+ * environment variable to control the number of threads used. Each
+ * molecule's results are reproducible and independent of the other molecules.
+ * @endparblock
+ *
+ * @returns A result vector as in generateEnsemble for each molecule
+ */
+MASM_EXPORT std::vector<
+  std::vector<
+    outcome::result<Utils::PositionCollection>
+  >
+> generateEnsembles(
+  const std::vector<Molecule>& molecules,
+  const std::vector<unsigned>& numStructures,
+  unsigned seed,
+  const std::vector<DistanceGeometry::Configuration>& configurations = {}
+);
+
+/*! @brief Generate sets of positional data for a Molecule within a budget
+ *
+ * Keeps attempting new structures until the desired number of structures is
+ * successfully generated or any other limit of the budget is reached, e.g.
+ * a time limit or a failure rate indicating that further attempts are futile.
+ * Unlike generateRandomEnsemble, failures are not returned alongside
+ * successes.
+ *
+ * @param molecule The molecule for which to generate sets of three-dimensional
+ *   positions. This molecule may not contain stereopermutators with zero
+ *   assignments.
+ * @param budget Limits on the effort spent in ensemble generation
+ * @param configuration The configuration object to control Distance Geometry
+ *   in detail. The defaults are usually fine.
+ *
+ * @pre @p molecule may not contain stereopermutators with zero assignments as
+ *   this means that the molecule is not representable in three dimensions.
+ * @pre @p configuration's preconditions must be met
+ *
+ * @complexity{Roughly @math{O(C \cdot N^3)} where @math{C} is the number of
+ * attempted conformers and @math{N} is the number of atoms in @p molecule}
+ *
+ * @parblock @note This function is parallelized. Use the OMP_NUM_THREADS
+ * environment variable to control the number of threads used. Which
+ * structures are successfully generated before the budget is exhausted
+ * depends on the timing of their generation, but each structure is
+ * reproducible.
+ * @endparblock
+ *
+ * @parblock @note This function advances the state of the global PRNG.
+ * @endparblock
+ *
+ * @returns Up to EnsembleBudget::successes structures, or, if no structure
+ *   was successfully generated, the error of the first failed attempt.
+ */
+MASM_EXPORT outcome::result<
+  std::vector<Utils::PositionCollection>
+> generateRandomEnsemble(
+  const Molecule& molecule,
+  const DistanceGeometry::EnsembleBudget& budget,
+  const DistanceGeometry::Configuration& configuration = DistanceGeometry::Configuration {}
+);
+
+/*! @brief Generate sets of positional data for a Molecule within a budget
+ *
+ * Keeps attempting new structures until the desired number of structures is
+ * successfully generated or any other limit of the budget is reached, e.g.
+ * a time limit or a failure rate indicating that further attempts are futile.
+ * Unlike generateEnsemble, failures are not returned alongside successes.
+ *
+ * @param molecule The molecule for which to generate sets of three-dimensional
+ *   positions. This molecule may not contain stereopermutators with zero
+ *   assignments.
+ * @param budget Limits on the effort spent in ensemble generation
+ * @param seed A number to seed the pseudo-random number generator used in
+ *   conformer generation with
+ * @param configuration The configuration object to control Distance Geometry
+ *   in detail. The defaults are usually fine.
+ *
+ * @pre @p molecule may not contain stereopermutators with zero assignments as
+ *   this means that the molecule is not representable in three dimensions.
+ * @pre @p configuration's preconditions must be met
+ *
+ * @complexity{Roughly @math{O(C \cdot N^3)} where @math{C} is the number of
+ * attempted conformers and @math{N} is the number of atoms in @p molecule}
+ *
+ * @parblock @note This function is parallelized. Use the OMP_NUM_THREADS
+ * environment variable to control the number of threads used. Which
+ * structures are successfully generated before the budget is exhausted
+ * depends on the timing of their generation, but each structure is
+ * reproducible: The i-th attempt yields the same result as the i-th structure
+ * of generateEnsemble with the same seed.
+ * @endparblock
+ *
+ * @returns Up to EnsembleBudget::successes structures, or, if no structure
+ *   was successfully generated, the error of the first failed attempt.
+ */
+MASM_EXPORT outcome::result<
+  std::vector<Utils::PositionCollection>
+> generateEnsemble(
+  const Molecule& molecule,
+  const DistanceGeometry::EnsembleBudget& budget,
+  unsigned seed,
+  const DistanceGeometry::Configuration& configuration = DistanceGeometry::Configuration {}
+);
+
 /*! @brief Generate a 3D structure of a Molecule
  *
  * @param molecule The molecule for which to generate three-dimensional
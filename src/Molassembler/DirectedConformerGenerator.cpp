@@ -19,6 +19,99 @@
 namespace Scine {
 namespace Molassembler {
 
+namespace {
+
+using DihedralInfo = DirectedConformerGenerator::Relabeler::DihedralInfo;
+using Interval = DirectedConformerGenerator::Relabeler::Interval;
+using Intervals = DirectedConformerGenerator::Relabeler::Intervals;
+
+//! Determine the dominant dihedral sequences at each bond
+std::vector<DihedralInfo> dominantDihedralSequences(
+  const DirectedConformerGenerator::BondList& bonds,
+  const Molecule& mol
+) {
+  return Temple::map(
+    bonds,
+    [&](const BondIndex& bond) -> DihedralInfo {
+      const auto& stereopermutator = mol.stereopermutators().at(bond);
+      const auto& composite = stereopermutator.composite();
+
+      const AtomIndex leftPlacement = composite.orientations().first.identifier;
+      const AtomIndex rightPlacement = composite.orientations().second.identifier;
+
+      const auto& left = mol.stereopermutators().at(leftPlacement);
+      const auto& right = mol.stereopermutators().at(rightPlacement);
+
+      const auto& dominantDihedralTuple = composite.allPermutations().at(0).dihedrals.front();
+      const SiteIndex leftSite = left.getShapePositionMap().indexOf(std::get<0>(dominantDihedralTuple));
+      const SiteIndex rightSite = right.getShapePositionMap().indexOf(std::get<1>(dominantDihedralTuple));
+
+      return DihedralInfo {
+        left.getRanking().sites.at(leftSite),
+        leftPlacement,
+        rightPlacement,
+        right.getRanking().sites.at(rightSite),
+        composite.rotationalAxisSymmetryOrder()
+      };
+    }
+  );
+}
+
+//! Dihedral of a sequence, reduced by rotational symmetry if present
+double observedDihedral(
+  const Utils::PositionCollection& positions,
+  const DihedralInfo& sequence
+) {
+  double dihedral = Cartesian::dihedral(
+    Cartesian::averagePosition(positions, sequence.is),
+    positions.row(sequence.j),
+    positions.row(sequence.k),
+    Cartesian::averagePosition(positions, sequence.ls)
+  );
+
+  if(sequence.symmetryOrder > 1) {
+    dihedral = Cartesian::signedDihedralAngle(
+      std::fmod(
+        Cartesian::positiveDihedralAngle(dihedral),
+        2 * M_PI / sequence.symmetryOrder
+      )
+    );
+  }
+
+  return dihedral;
+}
+
+//! Index of the bin containing a dihedral, equal to the bin count if none do
+unsigned binIndex(const Intervals& bins, const double dihedral) {
+  const auto findIter = Temple::find_if(
+    bins,
+    [&](const Interval& interval) -> bool {
+      if(interval.first <= interval.second) {
+        return interval.first <= dihedral && dihedral <= interval.second;
+      }
+
+      return interval.first <= dihedral || dihedral <= interval.second;
+    }
+  );
+
+  return findIter - std::begin(bins);
+}
+
+//! Rounded dihedral value of a bin midpoint in degrees
+int intervalMidpoint(const Interval& interval, const unsigned symmetryOrder) {
+  if(interval.first <= interval.second) {
+    return std::round(180 * (interval.first + interval.second) / (2 * M_PI));
+  }
+
+  double boundary = 2 * M_PI / symmetryOrder;
+  double average = Cartesian::signedDihedralAngle(
+    (interval.first + interval.second + boundary) / 2
+  );
+  return std::round(180 * average / M_PI);
+}
+
+} // namespace
+
 constexpr std::uint8_t DirectedConformerGenerator::unknownDecision;
 
 /* Static functions */
@@ -115,6 +208,13 @@ DirectedConformerGenerator::DecisionList DirectedConformerGenerator::getDecision
   return pImpl_->getDecisionList(positions, mode);
 }
 
+DirectedConformerGenerator::DecisionMatrix DirectedConformerGenerator::getDecisionLists(
+  const Utils::PositionCollection& frames,
+  const BondStereopermutator::FittingMode mode
+) const {
+  return pImpl_->getDecisionLists(frames, mode);
+}
+
 void DirectedConformerGenerator::enumerate(
   std::function<void(const DecisionList&, Utils::PositionCollection)> callback,
   unsigned seed,
@@ -131,10 +231,27 @@ void DirectedConformerGenerator::enumerateRandom(
   return pImpl_->enumerate(std::move(callback), engine(), settings);
 }
 
+DirectedConformerGenerator::Checkpoint DirectedConformerGenerator::checkpoint() const {
+  return pImpl_->checkpoint();
+}
+
+void DirectedConformerGenerator::resumeEnumeration(
+  const Checkpoint& checkpoint,
+  std::function<void(const DecisionList&, Utils::PositionCollection)> callback,
+  const EnumerationSettings& settings
+) {
+  return pImpl_->resumeEnumeration(checkpoint, std::move(callback), settings);
+}
+
 DirectedConformerGenerator::Relabeler DirectedConformerGenerator::relabeler() const {
   return pImpl_->relabeler();
 }
 
+DirectedConformerGenerator::StreamingRelabeler
+DirectedConformerGenerator::streamingRelabeler(const unsigned resolution) const {
+  return pImpl_->streamingRelabeler(resolution);
+}
+
 std::vector<int>
 DirectedConformerGenerator::binMidpointIntegers(
   const DecisionList& decisions
@@ -145,66 +262,16 @@ DirectedConformerGenerator::binMidpointIntegers(
 DirectedConformerGenerator::Relabeler::Relabeler(
   const DirectedConformerGenerator::BondList& bonds,
   const Molecule& mol
-) {
-  // Determine the dominant dihedral sequences at each bond
-  for(const BondIndex& bond : bonds) {
-    const auto& stereopermutator = mol.stereopermutators().at(bond);
-    const auto& composite = stereopermutator.composite();
-
-    const AtomIndex leftPlacement = composite.orientations().first.identifier;
-    const AtomIndex rightPlacement = composite.orientations().second.identifier;
-
-    const auto& left = mol.stereopermutators().at(leftPlacement);
-    const auto& right = mol.stereopermutators().at(rightPlacement);
-
-    const auto& dominantDihedralTuple = composite.allPermutations().at(0).dihedrals.front();
-    const SiteIndex leftSite = left.getShapePositionMap().indexOf(std::get<0>(dominantDihedralTuple));
-    const SiteIndex rightSite = right.getShapePositionMap().indexOf(std::get<1>(dominantDihedralTuple));
-
-    sequences.push_back(
-      DihedralInfo {
-        left.getRanking().sites.at(leftSite),
-        leftPlacement,
-        rightPlacement,
-        right.getRanking().sites.at(rightSite),
-        composite.rotationalAxisSymmetryOrder()
-      }
-    );
-  }
-
+) : sequences(dominantDihedralSequences(bonds, mol)) {
   observedDihedrals.resize(sequences.size());
 }
 
 void DirectedConformerGenerator::Relabeler::add(
   const Utils::PositionCollection& positions
 ) {
-  auto sequenceIter = std::cbegin(sequences);
-  const auto bondEnd = std::cend(sequences);
-  auto dihedralIter = std::begin(observedDihedrals);
-  const auto dihedralEnd = std::end(observedDihedrals);
-
-  while(sequenceIter != bondEnd && dihedralIter != dihedralEnd) {
-    double dihedral = Cartesian::dihedral(
-      Cartesian::averagePosition(positions, sequenceIter->is),
-      positions.row(sequenceIter->j),
-      positions.row(sequenceIter->k),
-      Cartesian::averagePosition(positions, sequenceIter->ls)
-    );
-
-    // Reduce by rotational symmetry if present
-    if(sequenceIter->symmetryOrder > 1) {
-      dihedral = Cartesian::signedDihedralAngle(
-        std::fmod(
-          Cartesian::positiveDihedralAngle(dihedral),
-          2 * M_PI / sequenceIter->symmetryOrder
-        )
-      );
-    }
-
-    dihedralIter->push_back(dihedral);
-
-    ++sequenceIter;
-    ++dihedralIter;
+  const unsigned bondCount = sequences.size();
+  for(unsigned bond = 0; bond < bondCount; ++bond) {
+    observedDihedrals.at(bond).push_back(observedDihedral(positions, sequences.at(bond)));
   }
 }
 
@@ -288,22 +355,9 @@ DirectedConformerGenerator::Relabeler::binIndices(
   for(unsigned structure = 0; structure < structureCount; ++structure) {
     for(unsigned bond = 0; bond < bondCount; ++bond) {
       const auto& bins = allBins.at(bond);
-      double observedDihedral = observedDihedrals.at(bond).at(structure);
-
-      const auto findIter = Temple::find_if(
-        bins,
-        [&](const Interval& interval) -> bool {
-          if(interval.first <= interval.second) {
-            return interval.first <= observedDihedral && observedDihedral <= interval.second;
-          }
-
-          return interval.first <= observedDihedral || observedDihedral <= interval.second;
-        }
-      );
-
-      assert(findIter != std::end(bins));
-
-      relabeling.at(structure).at(bond) = findIter - std::begin(bins);
+      const unsigned index = binIndex(bins, observedDihedrals.at(bond).at(structure));
+      assert(index < bins.size());
+      relabeling.at(structure).at(bond) = index;
     }
   }
 
@@ -316,21 +370,6 @@ DirectedConformerGenerator::Relabeler::binMidpointIntegers(
   const std::vector<std::vector<unsigned>>& binIndices,
   const std::vector<Intervals>& allBins
 ) const {
-  const auto intervalMidpoint = [](
-    const Interval& interval,
-    unsigned symmetryOrder
-  ) -> int {
-    if(interval.first <= interval.second) {
-      return std::round(180 * (interval.first + interval.second) / (2 * M_PI));
-    }
-
-    double boundary = 2 * M_PI / symmetryOrder;
-    double average = Cartesian::signedDihedralAngle(
-      (interval.first + interval.second + boundary) / 2
-    );
-    return std::round(180 * average / M_PI);
-  };
-
   const auto binMidpointIntegers = Temple::map(
     Temple::Adaptors::zip(allBins, sequences),
     [&](const auto& intervals, const DihedralInfo& sequence) {
@@ -360,5 +399,116 @@ DirectedConformerGenerator::Relabeler::binMidpointIntegers(
   return relabeling;
 }
 
+DirectedConformerGenerator::StreamingRelabeler::StreamingRelabeler(
+  const DirectedConformerGenerator::BondList& bonds,
+  const Molecule& mol,
+  const unsigned cells
+) : sequences(dominantDihedralSequences(bonds, mol)),
+    resolution(cells)
+{
+  if(resolution == 0) {
+    throw std::invalid_argument("Histogram resolution must be positive");
+  }
+
+  histograms.resize(
+    sequences.size(),
+    Histogram {
+      std::vector<unsigned>(resolution, 0),
+      std::vector<double>(resolution, 0.0),
+      std::vector<double>(resolution, 0.0)
+    }
+  );
+}
+
+double DirectedConformerGenerator::StreamingRelabeler::cellWidth() const {
+  return 2 * M_PI / resolution;
+}
+
+void DirectedConformerGenerator::StreamingRelabeler::add(
+  const Utils::PositionCollection& positions
+) {
+  const unsigned bondCount = sequences.size();
+  for(unsigned bond = 0; bond < bondCount; ++bond) {
+    const double dihedral = observedDihedral(positions, sequences.at(bond));
+    Histogram& histogram = histograms.at(bond);
+    const unsigned cell = std::min(
+      static_cast<unsigned>(std::max(0.0, (dihedral + M_PI) / (2 * M_PI) * resolution)),
+      resolution - 1
+    );
+
+    unsigned& count = histogram.counts.at(cell);
+    if(count == 0) {
+      histogram.minima.at(cell) = dihedral;
+      histogram.maxima.at(cell) = dihedral;
+    } else {
+      histogram.minima.at(cell) = std::min(histogram.minima.at(cell), dihedral);
+      histogram.maxima.at(cell) = std::max(histogram.maxima.at(cell), dihedral);
+    }
+    ++count;
+  }
+}
+
+std::vector<DirectedConformerGenerator::StreamingRelabeler::Intervals>
+DirectedConformerGenerator::StreamingRelabeler::bins(const double delta) const {
+  if(delta < cellWidth()) {
+    throw std::invalid_argument("Bin delta is smaller than the histogram cell width");
+  }
+
+  return Temple::map(
+    Temple::Adaptors::zip(histograms, sequences),
+    [&](const Histogram& histogram, const DihedralInfo& sequence) -> Intervals {
+      /* Interior values of a cell cannot close a bin since they are at most a
+       * cell width (and hence delta) apart from their neighbors. The sorted
+       * sequence of cell extrema yields the same bins as all values.
+       */
+      std::vector<double> extrema;
+      for(unsigned cell = 0; cell < resolution; ++cell) {
+        const unsigned count = histogram.counts.at(cell);
+        if(count > 0) {
+          extrema.push_back(histogram.minima.at(cell));
+        }
+        if(count > 1) {
+          extrema.push_back(histogram.maxima.at(cell));
+        }
+      }
+
+      return Relabeler::densityBins(extrema, delta, sequence.symmetryOrder);
+    }
+  );
+}
+
+std::vector<unsigned>
+DirectedConformerGenerator::StreamingRelabeler::binIndices(
+  const Utils::PositionCollection& positions,
+  const std::vector<Intervals>& allBins
+) const {
+  return Temple::map(
+    Temple::Adaptors::zip(sequences, allBins),
+    [&](const DihedralInfo& sequence, const Intervals& bins) -> unsigned {
+      const unsigned index = binIndex(bins, observedDihedral(positions, sequence));
+      if(index == bins.size()) {
+        throw std::out_of_range("Observed dihedral is not within any bin");
+      }
+      return index;
+    }
+  );
+}
+
+std::vector<int>
+DirectedConformerGenerator::StreamingRelabeler::binMidpointIntegers(
+  const std::vector<unsigned>& binIndices,
+  const std::vector<Intervals>& allBins
+) const {
+  const unsigned bondCount = sequences.size();
+  std::vector<int> relabeling(bondCount);
+  for(unsigned bond = 0; bond < bondCount; ++bond) {
+    relabeling.at(bond) = intervalMidpoint(
+      allBins.at(bond).at(binIndices.at(bond)),
+      sequences.at(bond).symmetryOrder
+    );
+  }
+  return relabeling;
+}
+
 } // namespace Molassembler
 } // namespace Scine
@@ -100,6 +100,8 @@ public:
    *   but still better than each position having its own character.
    */
   using DecisionList = std::vector<std::uint8_t>;
+  //! Row-major matrix of decision lists, one row per frame
+  using DecisionMatrix = Eigen::Matrix<std::uint8_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
 
   //! Value set in decision lists if no decision could be recovered
   constexpr static std::uint8_t unknownDecision = std::numeric_limits<std::uint8_t>::max();
@@ -161,6 +163,7 @@ public:
   };
 
   struct Relabeler;
+  struct StreamingRelabeler;
 //!@}
 
 //!@name Static functions
@@ -365,6 +368,13 @@ public:
    *
    * @see Scine::Molassembler::generateConformation()
    *
+   * @note The spatial model apart from the dihedral constraints of the
+   * considered bonds is built and smoothed only once per loosening multiplier
+   * and shared by all decision lists. The considered bonds' dihedrals are then
+   * enforced in refinement only, not through distance bounds. This does not
+   * apply if fixed positions are set or stereopermutators other than those on
+   * the considered bonds are unassigned. Same for generateRandomConformation.
+   *
    * @throws std::invalid_argument If the passed decisionList does not match
    *   the length of the result of bondList().
    */
@@ -427,6 +437,38 @@ public:
     BondStereopermutator::FittingMode mode = BondStereopermutator::FittingMode::Thresholded
   ) const;
 
+  /*! @brief Infer decision lists for relevant bonds of many frames at once
+   *
+   * Equivalent to getDecisionList for each frame, except that only the atom
+   * stereopermutators constituting relevant bonds are refit and checked.
+   * Copies of the stereopermutators involved are made once per thread and
+   * reused across frames.
+   *
+   * @param frames Positions of all frames in bohr, stacked vertically. Rows
+   *   @math{fN} through @math{(f + 1)N - 1} are the positions of frame
+   *   @math{f}.
+   * @param mode Bond stereopermutator fitting mode
+   *
+   * @complexity{@math{\Theta(FB)} bond stereopermutator fits for @math{F}
+   * frames and @math{B} relevant bonds}
+   *
+   * @throws std::invalid_argument If the number of rows of @p frames is not a
+   *   multiple of the number of atoms
+   * @throws std::logic_error If any refit atom stereopermutator's shape or
+   *   assignment differs from the underlying molecule's in any frame
+   *
+   * @returns A matrix whose rows are the decision lists of each frame
+   *
+   * @parblock @note This function is parallelized over frames. Use the
+   * OMP_NUM_THREADS environment variable to control the number of threads
+   * used.
+   * @endparblock
+   */
+  DecisionMatrix getDecisionLists(
+    const Utils::PositionCollection& frames,
+    BondStereopermutator::FittingMode mode = BondStereopermutator::FittingMode::Thresholded
+  ) const;
+
   //! @brief Settings for enumeration
   struct EnumerationSettings {
     EnumerationSettings() : configuration() {}
@@ -456,6 +498,12 @@ public:
    * environment variable to control the number of threads used. Callback
    * invocations are unsequenced but the arguments are reproducible.
    * @endparblock
+   *
+   * @parblock @note Decision lists are drawn from shards of the decision list
+   * space split by their leading decisions, each of which is worked on by a
+   * single thread. Results are passed to the callback through a lock-free
+   * queue, so threads do not wait on each other.
+   * @endparblock
    */
   void enumerate(
     std::function<void(const DecisionList&, Utils::PositionCollection)> callback,
@@ -489,9 +537,59 @@ public:
     const EnumerationSettings& settings = {}
   );
 
+  //! Binary representation of enumeration progress
+  using Checkpoint = std::vector<std::uint8_t>;
+
+  /*! @brief Serializes enumeration progress
+   *
+   * Stores the considered bonds, the seed of the last enumeration and the set
+   * of finished decision lists as CBOR. Finished are those passed to the
+   * enumeration callback and those for which conformer generation failed. The
+   * set is stored as the structure of its prefix trie, in which fully
+   * enumerated subtrees take up only two bits.
+   *
+   * @complexity{Linear in the number of nodes of the decision list trie}
+   *
+   * @note Safe to call from within the enumeration callback, which is never
+   * called concurrently. The decision list passed to the callback is then
+   * already contained.
+   */
+  Checkpoint checkpoint() const;
+
+  /*! @brief Continues an enumeration from a checkpoint
+   *
+   * Enumerates conformers of all decision lists not finished in @p checkpoint.
+   * With the same settings as the checkpointed enumeration, the conformers
+   * yielded are identical to those of an uninterrupted enumeration. The
+   * generator need not be the one the checkpoint was made with, but it must
+   * have been constructed from the same molecule and consider the same bonds.
+   *
+   * @param checkpoint Result of checkpoint()
+   * @param callback Function called with decision list and conformer
+   *   positions for each successfully generated pair. It is guaranteed that
+   *   the callback function is never called simultaneously even in parallel
+   *   execution.
+   * @param settings Further parameters for enumeration algorithms
+   *
+   * @throws std::invalid_argument If the checkpoint is malformed or its
+   *   considered bonds do not match bondList()
+   */
+  void resumeEnumeration(
+    const Checkpoint& checkpoint,
+    std::function<void(const DecisionList&, Utils::PositionCollection)> callback,
+    const EnumerationSettings& settings = {}
+  );
+
   //! Generates a relabeler for the molecule and considered bonds
   Relabeler relabeler() const;
 
+  /*! @brief Generates a streaming relabeler for the molecule and considered
+   *   bonds
+   *
+   * @param resolution Number of histogram cells over the dihedral range
+   */
+  StreamingRelabeler streamingRelabeler(unsigned resolution = 720) const;
+
   //! Relabels a DecisionList into bin midpoint integers
   std::vector<int> binMidpointIntegers(const DecisionList& decision) const;
 //!@}
@@ -584,6 +682,104 @@ struct DirectedConformerGenerator::Relabeler {
 //!@}
 };
 
+/*! @brief Two-pass relabeler with memory independent of the number of
+ *   structures
+ *
+ * Unlike Relabeler, observed dihedrals are not stored. Instead, each bond's
+ * dihedrals are accumulated into a histogram whose cells store the number of
+ * observations and their extrema. Since values within a cell can never be
+ * further apart than the cell width, this suffices to reproduce the
+ * density-based bins of Relabeler exactly for any bin delta at least as large
+ * as the cell width.
+ *
+ * Usage is in two passes over the structures:
+ * - First pass: add() each structure, then generate bins()
+ * - Second pass: Determine binIndices() for each structure individually and
+ *   pass them on to wherever they need to go
+ */
+struct DirectedConformerGenerator::StreamingRelabeler {
+//!@name Types
+//!@{
+  using DihedralInfo = Relabeler::DihedralInfo;
+  using Interval = Relabeler::Interval;
+  using Intervals = Relabeler::Intervals;
+
+  //! Histogram of a bond's observed dihedrals over @math{[-\pi, \pi]}
+  struct Histogram {
+    //! Number of observations in each cell
+    std::vector<unsigned> counts;
+    //! Smallest observed dihedral in each cell, undefined if count is zero
+    std::vector<double> minima;
+    //! Largest observed dihedral in each cell, undefined if count is zero
+    std::vector<double> maxima;
+  };
+//!@}
+
+  /*! @brief Construct a streaming relabeler with a custom list of bonds
+   *
+   * @param bonds List of bonds to consider.
+   * @param mol Molecule whose bonds we want to consider. Needs to have
+   * BondStereopermutators instantiated on bonds in @p bonds.
+   * @param resolution Number of histogram cells over the dihedral range
+   *
+   * @throws std::invalid_argument If @p resolution is zero
+   */
+  StreamingRelabeler(
+    const DirectedConformerGenerator::BondList& bonds,
+    const Molecule& mol,
+    unsigned resolution = 720
+  );
+
+  //! Width of histogram cells in radians
+  double cellWidth() const;
+
+  /*! @brief Add a particular position to the histograms (first pass)
+   *
+   * @complexity{@math{\Theta(B)} for @math{B} bonds}
+   */
+  void add(const Utils::PositionCollection& positions);
+
+  /*! @brief Generate bins for each bond from the histograms
+   *
+   * Yields the same bins as Relabeler::bins for the same added structures.
+   *
+   * @complexity{@math{\Theta(BR)} for @math{B} bonds and histogram
+   * resolution @math{R}}
+   *
+   * @throws std::invalid_argument If @p delta is smaller than the cell width
+   * @throws std::logic_error If no structures have been added
+   */
+  std::vector<Intervals> bins(double delta=M_PI / 6) const;
+
+  /*! @brief Determine bin membership of a single structure (second pass)
+   *
+   * Yields the same bin indices as Relabeler::binIndices does for this
+   * structure.
+   *
+   * @complexity{@math{\Theta(B)} for @math{B} bonds}
+   *
+   * @throws std::out_of_range If a dihedral is not within any bin. This can
+   * only happen if the structure was not added in the first pass.
+   */
+  std::vector<unsigned> binIndices(
+    const Utils::PositionCollection& positions,
+    const std::vector<Intervals>& allBins
+  ) const;
+
+  //! Relabel bin indices of a single structure with bin midpoint integers
+  std::vector<int> binMidpointIntegers(
+    const std::vector<unsigned>& binIndices,
+    const std::vector<Intervals>& allBins
+  ) const;
+
+//!@name State
+//!@{
+  std::vector<DihedralInfo> sequences;
+  unsigned resolution;
+  std::vector<Histogram> histograms;
+//!@}
+};
+
 } // namespace Molassembler
 } // namespace Scine
 
@@ -14,6 +14,8 @@
 #include "Molassembler/DistanceGeometry/EigenRefinement.h"
 #include "Molassembler/DistanceGeometry/Error.h"
 #include "Molassembler/DistanceGeometry/ExplicitBoundsGraph.h"
+#include "Molassembler/DistanceGeometry/FixedAtomsRefinement.h"
+#include "Molassembler/DistanceGeometry/FragmentEmbedding.h"
 #include "Molassembler/DistanceGeometry/MetricMatrix.h"
 #include "Molassembler/DistanceGeometry/RefinementMeta.h"
 #include "Molassembler/Graph/GraphAlgorithms.h"
@@ -21,11 +23,15 @@
 
 #include "Molassembler/Detail/Cartesian.h"
 #include "Molassembler/Temple/Optimization/Lbfgs.h"
+#include "Molassembler/Temple/Optimization/TrustRegion.h"
 #include "Molassembler/Temple/Optionals.h"
 #include "Molassembler/Temple/Functional.h"
 #include "Molassembler/Temple/Random.h"
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <numeric>
 
 namespace Scine {
 namespace Molassembler {
@@ -137,6 +143,10 @@ Molecule narrow(Molecule molecule, Random::Engine& engine) {
   return molecule;
 }
 
+inline bool cancelled(const Cancellation* cancellationPtr) {
+  return cancellationPtr != nullptr && cancellationPtr->requested();
+}
+
 template<typename EigenRefinementType>
 struct InversionOrIterLimitStop {
   using VectorType = typename EigenRefinementType::VectorType;
@@ -144,9 +154,11 @@ struct InversionOrIterLimitStop {
 
   InversionOrIterLimitStop(
     const unsigned passIter,
-    const EigenRefinementType& functor
+    const EigenRefinementType& functor,
+    const Cancellation* cancellation = nullptr
   ) : iterLimit(passIter),
-      refinementFunctorReference(functor)
+      refinementFunctorReference(functor),
+      cancellationPtr(cancellation)
   {}
 
   template<typename StepValues>
@@ -155,11 +167,13 @@ struct InversionOrIterLimitStop {
       iteration < iterLimit
       && refinementFunctorReference.proportionChiralConstraintsCorrectSign < 1.0
       && (step.parameters.proposed - step.parameters.current).norm() > minParameterDiffNorm
+      && !cancelled(cancellationPtr)
     );
   }
 
   const unsigned iterLimit;
   const EigenRefinementType& refinementFunctorReference;
+  const Cancellation* cancellationPtr;
   double minParameterDiffNorm = 1e-3;
 };
 
@@ -169,16 +183,56 @@ struct GradientOrIterLimitStop {
 
   template<typename StepValues>
   bool shouldContinue(unsigned iteration, const StepValues& step) {
+    const double gradientNorm = step.gradients.current.template cast<double>().norm();
+
+    /* Progress has stalled if the gradient norm has not improved on its best
+     * value by a tenth within the last stallIterations iterations
+     */
+    if(stallIterations > 0) {
+      if(gradientNorm < 0.9 * bestGradientNorm) {
+        bestGradientNorm = gradientNorm;
+        bestGradientIteration = iteration;
+      } else if(iteration - bestGradientIteration >= stallIterations) {
+        stalled = true;
+        return false;
+      }
+    }
+
     return (
       iteration < iterLimit
-      && step.gradients.current.template cast<double>().norm() > gradNorm
+      && gradientNorm > gradNorm
       && (step.parameters.proposed - step.parameters.current).norm() > minParameterDiffNorm
+      && !cancelled(cancellationPtr)
     );
   }
 
   unsigned iterLimit = 10000;
   double gradNorm = 1e-5;
   double minParameterDiffNorm = 1e-3;
+  const Cancellation* cancellationPtr = nullptr;
+
+  //! Stop if there is no progress for this many iterations. Zero disables.
+  unsigned stallIterations = 0;
+  //! Set if stopped due to a lack of progress
+  bool stalled = false;
+  double bestGradientNorm = std::numeric_limits<double>::max();
+  unsigned bestGradientIteration = 0;
+};
+
+//! Trust region optimizer checker for the final refinement stage
+struct TrustRegionGradientOrIterLimitStop {
+  template<typename FloatType, typename VectorType>
+  bool shouldContinue(unsigned iteration, const FloatType /* value */, const VectorType& gradient) {
+    return (
+      iteration < iterLimit
+      && gradient.template cast<double>().norm() > gradNorm
+      && !cancelled(cancellationPtr)
+    );
+  }
+
+  unsigned iterLimit = 10000;
+  double gradNorm = 1e-5;
+  const Cancellation* cancellationPtr = nullptr;
 };
 
 template<unsigned dimensionality>
@@ -250,99 +304,24 @@ void twistRotatableDihedrals(
   }
 }
 
-} // namespace Detail
-
-MoleculeDGInformation::GroupMapType MoleculeDGInformation::make(
-  const std::vector<DihedralConstraint>& constraints,
-  const Molecule& molecule
-) {
-  MoleculeDGInformation::GroupMapType groups;
-
-  Temple::forEach(constraints,
-    [&](const DihedralConstraint& constraint) {
-      // It is guaranteed that the sites in the middle have one index only
-      BondIndex bond {
-        constraint.sites.at(1).front(),
-        constraint.sites.at(2).front(),
-      };
-
-      // Populate with group to rotate information on the smaller side
-      if(molecule.graph().cycles().numCycleFamilies(bond) == 0) {
-        auto sides = molecule.graph().splitAlongBridge(bond);
-        if(sides.first.size() < sides.second.size()) {
-          groups.emplace(
-            bond,
-            MoleculeDGInformation::RotatableGroup {bond.first, sides.first}
-          );
-        } else {
-          groups.emplace(
-            bond,
-            MoleculeDGInformation::RotatableGroup {bond.second, sides.second}
-          );
-        }
-      }
-    }
-  );
-
-  return groups;
-}
-
-
-MoleculeDGInformation gatherDGInformation(
-  const Molecule& molecule,
-  const Configuration& configuration
-) {
-  // Generate a spatial model from the molecular graph and stereopermutators
-  SpatialModel spatialModel {molecule, configuration};
-
-  // Extract gathered data
-  MoleculeDGInformation data;
-  data.bounds = spatialModel.makePairwiseBounds();
-  data.chiralConstraints = spatialModel.getChiralConstraints();
-  data.dihedralConstraints = spatialModel.getDihedralConstraints();
-  data.rotatableGroups = MoleculeDGInformation::make(data.dihedralConstraints, molecule);
-
-  return data;
-}
-
-outcome::result<AngstromPositions> refine(
-  Eigen::MatrixXd embeddedPositions,
-  const DistanceBoundsMatrix& distanceBounds,
+/*! @brief Chiral inversion and fourth dimension compression refinement stages
+ *
+ * @param invertible Whether the structure may be inverted if most chiral
+ *   constraints are incorrect. Not the case if some atoms are fixed.
+ *
+ * @returns The number of iterations spent in both stages
+ */
+template<typename RefinementType>
+outcome::result<unsigned> initialRefinementStages(
+  typename RefinementType::VectorType& positions,
+  RefinementType& refinementFunctor,
   const Configuration& configuration,
-  const std::shared_ptr<MoleculeDGInformation>& DgDataPtr
+  const Cancellation* const cancellationPtr,
+  const bool invertible
 ) {
-  /* Refinement problem compile-time settings
-   * - Dimensionality four is needed to ensure chiral constraints invert
-   *   nicely
-   * - FloatType double is helpful for refinement stability, and float
-   *   doesn't affect speed
-   * - Using the alternative SIMD implementations of the refinement problems
-   *   hardly affects speed at all, in fact, it commonly worsens it.
-   */
-  constexpr unsigned dimensionality = 4;
-  using FloatType = double;
-  constexpr bool SIMD = false;
-
-  using FullRefinementType = EigenRefinementProblem<dimensionality, FloatType, SIMD>;
-  using VectorType = typename FullRefinementType::VectorType;
-
-  // Vectorize positions
-  VectorType transformedPositions = Eigen::Map<Eigen::VectorXd>(
-    embeddedPositions.data(),
-    embeddedPositions.cols() * embeddedPositions.rows()
-  ).template cast<FloatType>().eval();
-
-  const unsigned N = transformedPositions.size() / dimensionality;
-
-  const auto squaredBounds = static_cast<Eigen::MatrixXd>(
-    distanceBounds.access().cwiseProduct(distanceBounds.access())
-  );
-
-  FullRefinementType refinementFunctor {
-    squaredBounds,
-    DgDataPtr->chiralConstraints,
-    DgDataPtr->dihedralConstraints
-  };
+  using FloatType = typename RefinementType::FloatingPointType;
+  constexpr unsigned dimensionality = RefinementTraits<RefinementType>::DimensionalityConstant::value;
+  const unsigned N = positions.size() / dimensionality;
 
   /* If a count of chiral constraints reveals that more than half are
    * incorrect, we can invert the structure (by multiplying e.g. all y
@@ -352,11 +331,11 @@ outcome::result<AngstromPositions> refine(
    * chiral constraints should not have to pass an energetic maximum to
    * converge properly as opposed to tetrahedra with volume).
    */
-  double initiallyCorrectChiralConstraints = refinementFunctor.calculateProportionChiralConstraintsCorrectSign(transformedPositions);
-  if(initiallyCorrectChiralConstraints < 0.5) {
+  double initiallyCorrectChiralConstraints = refinementFunctor.calculateProportionChiralConstraintsCorrectSign(positions);
+  if(invertible && initiallyCorrectChiralConstraints < 0.5) {
     // Invert y coordinates
     for(unsigned i = 0; i < N; ++i) {
-      transformedPositions(dimensionality * i + 1) *= -1;
+      positions(dimensionality * i + 1) *= -1;
     }
 
     initiallyCorrectChiralConstraints = 1 - initiallyCorrectChiralConstraints;
@@ -368,16 +347,17 @@ outcome::result<AngstromPositions> refine(
    */
   unsigned firstStageIterations = 0;
   if(initiallyCorrectChiralConstraints < 1) {
-    Detail::InversionOrIterLimitStop<FullRefinementType> inversionChecker {
+    InversionOrIterLimitStop<RefinementType> inversionChecker {
       configuration.refinementStepLimit,
-      refinementFunctor
+      refinementFunctor,
+      cancellationPtr
     };
 
     Temple::Lbfgs<FloatType, 32> optimizer;
 
     try {
       auto result = optimizer.minimize(
-        transformedPositions,
+        positions,
         refinementFunctor,
         inversionChecker
       );
@@ -386,6 +366,10 @@ outcome::result<AngstromPositions> refine(
       return DgError::RefinementException;
     }
 
+    if(cancelled(cancellationPtr)) {
+      return DgError::Cancelled;
+    }
+
     if(firstStageIterations >= configuration.refinementStepLimit) {
       return DgError::RefinementMaxIterationsReached;
     }
@@ -401,15 +385,16 @@ outcome::result<AngstromPositions> refine(
   refinementFunctor.compressFourthDimension = true;
 
   unsigned secondStageIterations = 0;
-  Detail::GradientOrIterLimitStop<FloatType> gradientChecker;
+  GradientOrIterLimitStop<FloatType> gradientChecker;
   gradientChecker.gradNorm = 1e-3;
   gradientChecker.iterLimit = configuration.refinementStepLimit - firstStageIterations;
+  gradientChecker.cancellationPtr = cancellationPtr;
 
   try {
     Temple::Lbfgs<FloatType, 32> optimizer;
 
     auto result = optimizer.minimize(
-      transformedPositions,
+      positions,
       refinementFunctor,
       gradientChecker
     );
@@ -418,6 +403,10 @@ outcome::result<AngstromPositions> refine(
     return DgError::RefinementException;
   }
 
+  if(cancelled(cancellationPtr)) {
+    return DgError::Cancelled;
+  }
+
   // Max iterations reached
   if(secondStageIterations >= gradientChecker.iterLimit) {
     return DgError::RefinementMaxIterationsReached;
@@ -428,25 +417,89 @@ outcome::result<AngstromPositions> refine(
     return DgError::RefinedChiralsWrong;
   }
 
+  return firstStageIterations + secondStageIterations;
+}
+
+/*! @brief All refinement stages
+ *
+ * @param positions Refinement parameters, refined in place
+ * @param refinementFunctor Refinement problem of the final stage
+ * @param makeSingleFunctor Creates a single precision refinement problem for
+ *   the initial stages of mixed precision refinement. Its parameters are
+ *   those of @p refinementFunctor cast to single precision.
+ * @param twistRotatableGroups Twists freely rotatable dihedrals in parameters
+ *   to their target values
+ * @param invertible Whether the structure may be inverted in the initial
+ *   stages
+ */
+template<typename RefinementType, typename SingleFactory, typename TwistFunction>
+outcome::result<void> refinementStages(
+  typename RefinementType::VectorType& positions,
+  RefinementType& refinementFunctor,
+  SingleFactory&& makeSingleFunctor,
+  TwistFunction&& twistRotatableGroups,
+  const DistanceBoundsMatrix& distanceBounds,
+  const Configuration& configuration,
+  const Cancellation* const cancellationPtr,
+  const bool invertible
+) {
+  using FloatType = typename RefinementType::FloatingPointType;
+  using VectorType = typename RefinementType::VectorType;
+
+  /* The chiral inversion and fourth dimension compression stages only need
+   * to reach the right basin, so they may be run in single precision
+   */
+  unsigned initialIterations = 0;
+  if(configuration.mixedPrecisionRefinement) {
+    auto singleRefinementFunctor = makeSingleFunctor();
+    using SingleRefinementType = decltype(singleRefinementFunctor);
+    typename SingleRefinementType::VectorType singlePositions = positions.template cast<float>();
+
+    auto stagesResult = initialRefinementStages(
+      singlePositions,
+      singleRefinementFunctor,
+      configuration,
+      cancellationPtr,
+      invertible
+    );
+    if(!stagesResult) {
+      return stagesResult.as_failure();
+    }
+
+    initialIterations = stagesResult.value();
+    positions = singlePositions.template cast<FloatType>();
+    refinementFunctor.compressFourthDimension = true;
+  } else {
+    auto stagesResult = initialRefinementStages(
+      positions,
+      refinementFunctor,
+      configuration,
+      cancellationPtr,
+      invertible
+    );
+    if(!stagesResult) {
+      return stagesResult.as_failure();
+    }
+
+    initialIterations = stagesResult.value();
+  }
+
   /* Twist all freely rotatable dihedrals to their target values to avoid
    * conflicts between distance and dihedral errors to prevent rotations to
    * target values.
    */
-  Detail::twistRotatableDihedrals<dimensionality>(
-    transformedPositions,
-    DgDataPtr->dihedralConstraints,
-    DgDataPtr->rotatableGroups
-  );
+  twistRotatableGroups(positions);
 
   /* Add dihedral terms and refine again */
   unsigned thirdStageIterations = 0;
-  gradientChecker = Detail::GradientOrIterLimitStop<FloatType> {};
+  GradientOrIterLimitStop<FloatType> gradientChecker;
   gradientChecker.gradNorm = 1e-3;
-  gradientChecker.iterLimit = (
-    configuration.refinementStepLimit
-    - firstStageIterations
-    - secondStageIterations
-  );
+  gradientChecker.iterLimit = configuration.refinementStepLimit - initialIterations;
+  gradientChecker.cancellationPtr = cancellationPtr;
+
+  if(configuration.trustRegionPolishing) {
+    gradientChecker.stallIterations = 100;
+  }
 
   refinementFunctor.dihedralTerms = true;
 
@@ -454,7 +507,7 @@ outcome::result<AngstromPositions> refine(
     Temple::Lbfgs<FloatType, 32> optimizer;
 
     auto result = optimizer.minimize(
-      transformedPositions,
+      positions,
       refinementFunctor,
       gradientChecker
     );
@@ -463,19 +516,324 @@ outcome::result<AngstromPositions> refine(
     return DgError::RefinementException;
   }
 
+  /* If L-BFGS progress has stalled, switch to a trust region Newton optimizer
+   * using hessian-vector products for the remainder of the final stage
+   */
+  if(gradientChecker.stalled) {
+    TrustRegionGradientOrIterLimitStop trustRegionChecker;
+    trustRegionChecker.gradNorm = gradientChecker.gradNorm;
+    trustRegionChecker.iterLimit = gradientChecker.iterLimit - thirdStageIterations;
+    trustRegionChecker.cancellationPtr = cancellationPtr;
+
+    try {
+      Temple::TruncatedTrustRegionOptimizer<FloatType> optimizer;
+
+      auto result = optimizer.minimize(
+        positions,
+        refinementFunctor,
+        [&](const VectorType& parameters, const VectorType& direction, Eigen::Ref<VectorType> product) {
+          refinementFunctor.hessianVectorProduct(parameters, direction, product);
+        },
+        trustRegionChecker
+      );
+      thirdStageIterations += result.iterations;
+    } catch(std::out_of_range& e) {
+      return DgError::RefinementException;
+    }
+  }
+
+  if(cancelled(cancellationPtr)) {
+    return DgError::Cancelled;
+  }
+
   if(thirdStageIterations >= gradientChecker.iterLimit) {
     return DgError::RefinementMaxIterationsReached;
   }
 
   // Structure inacceptable
-  if(
-    !finalStructureAcceptable(
+  if(!finalStructureAcceptable(refinementFunctor, distanceBounds, positions)) {
+    return DgError::RefinedStructureInacceptable;
+  }
+
+  return outcome::success();
+}
+
+/*! @brief Moves embedded positions onto the fixed positions
+ *
+ * Inverts the structure if most chiral constraints are incorrect, superimposes
+ * it onto the fixed positions and then places fixed atoms exactly, with a
+ * zero fourth dimension.
+ *
+ * @complexity{@math{\Theta(N + C)}}
+ */
+template<unsigned dimensionality, typename RefinementType>
+void placeFixedAtoms(
+  Eigen::Ref<Eigen::VectorXd> positions,
+  const RefinementType& refinementFunctor,
+  const Configuration& configuration
+) {
+  static_assert(dimensionality == 4, "Gathering positions requires four dimensions");
+  const unsigned N = positions.size() / dimensionality;
+
+  // Fixed positions preclude inversion during refinement
+  if(refinementFunctor.calculateProportionChiralConstraintsCorrectSign(positions) < 0.5) {
+    for(unsigned i = 0; i < N; ++i) {
+      positions(dimensionality * i + 1) *= -1;
+    }
+  }
+
+  const Eigen::MatrixXd fitted = fitAndSetFixedPositions(gather(positions), configuration);
+  for(unsigned i = 0; i < N; ++i) {
+    positions.template segment<3>(dimensionality * i) = fitted.row(i).transpose();
+  }
+
+  for(const auto& indexPositionPair : configuration.fixedPositions) {
+    const AtomIndex i = indexPositionPair.first;
+    positions.template segment<3>(dimensionality * i) = (
+      Utils::Constants::angstrom_per_bohr * indexPositionPair.second
+    );
+    positions(dimensionality * i + 3) = 0.0;
+  }
+}
+
+} // namespace Detail
+
+Cancellation::Cancellation(const Clock::time_point deadline) : deadline_(deadline) {}
+
+void Cancellation::request() {
+#pragma omp atomic write
+  flag_ = true;
+}
+
+bool Cancellation::requested() const {
+  bool flag;
+#pragma omp atomic read
+  flag = flag_;
+  return flag || (deadline_ && Clock::now() >= deadline_.value());
+}
+
+MoleculeDGInformation::GroupMapType MoleculeDGInformation::make(
+  const std::vector<DihedralConstraint>& constraints,
+  const Molecule& molecule
+) {
+  MoleculeDGInformation::GroupMapType groups;
+
+  Temple::forEach(constraints,
+    [&](const DihedralConstraint& constraint) {
+      // It is guaranteed that the sites in the middle have one index only
+      BondIndex bond {
+        constraint.sites.at(1).front(),
+        constraint.sites.at(2).front(),
+      };
+
+      // Populate with group to rotate information on the smaller side
+      if(molecule.graph().cycles().numCycleFamilies(bond) == 0) {
+        auto sides = molecule.graph().splitAlongBridge(bond);
+        if(sides.first.size() < sides.second.size()) {
+          groups.emplace(
+            bond,
+            MoleculeDGInformation::RotatableGroup {bond.first, sides.first}
+          );
+        } else {
+          groups.emplace(
+            bond,
+            MoleculeDGInformation::RotatableGroup {bond.second, sides.second}
+          );
+        }
+      }
+    }
+  );
+
+  return groups;
+}
+
+
+MoleculeDGInformation gatherDGInformation(
+  const Molecule& molecule,
+  const Configuration& configuration
+) {
+  // Generate a spatial model from the molecular graph and stereopermutators
+  SpatialModel spatialModel {molecule, configuration};
+
+  // Extract gathered data
+  MoleculeDGInformation data;
+  data.boundsPtr = std::make_shared<SparseBounds>(
+    spatialModel.makeSparsePairwiseBounds()
+  );
+  data.chiralConstraints = spatialModel.getChiralConstraints();
+  data.dihedralConstraints = spatialModel.getDihedralConstraints();
+  data.rotatableGroups = MoleculeDGInformation::make(data.dihedralConstraints, molecule);
+
+  return data;
+}
+
+outcome::result<void> smoothBounds(
+  MoleculeDGInformation& data,
+  const PrivateGraph& inner
+) {
+  auto graphPtr = std::make_shared<ExplicitBoundsGraph>(inner, *data.boundsPtr);
+
+  // Get distance bounds matrix from the graph
+  auto distanceBoundsResult = graphPtr->makeDistanceBounds();
+  if(!distanceBoundsResult) {
+    return distanceBoundsResult.as_failure();
+  }
+
+  auto distanceBoundsPtr = std::make_shared<DistanceBoundsMatrix>(
+    std::move(distanceBoundsResult.value())
+  );
+
+  /* There should be no need to smooth the distance bounds, because the graph
+   * type ought to create them within the triangle inequality bounds:
+   */
+  assert(distanceBoundsPtr->boundInconsistencies() == 0);
+
+  data.boundsGraphPtr = std::move(graphPtr);
+  data.distanceBoundsPtr = std::move(distanceBoundsPtr);
+  return outcome::success();
+}
+
+outcome::result<AngstromPositions> refine(
+  Eigen::MatrixXd embeddedPositions,
+  const DistanceBoundsMatrix& distanceBounds,
+  const Configuration& configuration,
+  const std::shared_ptr<MoleculeDGInformation>& DgDataPtr,
+  const Cancellation* const cancellationPtr
+) {
+  /* Refinement problem compile-time settings
+   * - Dimensionality four is needed to ensure chiral constraints invert
+   *   nicely
+   * - FloatType double is helpful for refinement stability. Only the last
+   *   stage must be in double precision (see mixedPrecisionRefinement).
+   * - The SIMD implementation of the distance terms only outpaces the
+   *   non-SIMD one if compiled for wide vector instruction sets (e.g.
+   *   -march with AVX2 or AVX-512), and even then, skipping inactive pairs
+   *   via distance term pruning in the non-SIMD implementation is faster.
+   */
+  constexpr unsigned dimensionality = 4;
+  using FloatType = double;
+  constexpr bool SIMD = false;
+
+  using FullRefinementType = EigenRefinementProblem<dimensionality, FloatType, SIMD>;
+  using VectorType = typename FullRefinementType::VectorType;
+
+  // Vectorize positions
+  VectorType transformedPositions = Eigen::Map<Eigen::VectorXd>(
+    embeddedPositions.data(),
+    embeddedPositions.cols() * embeddedPositions.rows()
+  ).template cast<FloatType>().eval();
+
+  /* Refinement problems are constructed from the shared distance bounds,
+   * which they square on access rather than copy
+   */
+
+  /* With fixed atoms eliminated, only free atoms' positions are refined.
+   * Fixed atoms are placed exactly beforehand.
+   */
+  if(configuration.fixedAtomElimination && !configuration.fixedPositions.empty()) {
+    using FixedRefinementType = FixedAtomsRefinementProblem<dimensionality, FloatType, SIMD>;
+
+    std::vector<bool> fixedAtoms(distanceBounds.N(), false);
+    for(const auto& indexPositionPair : configuration.fixedPositions) {
+      fixedAtoms.at(indexPositionPair.first) = true;
+    }
+
+    FixedRefinementType refinementFunctor {
+      distanceBounds,
+      DgDataPtr->chiralConstraints,
+      DgDataPtr->dihedralConstraints,
+      fixedAtoms
+    };
+
+    Detail::placeFixedAtoms<dimensionality>(
+      transformedPositions,
+      refinementFunctor.fullProblem(),
+      configuration
+    );
+    VectorType parameters = refinementFunctor.reduce(transformedPositions);
+
+    // Rotatable groups including fixed atoms cannot be twisted
+    MoleculeDGInformation::GroupMapType freeGroups;
+    for(const auto& bondGroupPair : DgDataPtr->rotatableGroups) {
+      const bool movable = Temple::all_of(
+        bondGroupPair.second.vertices,
+        [&](const AtomIndex i) { return !fixedAtoms.at(i); }
+      );
+      if(movable) {
+        freeGroups.insert(bondGroupPair);
+      }
+    }
+
+    auto stagesResult = Detail::refinementStages(
+      parameters,
       refinementFunctor,
+      [&]() {
+        using SingleRefinementType = FixedAtomsRefinementProblem<dimensionality, float, SIMD>;
+        SingleRefinementType singleRefinementFunctor {
+          distanceBounds,
+          DgDataPtr->chiralConstraints,
+          DgDataPtr->dihedralConstraints,
+          fixedAtoms
+        };
+        singleRefinementFunctor.reduce(
+          refinementFunctor.expand(parameters).template cast<float>()
+        );
+        return singleRefinementFunctor;
+      },
+      [&](VectorType& freeParameters) {
+        VectorType positions = refinementFunctor.expand(freeParameters);
+        Detail::twistRotatableDihedrals<dimensionality>(
+          positions,
+          DgDataPtr->dihedralConstraints,
+          freeGroups
+        );
+        freeParameters = refinementFunctor.reduce(positions);
+      },
       distanceBounds,
-      transformedPositions
-    )
-  ) {
-    return DgError::RefinedStructureInacceptable;
+      configuration,
+      cancellationPtr,
+      false
+    );
+    if(!stagesResult) {
+      return stagesResult.as_failure();
+    }
+
+    return Detail::convertToAngstromPositions(
+      Detail::gather(refinementFunctor.expand(parameters))
+    );
+  }
+
+  FullRefinementType refinementFunctor {
+    distanceBounds,
+    DgDataPtr->chiralConstraints,
+    DgDataPtr->dihedralConstraints
+  };
+
+  auto stagesResult = Detail::refinementStages(
+    transformedPositions,
+    refinementFunctor,
+    [&]() {
+      using SingleRefinementType = EigenRefinementProblem<dimensionality, float, SIMD>;
+      return SingleRefinementType {
+        distanceBounds,
+        DgDataPtr->chiralConstraints,
+        DgDataPtr->dihedralConstraints
+      };
+    },
+    [&](VectorType& positions) {
+      Detail::twistRotatableDihedrals<dimensionality>(
+        positions,
+        DgDataPtr->dihedralConstraints,
+        DgDataPtr->rotatableGroups
+      );
+    },
+    distanceBounds,
+    configuration,
+    cancellationPtr,
+    true
+  );
+  if(!stagesResult) {
+    return stagesResult.as_failure();
   }
 
   auto gatheredPositions = Detail::gather(transformedPositions);
@@ -494,7 +852,8 @@ outcome::result<AngstromPositions> generateConformer(
   const Configuration& configuration,
   std::shared_ptr<MoleculeDGInformation>& DgDataPtr,
   bool regenerateDGDataEachStep,
-  Random::Engine& engine
+  Random::Engine& engine,
+  const Cancellation* const cancellationPtr
 ) {
   if(regenerateDGDataEachStep) {
     auto moleculeCopy = Detail::narrow(molecule, engine);
@@ -508,23 +867,61 @@ outcome::result<AngstromPositions> generateConformer(
     );
   }
 
-  ExplicitBoundsGraph explicitGraph {
-    molecule.graph().inner(),
-    DgDataPtr->bounds
-  };
-
-  // Get distance bounds matrix from the graph
-  auto distanceBoundsResult = explicitGraph.makeDistanceBounds();
-  if(!distanceBoundsResult) {
-    return distanceBoundsResult.as_failure();
+  if(!DgDataPtr->boundsGraphPtr) {
+    auto smoothingResult = smoothBounds(*DgDataPtr, molecule.graph().inner());
+    if(!smoothingResult) {
+      return smoothingResult.as_failure();
+    }
   }
 
-  DistanceBoundsMatrix distanceBounds {std::move(distanceBoundsResult.value())};
+  /* Very large molecules may be embedded in fragments instead. Fixed
+   * positions are not supported in this mode.
+   */
+  if(
+    configuration.fragmentSize > 0
+    && molecule.graph().N() > configuration.fragmentSize
+    && configuration.fixedPositions.empty()
+  ) {
+    const auto fragmentation = Fragmentation::make(
+      molecule.graph().inner(),
+      DgDataPtr->rotatableGroups,
+      configuration.fragmentSize
+    );
+
+    if(fragmentation.fragments.size() > 1) {
+      auto embeddingResult = embedFragments(
+        molecule.graph().inner(),
+        *DgDataPtr,
+        fragmentation,
+        configuration,
+        engine,
+        cancellationPtr
+      );
+      if(!embeddingResult) {
+        return embeddingResult.as_failure();
+      }
 
-  /* There should be no need to smooth the distance bounds, because the graph
-   * type ought to create them within the triangle inequality bounds:
+      if(Detail::cancelled(cancellationPtr)) {
+        return DgError::Cancelled;
+      }
+
+      /* Refinement of the whole molecule. Intra-fragment distance terms are
+       * mostly satisfied already, and hence pruned.
+       */
+      return refine(
+        std::move(embeddingResult.value()),
+        *DgDataPtr->distanceBoundsPtr,
+        configuration,
+        DgDataPtr,
+        cancellationPtr
+      );
+    }
+  }
+
+  /* Distance choices modify the graph, so each conformer works on its own
+   * copy of the shared graph
    */
-  assert(distanceBounds.boundInconsistencies() == 0);
+  ExplicitBoundsGraph explicitGraph = *DgDataPtr->boundsGraphPtr;
 
   // Generate a distances matrix from the graph
   auto distanceMatrixResult = explicitGraph.makeDistanceMatrix(
@@ -543,30 +940,33 @@ outcome::result<AngstromPositions> generateConformer(
   // Get a position matrix by embedding the metric matrix
   auto embeddedPositions = metric.embed();
 
+  if(Detail::cancelled(cancellationPtr)) {
+    return DgError::Cancelled;
+  }
+
   /* Refinement */
   return refine(
     std::move(embeddedPositions),
-    distanceBounds,
+    *DgDataPtr->distanceBoundsPtr,
     configuration,
-    DgDataPtr
+    DgDataPtr,
+    cancellationPtr
   );
 }
 
-std::vector<
-  outcome::result<AngstromPositions>
-> run(
+void run(
   const Molecule& molecule,
   const unsigned numConformers,
   const Configuration& configuration,
-  const boost::optional<unsigned> seedOption
+  const boost::optional<unsigned> seedOption,
+  const ConformerCallback& callback
 ) {
-  using ReturnType = std::vector<
-    outcome::result<AngstromPositions>
-  >;
-
   // In case there are zero assignment stereopermutators, we give up immediately
   if(molecule.stereopermutators().hasZeroAssignmentStereopermutators()) {
-    return ReturnType(numConformers, DgError::ZeroAssignmentStereopermutators);
+    for(unsigned i = 0; i < numConformers; ++i) {
+      callback(i, DgError::ZeroAssignmentStereopermutators);
+    }
+    return;
   }
 
 #ifdef _OPENMP
@@ -585,9 +985,18 @@ std::vector<
   bool regenerateEachStep = molecule.stereopermutators().hasUnassignedStereopermutators();
   if(!regenerateEachStep) {
     *DgDataPtr = gatherDGInformation(molecule, configuration);
-  }
 
-  ReturnType results(numConformers, static_cast<DgError>(0));
+    /* The smoothed distance bounds are then also shared across all
+     * conformers. If the bounds are contradictory, no conformer can succeed.
+     */
+    auto smoothingResult = smoothBounds(*DgDataPtr, molecule.graph().inner());
+    if(!smoothingResult) {
+      for(unsigned i = 0; i < numConformers; ++i) {
+        callback(i, smoothingResult.error());
+      }
+      return;
+    }
+  }
 
   /* If a seed is supplied, the global prng state is not to be advanced.
    * We create a random engine from the seed here if a seed is supplied.
@@ -625,6 +1034,13 @@ std::vector<
     backgroundEngine
   );
 
+  /* Exceptions cannot propagate out of the parallel region. The first
+   * exception thrown by the callback is kept and rethrown afterwards, and no
+   * further conformers are generated once one is stored.
+   */
+  std::exception_ptr callbackException;
+  bool aborted = false;
+
   /* Each thread has its own DgDataPtr, for the following reason: If we do
    * not need to regenerate the SpatialModel data, then having all threads
    * share access the underlying data to generate conformers is fine. If,
@@ -634,6 +1050,13 @@ std::vector<
    */
 #pragma omp parallel for firstprivate(DgDataPtr) schedule(dynamic)
   for(unsigned i = 0; i < numConformers; ++i) {
+    bool skip;
+#pragma omp atomic read
+    skip = aborted;
+    if(skip) {
+      continue;
+    }
+
     // Get thread-specific randomness engine reference
 #ifdef _OPENMP
     Random::Engine& engine = randomnessEngines.at(
@@ -646,29 +1069,378 @@ std::vector<
     // Re-seed the thread-local PRNG engine for each conformer
     engine.seed(seeds.at(i));
 
+    outcome::result<AngstromPositions> conformerResult = DgError::UnknownException;
+
     /* We have to handle any and all exceptions here bceause this is a parallel
      * environment and exceptions are not propagated anywhere
      */
     try {
       // Generate the conformer
-      auto conformerResult = generateConformer(
+      conformerResult = generateConformer(
         molecule,
         configuration,
         DgDataPtr,
         regenerateEachStep,
         engine
       );
-
-      results.at(i) = std::move(conformerResult);
     } catch(std::exception& e) {
 #pragma omp critical(outputWarning)
       {
         std::cerr << "WARNING: Uncaught exception in conformer generation: " << e.what() << "\n";
       }
-      results.at(i) = DgError::UnknownException;
     } // end catch
+
+    // Deliver the result as soon as it is available
+#pragma omp critical(conformerCallback)
+    {
+      if(!callbackException) {
+        try {
+          callback(i, std::move(conformerResult));
+        } catch(...) {
+          callbackException = std::current_exception();
+#pragma omp atomic write
+          aborted = true;
+        }
+      }
+    }
   } // end pragma omp for private(DgDataPtr)
 
+  if(callbackException) {
+    std::rethrow_exception(callbackException);
+  }
+}
+
+void run(
+  const Molecule& molecule,
+  const EnsembleBudget& budget,
+  const Configuration& configuration,
+  const boost::optional<unsigned> seedOption,
+  const ConformerCallback& callback
+) {
+  if(budget.successes == 0) {
+    return;
+  }
+
+  // In case there are zero assignment stereopermutators, we give up immediately
+  if(molecule.stereopermutators().hasZeroAssignmentStereopermutators()) {
+    callback(0, DgError::ZeroAssignmentStereopermutators);
+    return;
+  }
+
+#ifdef _OPENMP
+  /* Ensure the molecule's mutable properties are already generated so none are
+   * generated on threaded const-access.
+   */
+  molecule.graph().inner().populateProperties();
+#endif
+
+  // Modelling data can be shared if no randomness enters it (see above)
+  auto DgDataPtr = std::make_shared<MoleculeDGInformation>();
+  bool regenerateEachStep = molecule.stereopermutators().hasUnassignedStereopermutators();
+  if(!regenerateEachStep) {
+    *DgDataPtr = gatherDGInformation(molecule, configuration);
+
+    // Contradictory bounds make any further attempts futile
+    auto smoothingResult = smoothBounds(*DgDataPtr, molecule.graph().inner());
+    if(!smoothingResult) {
+      callback(0, smoothingResult.error());
+      return;
+    }
+  }
+
+  auto engineOption = Temple::Optionals::map(
+    seedOption,
+    [](unsigned seed) { return Random::Engine(seed); }
+  );
+  std::reference_wrapper<Random::Engine> backgroundEngineWrapper = randomnessEngine();
+  if(engineOption) {
+    backgroundEngineWrapper = engineOption.value();
+  }
+  Random::Engine& backgroundEngine = backgroundEngineWrapper.get();
+
+  Cancellation cancellation;
+  if(budget.timeLimit > 0) {
+    cancellation = Cancellation {
+      Cancellation::Clock::now() + std::chrono::duration_cast<Cancellation::Clock::duration>(
+        std::chrono::duration<double>(budget.timeLimit)
+      )
+    };
+  }
+
+  /* Attempts are scheduled until the budget is exhausted. Since their number
+   * is not known in advance, the attempts' seeds are drawn on scheduling
+   * instead of ahead of time. Drawing and index assignment are performed in
+   * the same critical section, so attempt i always receives the i-th seed.
+   */
+  unsigned nextAttempt = 0;
+  unsigned finishedAttempts = 0;
+  unsigned successes = 0;
+  unsigned failures = 0;
+  std::exception_ptr callbackException;
+
+#pragma omp parallel firstprivate(DgDataPtr)
+  {
+    Random::Engine engine;
+
+    while(true) {
+      bool scheduled = false;
+      unsigned attempt = 0;
+      int seed = 0;
+#pragma omp critical(budgetedScheduling)
+      {
+        if(
+          !cancellation.requested()
+          && (budget.maxAttempts == 0 || nextAttempt < budget.maxAttempts)
+        ) {
+          attempt = nextAttempt++;
+          seed = Temple::Random::getSingle<int>(
+            0,
+            std::numeric_limits<int>::max(),
+            backgroundEngine
+          );
+          scheduled = true;
+        }
+      }
+
+      if(!scheduled) {
+        break;
+      }
+
+      engine.seed(seed);
+
+      outcome::result<AngstromPositions> conformerResult = DgError::UnknownException;
+      try {
+        conformerResult = generateConformer(
+          molecule,
+          configuration,
+          DgDataPtr,
+          regenerateEachStep,
+          engine,
+          &cancellation
+        );
+      } catch(std::exception& e) {
+#pragma omp critical(outputWarning)
+        {
+          std::cerr << "WARNING: Uncaught exception in conformer generation: " << e.what() << "\n";
+        }
+      }
+
+      /* Results finishing after the budget is exhausted are discarded, which
+       * includes any cancelled attempts
+       */
+#pragma omp critical(conformerCallback)
+      {
+        if(!cancellation.requested()) {
+          if(conformerResult) {
+            ++successes;
+          } else {
+            ++failures;
+          }
+          ++finishedAttempts;
+
+          try {
+            callback(attempt, std::move(conformerResult));
+          } catch(...) {
+            callbackException = std::current_exception();
+            cancellation.request();
+          }
+
+          const bool futile = (
+            finishedAttempts >= budget.failureRateMinAttempts
+            && failures > budget.maxFailureRate * finishedAttempts
+          );
+          if(successes >= budget.successes || futile) {
+            cancellation.request();
+          }
+        }
+      }
+    }
+  } // end pragma omp parallel
+
+  if(callbackException) {
+    std::rethrow_exception(callbackException);
+  }
+}
+
+std::vector<
+  outcome::result<AngstromPositions>
+> run(
+  const Molecule& molecule,
+  const unsigned numConformers,
+  const Configuration& configuration,
+  const boost::optional<unsigned> seedOption
+) {
+  std::vector<
+    outcome::result<AngstromPositions>
+  > results(numConformers, static_cast<DgError>(0));
+
+  run(
+    molecule,
+    numConformers,
+    configuration,
+    seedOption,
+    [&results](const unsigned i, outcome::result<AngstromPositions> conformerResult) {
+      results.at(i) = std::move(conformerResult);
+    }
+  );
+
+  return results;
+}
+
+std::vector<
+  std::vector<
+    outcome::result<AngstromPositions>
+  >
+> run(
+  const std::vector<Molecule>& molecules,
+  const std::vector<unsigned>& numConformers,
+  const std::vector<Configuration>& configurations,
+  const boost::optional<unsigned> seedOption
+) {
+  assert(molecules.size() == numConformers.size());
+  assert(molecules.size() == configurations.size());
+  const unsigned M = molecules.size();
+
+  auto engineOption = Temple::Optionals::map(
+    seedOption,
+    [](unsigned seed) { return Random::Engine(seed); }
+  );
+  std::reference_wrapper<Random::Engine> backgroundEngineWrapper = randomnessEngine();
+  if(engineOption) {
+    backgroundEngineWrapper = engineOption.value();
+  }
+  Random::Engine& backgroundEngine = backgroundEngineWrapper.get();
+
+  /* Each molecule's conformer seeds are drawn from an engine seeded with a
+   * per-molecule seed exactly as in the single-molecule variant, making each
+   * molecule's results independent of the others.
+   */
+  const auto moleculeSeeds = Temple::Random::getN<int>(
+    0,
+    std::numeric_limits<int>::max(),
+    M,
+    backgroundEngine
+  );
+  std::vector<std::vector<int>> seeds;
+  seeds.reserve(M);
+  for(unsigned m = 0; m < M; ++m) {
+    Random::Engine moleculeEngine(moleculeSeeds.at(m));
+    seeds.push_back(
+      Temple::Random::getN<int>(
+        0,
+        std::numeric_limits<int>::max(),
+        numConformers.at(m),
+        moleculeEngine
+      )
+    );
+  }
+
+  std::vector<
+    std::vector<
+      outcome::result<AngstromPositions>
+    >
+  > results;
+  results.reserve(M);
+  for(unsigned m = 0; m < M; ++m) {
+    results.emplace_back(numConformers.at(m), DgError::UnknownException);
+  }
+
+  /* Flatten all conformers into a single task list. Molecules are ordered by
+   * decreasing size so that the most expensive tasks are scheduled first and
+   * the remainder can balance out the load.
+   */
+  std::vector<std::pair<unsigned, unsigned>> tasks;
+  tasks.reserve(std::accumulate(std::begin(numConformers), std::end(numConformers), 0u));
+  for(unsigned m = 0; m < M; ++m) {
+    for(unsigned i = 0; i < numConformers.at(m); ++i) {
+      tasks.emplace_back(m, i);
+    }
+  }
+  std::stable_sort(
+    std::begin(tasks),
+    std::end(tasks),
+    [&](const auto& a, const auto& b) {
+      return molecules.at(a.first).graph().N() > molecules.at(b.first).graph().N();
+    }
+  );
+
+  std::vector<std::shared_ptr<MoleculeDGInformation>> DgData(M);
+  std::vector<outcome::result<void>> preparations(M, outcome::success());
+  // Not a vector<bool> since elements are written from multiple threads
+  std::vector<char> regenerateEachStep(M, false);
+
+#pragma omp parallel
+  {
+    /* Preparation stage: Spatial modeling and bounds smoothing for each
+     * molecule whose modeling data can be shared across its conformers
+     */
+#pragma omp for schedule(dynamic)
+    for(unsigned m = 0; m < M; ++m) {
+      const Molecule& molecule = molecules[m];
+      if(molecule.stereopermutators().hasZeroAssignmentStereopermutators()) {
+        preparations[m] = DgError::ZeroAssignmentStereopermutators;
+        continue;
+      }
+
+#ifdef _OPENMP
+      molecule.graph().inner().populateProperties();
+#endif
+
+      regenerateEachStep[m] = molecule.stereopermutators().hasUnassignedStereopermutators();
+      if(regenerateEachStep[m]) {
+        continue;
+      }
+
+      try {
+        auto dataPtr = std::make_shared<MoleculeDGInformation>(
+          gatherDGInformation(molecule, configurations[m])
+        );
+        preparations[m] = smoothBounds(*dataPtr, molecule.graph().inner());
+        DgData[m] = std::move(dataPtr);
+      } catch(std::exception& e) {
+        preparations[m] = DgError::UnknownException;
+#pragma omp critical(outputWarning)
+        {
+          std::cerr << "WARNING: Uncaught exception in conformer generation: " << e.what() << "\n";
+        }
+      }
+    } // Implicit barrier
+
+    Random::Engine engine;
+
+    // Conformer stage
+#pragma omp for schedule(dynamic)
+    for(unsigned t = 0; t < tasks.size(); ++t) {
+      const unsigned m = tasks[t].first;
+      const unsigned i = tasks[t].second;
+
+      if(!preparations[m]) {
+        results[m][i] = preparations[m].as_failure();
+        continue;
+      }
+
+      engine.seed(seeds[m][i]);
+
+      // Shared modeling data, or a thread-private pointer to be reset
+      auto dataPtr = regenerateEachStep[m] ? std::make_shared<MoleculeDGInformation>() : DgData[m];
+
+      try {
+        results[m][i] = generateConformer(
+          molecules[m],
+          configurations[m],
+          dataPtr,
+          regenerateEachStep[m],
+          engine
+        );
+      } catch(std::exception& e) {
+#pragma omp critical(outputWarning)
+        {
+          std::cerr << "WARNING: Uncaught exception in conformer generation: " << e.what() << "\n";
+        }
+      }
+    }
+  } // end pragma omp parallel
+
   return results;
 }
 
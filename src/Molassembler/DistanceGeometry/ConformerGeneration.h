@@ -12,8 +12,12 @@
 #define INCLUDE_MOLASSEMBLER_DISTANCE_GEOMETRY_CONFORMER_GENERATION_H
 
 #include "Molassembler/DistanceGeometry/SpatialModel.h"
+#include "Molassembler/DistanceGeometry/ExplicitBoundsGraph.h"
 #include "Molassembler/Log.h"
 
+#include <chrono>
+#include <functional>
+
 namespace Scine {
 namespace Molassembler {
 
@@ -82,10 +86,29 @@ struct MoleculeDGInformation {
     const Molecule& molecule
   );
 
-  SpatialModel::BoundsMatrix bounds;
+  /*! @brief Pairwise bounds from the spatial model
+   *
+   * Sparse, unlike the dense smoothed bounds derived from it by smoothBounds.
+   * Shared by all conformers generated from this data, since fragment
+   * embedding needs them after smoothing.
+   */
+  std::shared_ptr<const SparseBounds> boundsPtr;
   std::vector<ChiralConstraint> chiralConstraints;
   std::vector<DihedralConstraint> dihedralConstraints;
   GroupMapType rotatableGroups;
+
+  /*! @brief Bounds graph prior to any distance choices
+   *
+   * Populated by smoothBounds. Shared (and copied prior to distance choices)
+   * by all conformers generated from this data.
+   */
+  std::shared_ptr<const ExplicitBoundsGraph> boundsGraphPtr;
+  /*! @brief Triangle-smoothed distance bounds
+   *
+   * Populated by smoothBounds. Shared by all conformers generated from this
+   * data.
+   */
+  std::shared_ptr<const DistanceBoundsMatrix> distanceBoundsPtr;
 };
 
 /*! @brief Collects intermediate conformational data about a Molecule using a spatial model
@@ -99,12 +122,53 @@ MoleculeDGInformation gatherDGInformation(
   const Configuration& configuration
 );
 
+/*! @brief Builds the bounds graph and triangle-smoothed distance bounds
+ *
+ * Both depend only on the pairwise bounds, so they need to be calculated only
+ * once for any number of conformers generated from the same data.
+ *
+ * @complexity{@math{\Theta(V \cdot E)}}
+ *
+ * @returns DgError::GraphImpossible if the pairwise bounds contradict one
+ *   another
+ */
+outcome::result<void> smoothBounds(
+  MoleculeDGInformation& data,
+  const PrivateGraph& inner
+);
+
+/*! @brief Cooperative cancellation of conformer generation
+ *
+ * Conformer generation polls this between stages and refinement iterations
+ * and returns DgError::Cancelled once cancellation is requested explicitly or
+ * an optional deadline has passed.
+ */
+class Cancellation {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  //! Without deadline
+  Cancellation() = default;
+  //! With deadline
+  explicit Cancellation(Clock::time_point deadline);
+
+  //! Requests cancellation. Thread-safe.
+  void request();
+  //! Whether cancellation is requested or the deadline passed. Thread-safe.
+  bool requested() const;
+
+private:
+  bool flag_ = false;
+  boost::optional<Clock::time_point> deadline_;
+};
+
 //! @brief Distance Geometry refinement
 outcome::result<AngstromPositions> refine(
   Eigen::MatrixXd embeddedPositions,
   const DistanceBoundsMatrix& distanceBounds,
   const Configuration& configuration,
-  const std::shared_ptr<MoleculeDGInformation>& DgDataPtr
+  const std::shared_ptr<MoleculeDGInformation>& DgDataPtr,
+  const Cancellation* cancellationPtr = nullptr
 );
 
 // @brief Individual conformer generation routine
@@ -113,7 +177,69 @@ outcome::result<AngstromPositions> generateConformer(
   const Configuration& configuration,
   std::shared_ptr<MoleculeDGInformation>& DgDataPtr,
   bool regenerateDGDataEachStep,
-  Random::Engine& engine
+  Random::Engine& engine,
+  const Cancellation* cancellationPtr = nullptr
+);
+
+/*! @brief Callback type for conformers delivered as soon as they are generated
+ *
+ * Called with the index of the conformer within the ensemble and its result.
+ */
+using ConformerCallback = std::function<
+  void(unsigned, outcome::result<AngstromPositions>)
+>;
+
+/** @brief Budgeted parallel implementation of Distance Geometry. Attempts
+ *   conformers until a budget is exhausted.
+ *
+ * Attempts are scheduled until EnsembleBudget::successes conformers are
+ * generated successfully, the time limit passes, the maximum number of
+ * attempts is reached or the failure rate exceeds its limit. Conformers still
+ * being generated at that point are cancelled and not delivered.
+ *
+ * @param molecule Molecule to generate conformers for
+ * @param budget Limits on the attempted conformers
+ * @param configuration Configuration object
+ * @param seedOption Optional seed for the attempts' seeds. If not supplied,
+ *   the global PRNG is advanced instead.
+ * @param callback Function called with the attempt index and result of each
+ *   finished attempt prior to exhaustion of the budget. Never called
+ *   simultaneously. Attempt indices need not be contiguous. Should the
+ *   callback throw, generation stops and the exception is rethrown.
+ *
+ * @note Attempt @math{i} yields the same result as conformer @math{i} of the
+ * unbudgeted variant with the same seed.
+ */
+void run(
+  const Molecule& molecule,
+  const EnsembleBudget& budget,
+  const Configuration& configuration,
+  boost::optional<unsigned> seedOption,
+  const ConformerCallback& callback
+);
+
+/** @brief Main and parallel implementation of Distance Geometry. Generates an
+ *   ensemble of 3D structures of a given Molecule, delivering each to a
+ *   callback as soon as it is generated
+ *
+ * Conformers are generated from the same per-index seeds as in the
+ * vector-returning overload, so the result for each index is reproducible
+ * irrespective of the order of callback invocations.
+ *
+ * @param callback Called exactly once for each conformer index with its
+ *   result. Never called simultaneously from multiple threads. If it throws,
+ *   no further conformers are generated and the first exception is rethrown
+ *   once all threads have finished.
+ *
+ * @complexity{Roughly @math{O(C \cdot N^3)} where @math{C} is the number of
+ * conformers and @math{N} is the number of atoms in @p molecule}
+ */
+void run(
+  const Molecule& molecule,
+  unsigned numConformers,
+  const Configuration& configuration,
+  boost::optional<unsigned> seedOption,
+  const ConformerCallback& callback
 );
 
 /** @brief Main and parallel implementation of Distance Geometry. Generates an
@@ -133,6 +259,37 @@ std::vector<
   boost::optional<unsigned> seedOption
 );
 
+/** @brief Batched parallel implementation of Distance Geometry for multiple
+ *   molecules
+ *
+ * Schedules all conformers of all molecules through a single parallel region
+ * instead of one per molecule, so that small molecules can fill all threads.
+ * Spatial modeling and bounds smoothing of all molecules are a parallel stage
+ * of their own before any conformers are generated.
+ *
+ * @param molecules Molecules to generate conformers for
+ * @param numConformers Number of conformers to generate for each molecule
+ * @param configurations Configuration object for each molecule
+ * @param seedOption Optional seed for the per-molecule seeds. If not
+ *   supplied, the global PRNG is advanced instead.
+ *
+ * @pre All arguments except @p seedOption have the same size
+ *
+ * @note The m-th molecule's results are those of the single-molecule variant
+ * with the m-th of a sequence of seeds drawn from @p seedOption (or the global
+ * PRNG), and hence independent of the other molecules and of scheduling.
+ */
+std::vector<
+  std::vector<
+    outcome::result<AngstromPositions>
+  >
+> run(
+  const std::vector<Molecule>& molecules,
+  const std::vector<unsigned>& numConformers,
+  const std::vector<Configuration>& configurations,
+  boost::optional<unsigned> seedOption
+);
+
 } // namespace DistanceGeometry
 } // namespace Molassembler
 } // namespace Scine
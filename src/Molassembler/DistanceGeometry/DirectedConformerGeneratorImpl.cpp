@@ -15,10 +15,18 @@
 #include "Molassembler/Temple/Functional.h"
 #include "Molassembler/Temple/Optionals.h"
 #include "Molassembler/Temple/Random.h"
+#include "Molassembler/DistanceGeometry/ConformerGeneration.h"
 #include "Molassembler/DistanceGeometry/Error.h"
+#include "Molassembler/DistanceGeometry/SpatialModel.h"
 
+#include "Utils/Constants.h"
 #include "Utils/Geometry/AtomCollection.h"
+#include "boost/lockfree/queue.hpp"
 #include "boost/variant.hpp"
+#include "nlohmann/json.hpp"
+
+#include <atomic>
+#include <memory>
 
 namespace Scine {
 namespace Molassembler {
@@ -109,6 +117,89 @@ struct BoundedNodeTrieChooseFunctor {
   }
 };
 
+/*! @brief Independently drawable part of the space of decision lists
+ *
+ * All decision lists of a shard share the same prefix. Suffixes are drawn from
+ * a trie and an engine owned by the shard, so that distinct shards can be
+ * drawn from concurrently without synchronization.
+ */
+struct DecisionListShard {
+  using DecisionList = DirectedConformerGenerator::DecisionList;
+
+  DecisionListShard(
+    DecisionList shardPrefix,
+    DecisionList suffixBounds,
+    const unsigned seed
+  ) : prefix(std::move(shardPrefix)), engine(seed) {
+    if(!suffixBounds.empty()) {
+      suffixes.setBounds(std::move(suffixBounds));
+    }
+  }
+
+  //! Number of decision lists in the shard
+  unsigned capacity() const {
+    return suffixes.bounds().empty() ? 1 : suffixes.capacity();
+  }
+
+  //! Draws a new decision list, maximally different from those already drawn
+  DecisionList generateNewDecisionList() {
+    if(suffixes.bounds().empty()) {
+      return prefix;
+    }
+
+    BoundedNodeTrieChooseFunctor<std::uint8_t> chooseFunctor {engine};
+    DecisionList decisionList = prefix;
+    const DecisionList suffix = suffixes.generateNewEntry(chooseFunctor);
+    decisionList.insert(std::end(decisionList), std::begin(suffix), std::end(suffix));
+    return decisionList;
+  }
+
+  DecisionList prefix;
+  Temple::BoundedNodeTrie<std::uint8_t> suffixes;
+  Random::Engine engine;
+};
+
+/*! @brief Partitions the space of decision lists by their leading decisions
+ *
+ * Chooses the shortest prefix length yielding at least @p minShards shards.
+ * The order of shards is drawn as in a trie so that neighboring shards are
+ * maximally different. The partitioning is independent of the number of
+ * threads, keeping enumeration reproducible.
+ */
+std::vector<DecisionListShard> shardDecisionLists(
+  const DirectedConformerGenerator::DecisionList& bounds,
+  const unsigned seed,
+  const unsigned minShards
+) {
+  using DecisionList = DirectedConformerGenerator::DecisionList;
+
+  unsigned prefixLength = 0;
+  unsigned shardCount = 1;
+  while(prefixLength < bounds.size() && shardCount < minShards) {
+    shardCount *= bounds.at(prefixLength);
+    ++prefixLength;
+  }
+
+  const auto prefixEnd = std::begin(bounds) + prefixLength;
+  Temple::BoundedNodeTrie<std::uint8_t> prefixes {
+    DecisionList(std::begin(bounds), prefixEnd)
+  };
+  const DecisionList suffixBounds(prefixEnd, std::end(bounds));
+
+  Random::Engine engine(seed);
+  BoundedNodeTrieChooseFunctor<std::uint8_t> chooseFunctor {engine};
+  std::vector<DecisionListShard> shards;
+  shards.reserve(shardCount);
+  for(unsigned i = 0; i < shardCount; ++i) {
+    shards.emplace_back(
+      prefixes.generateNewEntry(chooseFunctor),
+      suffixBounds,
+      seed + i + 1
+    );
+  }
+  return shards;
+}
+
 } // namespace Detail
 
 unsigned DirectedConformerGenerator::Impl::distance(
@@ -340,12 +431,171 @@ DirectedConformerGenerator::Impl::checkGeneratedConformation(
   return conformerResult;
 }
 
+std::shared_ptr<const DistanceGeometry::MoleculeDGInformation>
+DirectedConformerGenerator::Impl::invariantModel(
+  const DistanceGeometry::Configuration& configuration
+) const {
+  /* Fixed positions are part of the modeled bounds. Such configurations
+   * neither use nor affect the cached data.
+   */
+  if(!configuration.fixedPositions.empty()) {
+    return nullptr;
+  }
+
+  std::shared_ptr<const DistanceGeometry::MoleculeDGInformation> dataPtr;
+
+#pragma omp critical(invariantModelAccess)
+  {
+    if(
+      !invariantModel_
+      || invariantModel_->loosening != configuration.spatialModelLoosening
+    ) {
+      invariantModel_ = InvariantModel {configuration.spatialModelLoosening, nullptr};
+
+      const auto& stereopermutators = molecule_.stereopermutators();
+      const bool modelable = (
+        !stereopermutators.hasZeroAssignmentStereopermutators()
+        && Temple::all_of(
+          stereopermutators.atomStereopermutators(),
+          [](const AtomStereopermutator& permutator) -> bool {
+            return permutator.assigned().has_value();
+          }
+        )
+        && Temple::all_of(
+          stereopermutators.bondStereopermutators(),
+          [&](const BondStereopermutator& permutator) -> bool {
+            return (
+              permutator.assigned()
+              || Temple::makeContainsPredicate(relevantBonds_)(permutator.placement())
+            );
+          }
+        )
+      );
+
+      if(modelable) {
+        DistanceGeometry::SpatialModel spatialModel {
+          molecule_,
+          configuration,
+          relevantBonds_
+        };
+
+        auto data = std::make_shared<DistanceGeometry::MoleculeDGInformation>();
+        data->boundsPtr = std::make_shared<DistanceGeometry::SparseBounds>(
+          spatialModel.makeSparsePairwiseBounds()
+        );
+        data->chiralConstraints = spatialModel.getChiralConstraints();
+        data->dihedralConstraints = spatialModel.getDihedralConstraints();
+
+        // Rotatable groups of relevant bonds do not depend on their assignment
+        auto groupConstraints = data->dihedralConstraints;
+        for(const BondIndex& bond : relevantBonds_) {
+          BondStereopermutator permutator = stereopermutators.at(bond);
+          permutator.assign(0);
+          const auto bondConstraints = DistanceGeometry::SpatialModel::makeDihedralConstraints(
+            permutator,
+            stereopermutators.at(bond.first),
+            stereopermutators.at(bond.second),
+            configuration.spatialModelLoosening
+          );
+          groupConstraints.insert(
+            std::end(groupConstraints),
+            std::begin(bondConstraints),
+            std::end(bondConstraints)
+          );
+        }
+        data->rotatableGroups = DistanceGeometry::MoleculeDGInformation::make(
+          groupConstraints,
+          molecule_
+        );
+
+        if(DistanceGeometry::smoothBounds(*data, molecule_.graph().inner())) {
+          invariantModel_->dataPtr = std::move(data);
+        }
+      }
+    }
+
+    dataPtr = invariantModel_->dataPtr;
+  }
+
+  return dataPtr;
+}
+
+outcome::result<Utils::PositionCollection>
+DirectedConformerGenerator::Impl::generateFromInvariantModel(
+  const DistanceGeometry::MoleculeDGInformation& invariantData,
+  const DecisionList& decisionList,
+  Random::Engine& engine,
+  const DistanceGeometry::Configuration& configuration
+) const {
+  if(decisionList.size() != relevantBonds_.size()) {
+    throw std::invalid_argument("Passed decision list has wrong length");
+  }
+
+  /* The pairwise bounds, the bounds graph and the smoothed distance bounds do
+   * not depend on the decision list, so they are shared instead of copied
+   */
+  auto dataPtr = std::make_shared<DistanceGeometry::MoleculeDGInformation>();
+  dataPtr->boundsPtr = invariantData.boundsPtr;
+  dataPtr->chiralConstraints = invariantData.chiralConstraints;
+  dataPtr->dihedralConstraints = invariantData.dihedralConstraints;
+  dataPtr->rotatableGroups = invariantData.rotatableGroups;
+  dataPtr->boundsGraphPtr = invariantData.boundsGraphPtr;
+  dataPtr->distanceBoundsPtr = invariantData.distanceBoundsPtr;
+
+  const auto& stereopermutators = molecule_.stereopermutators();
+  Temple::forEach(
+    Temple::Adaptors::zip(relevantBonds_, decisionList),
+    [&](const BondIndex& bond, const std::uint8_t assignment) {
+      BondStereopermutator permutator = stereopermutators.at(bond);
+      permutator.assign(assignment);
+      const auto bondConstraints = DistanceGeometry::SpatialModel::makeDihedralConstraints(
+        permutator,
+        stereopermutators.at(bond.first),
+        stereopermutators.at(bond.second),
+        configuration.spatialModelLoosening
+      );
+      dataPtr->dihedralConstraints.insert(
+        std::end(dataPtr->dihedralConstraints),
+        std::begin(bondConstraints),
+        std::end(bondConstraints)
+      );
+    }
+  );
+
+  auto conformerResult = DistanceGeometry::generateConformer(
+    molecule_,
+    configuration,
+    dataPtr,
+    false,
+    engine
+  );
+
+  if(!conformerResult) {
+    return conformerResult.as_failure();
+  }
+
+  return conformerResult.value().getBohr();
+}
+
 outcome::result<Utils::PositionCollection>
 DirectedConformerGenerator::Impl::generateRandomConformation(
   const DecisionList& decisionList,
   const DistanceGeometry::Configuration& configuration,
   const BondStereopermutator::FittingMode fitting
 ) const {
+  if(auto invariantDataPtr = invariantModel(configuration)) {
+    return checkGeneratedConformation(
+      generateFromInvariantModel(
+        *invariantDataPtr,
+        decisionList,
+        randomnessEngine(),
+        configuration
+      ),
+      decisionList,
+      fitting
+    );
+  }
+
   return checkGeneratedConformation(
     Scine::Molassembler::generateRandomConformation(
       conformationMolecule(decisionList),
@@ -363,6 +613,20 @@ DirectedConformerGenerator::Impl::generateConformation(
   const DistanceGeometry::Configuration& configuration,
   const BondStereopermutator::FittingMode fitting
 ) const {
+  if(auto invariantDataPtr = invariantModel(configuration)) {
+    Random::Engine engine(seed);
+    return checkGeneratedConformation(
+      generateFromInvariantModel(
+        *invariantDataPtr,
+        decisionList,
+        engine,
+        configuration
+      ),
+      decisionList,
+      fitting
+    );
+  }
+
   return checkGeneratedConformation(
     Scine::Molassembler::generateConformation(
       conformationMolecule(decisionList),
@@ -393,13 +657,7 @@ DirectedConformerGenerator::Impl::getDecisionList(
   return getDecisionList(atomCollection.getPositions(), fitting);
 }
 
-DirectedConformerGenerator::DecisionList
-DirectedConformerGenerator::Impl::getDecisionList(
-  const Utils::PositionCollection& positions,
-  const BondStereopermutator::FittingMode fitting
-) const {
-  const AngstromPositions angstromPositions {positions};
-
+void DirectedConformerGenerator::Impl::checkDecisionListPreconditions_() const {
   if(
     !Temple::all_of(
       relevantBonds_,
@@ -415,6 +673,56 @@ DirectedConformerGenerator::Impl::getDecisionList(
   ) {
     throw std::logic_error("Underlying molecule permutator preconditions unmet!");
   }
+}
+
+AtomStereopermutator::ShapeMap
+DirectedConformerGenerator::Impl::refit_(
+  AtomStereopermutator& refitted,
+  const AtomStereopermutator& stereopermutator,
+  const AngstromPositions& angstromPositions
+) const {
+  auto shapeMap = refitted.fit(molecule_.graph(), angstromPositions);
+  if(refitted.getShape() != stereopermutator.getShape()) {
+    const std::string error = (
+      Shapes::name(refitted.getShape())
+      + " was found instead of "
+      + Shapes::name(stereopermutator.getShape())
+      + " at atom "
+      + std::to_string(stereopermutator.placement())
+      + "! This indicates a precondition violation."
+    );
+    throw std::logic_error(error);
+  }
+  if(refitted.assigned() != stereopermutator.assigned()) {
+    auto assignmentToString = [](const boost::optional<unsigned>& assignment) -> std::string {
+      if(assignment) {
+        return std::to_string(assignment.value());
+      }
+
+      return "U";
+    };
+    const std::string error = (
+      "Assignment "
+      + assignmentToString(refitted.assigned())
+      + " was found instead of "
+      + assignmentToString(stereopermutator.assigned())
+      + " at atom "
+      + std::to_string(stereopermutator.placement())
+      + "! This indicates a precondition violation."
+    );
+    throw std::logic_error(error);
+  }
+  return std::move(shapeMap.value());
+}
+
+DirectedConformerGenerator::DecisionList
+DirectedConformerGenerator::Impl::getDecisionList(
+  const Utils::PositionCollection& positions,
+  const BondStereopermutator::FittingMode fitting
+) const {
+  const AngstromPositions angstromPositions {positions};
+
+  checkDecisionListPreconditions_();
 
   /* Refit all atom stereopermutators and ensure stereopermutations are
    * identical, storing fitted shape maps for bond stereopermutator fitting later
@@ -425,38 +733,10 @@ DirectedConformerGenerator::Impl::getDecisionList(
     molecule_.stereopermutators().atomStereopermutators()
   ) {
     AtomStereopermutator refitted = stereopermutator;
-    auto shapeMap = refitted.fit(molecule_.graph(), angstromPositions);
-    if(refitted.getShape() != stereopermutator.getShape()) {
-      const std::string error = (
-        Shapes::name(refitted.getShape())
-        + " was found instead of "
-        + Shapes::name(stereopermutator.getShape())
-        + " at atom "
-        + std::to_string(stereopermutator.placement())
-        + "! This indicates a precondition violation."
-      );
-      throw std::logic_error(error);
-    }
-    if(refitted.assigned() != stereopermutator.assigned()) {
-      auto assignmentToString = [](const boost::optional<unsigned>& assignment) -> std::string {
-        if(assignment) {
-          return std::to_string(assignment.value());
-        }
-
-        return "U";
-      };
-      const std::string error = (
-        "Assignment "
-        + assignmentToString(refitted.assigned())
-        + " was found instead of "
-        + assignmentToString(stereopermutator.assigned())
-        + " at atom "
-        + std::to_string(stereopermutator.placement())
-        + "! This indicates a precondition violation."
-      );
-      throw std::logic_error(error);
-    }
-    shapeMaps.emplace(stereopermutator.placement(), std::move(shapeMap.value()));
+    shapeMaps.emplace(
+      stereopermutator.placement(),
+      refit_(refitted, stereopermutator, angstromPositions)
+    );
   }
 
   return Temple::map(
@@ -486,58 +766,304 @@ DirectedConformerGenerator::Impl::getDecisionList(
   );
 }
 
+DirectedConformerGenerator::DecisionMatrix
+DirectedConformerGenerator::Impl::getDecisionLists(
+  const Utils::PositionCollection& frames,
+  const BondStereopermutator::FittingMode fitting
+) const {
+  const unsigned N = molecule_.graph().N();
+  if(frames.rows() % N != 0) {
+    throw std::invalid_argument("Number of frame rows is not a multiple of the number of atoms");
+  }
+  const unsigned F = frames.rows() / N;
+  const unsigned B = relevantBonds_.size();
+
+  checkDecisionListPreconditions_();
+
+  /* Only the atom stereopermutators constituting relevant bonds need to be
+   * refit. Collect them once and store the indices of each bond's atoms into
+   * that list.
+   */
+  const auto& stereopermutators = molecule_.stereopermutators();
+  std::vector<AtomIndex> fitAtoms;
+  fitAtoms.reserve(2 * B);
+  for(const BondIndex& bond : relevantBonds_) {
+    fitAtoms.push_back(bond.first);
+    fitAtoms.push_back(bond.second);
+  }
+  Temple::sort(fitAtoms);
+  fitAtoms.erase(std::unique(std::begin(fitAtoms), std::end(fitAtoms)), std::end(fitAtoms));
+  const auto fitAtomIndex = [&](const AtomIndex i) -> unsigned {
+    return std::lower_bound(std::begin(fitAtoms), std::end(fitAtoms), i) - std::begin(fitAtoms);
+  };
+  const auto bondFitAtoms = Temple::map(
+    relevantBonds_,
+    [&](const BondIndex& bond) {
+      return std::make_pair(fitAtomIndex(bond.first), fitAtomIndex(bond.second));
+    }
+  );
+
+#ifdef _OPENMP
+  /* Ensure the molecule's mutable properties are already generated so none are
+   * generated on threaded const-access.
+   */
+  molecule_.graph().inner().populateProperties();
+#endif
+
+  DecisionMatrix decisions(F, B);
+
+  // Exceptions cannot propagate out of the parallel region
+  std::exception_ptr exception;
+  bool aborted = false;
+
+#pragma omp parallel
+  {
+    // Working copies and buffers are thread-private and reused across frames
+    std::vector<AtomStereopermutator> refittedAtoms = Temple::map(
+      fitAtoms,
+      [&](const AtomIndex i) { return stereopermutators.at(i); }
+    );
+    std::vector<BondStereopermutator> refittedBonds = Temple::map(
+      relevantBonds_,
+      [&](const BondIndex& bond) { return stereopermutators.at(bond); }
+    );
+    std::vector<AtomStereopermutator::ShapeMap> shapeMaps;
+    shapeMaps.reserve(fitAtoms.size());
+    AngstromPositions angstromPositions(N);
+
+#pragma omp for schedule(static)
+    for(unsigned f = 0; f < F; ++f) {
+      bool skip;
+#pragma omp atomic read
+      skip = aborted;
+      if(skip) {
+        continue;
+      }
+
+      try {
+        angstromPositions.positions = frames.middleRows(f * N, N) * Utils::Constants::angstrom_per_bohr;
+
+        shapeMaps.clear();
+        for(unsigned i = 0; i < fitAtoms.size(); ++i) {
+          shapeMaps.push_back(
+            refit_(refittedAtoms[i], stereopermutators.at(fitAtoms[i]), angstromPositions)
+          );
+        }
+
+        for(unsigned b = 0; b < B; ++b) {
+          const std::pair<BondStereopermutator::FittingReferences, BondStereopermutator::FittingReferences> fittingReferences {
+            {stereopermutators.at(fitAtoms[bondFitAtoms[b].first]), shapeMaps[bondFitAtoms[b].first]},
+            {stereopermutators.at(fitAtoms[bondFitAtoms[b].second]), shapeMaps[bondFitAtoms[b].second]}
+          };
+          refittedBonds[b].fit(angstromPositions, fittingReferences, fitting);
+          decisions(f, b) = refittedBonds[b].assigned().value_or(unknownDecision);
+        }
+      } catch(...) {
+#pragma omp critical(decisionListsException)
+        {
+          if(!exception) {
+            exception = std::current_exception();
+          }
+        }
+#pragma omp atomic write
+        aborted = true;
+      }
+    }
+  }
+
+  if(exception) {
+    std::rethrow_exception(exception);
+  }
+
+  return decisions;
+}
+
 void DirectedConformerGenerator::Impl::enumerate(
   std::function<void(const DecisionList&, Utils::PositionCollection)> callback,
   const unsigned seed,
   const EnumerationSettings& settings
 ) {
   clear();
-  const unsigned size = idealEnsembleSize();
+  enumerationSeed_ = seed;
+  enumerateRemaining_(callback, settings);
+}
+
+void DirectedConformerGenerator::Impl::enumerateRemaining_(
+  const std::function<void(const DecisionList&, Utils::PositionCollection)>& callback,
+  const EnumerationSettings& settings
+) {
+  if(relevantBonds_.empty()) {
+    return;
+  }
 
-#pragma omp parallel for
-  for(unsigned increment = 0; increment < size; ++increment) {
-    Random::Engine localEngine(seed + increment);
+  // Decision lists finished before are skipped
+  Temple::BoundedNodeTrie<std::uint8_t> finished {decisionLists_.bounds()};
+  finished.setStructure(decisionLists_.structure());
 
+  /* Drawing from a single trie would serialize all threads. Instead, the
+   * decision list space is split into shards by leading decisions, each with
+   * its own trie, and each shard is drawn from by a single thread.
+   */
+  constexpr unsigned minShards = 64;
+  auto shards = Detail::shardDecisionLists(
+    decisionLists_.bounds(),
+    enumerationSeed_,
+    minShards
+  );
+  const unsigned shardCount = shards.size();
+
+  /* Results are passed through a lock-free queue. Whichever thread manages to
+   * acquire the draining flag becomes the single consumer until the queue is
+   * empty, so that producers never wait on the callback.
+   */
+  struct Result {
     DecisionList decisionList;
-#pragma omp critical(decisionSetAccess)
-    {
-      decisionList = generateNewDecisionList(localEngine);
+    boost::optional<Utils::PositionCollection> conformer;
+  };
+  boost::lockfree::queue<Result*> results(128);
+  std::atomic_flag draining = ATOMIC_FLAG_INIT;
+
+  const auto consume = [&]() {
+    Result* resultPtr;
+    while(results.pop(resultPtr)) {
+      const std::unique_ptr<Result> result {resultPtr};
+      decisionLists_.insert(result->decisionList);
+      if(result->conformer) {
+        callback(result->decisionList, std::move(result->conformer.value()));
+      }
     }
+  };
 
-    for(unsigned i = 0; i < settings.dihedralRetries; ++i) {
-      outcome::result<Utils::PositionCollection> conformer {DgError::DecisionListMismatch};
+  const auto tryConsume = [&]() {
+    if(!draining.test_and_set(std::memory_order_acquire)) {
+      consume();
+      draining.clear(std::memory_order_release);
+    }
+  };
 
-      try {
-        conformer = generateConformation(
-          decisionList,
-          localEngine(),
-          settings.configuration,
-          settings.fitting
-        );
-      } catch(...) {}
+#pragma omp parallel for schedule(dynamic)
+  for(unsigned s = 0; s < shardCount; ++s) {
+    Detail::DecisionListShard& shard = shards[s];
+    const unsigned shardSize = shard.capacity();
+    for(unsigned i = 0; i < shardSize; ++i) {
+      auto result = std::make_unique<Result>();
+      result->decisionList = shard.generateNewDecisionList();
+      Random::Engine conformerEngine(shard.engine());
 
-      if(conformer) {
-#pragma omp critical(guardCallback)
-        {
-          callback(decisionList, conformer.value());
-        }
-        break;
+      if(finished.contains(result->decisionList)) {
+        continue;
       }
 
-      if(conformer.error() != DgError::DecisionListMismatch) {
-        /* Only allow decision list failure retries for retries, break on
-         * anything else
-         */
-        break;
+      for(unsigned j = 0; j < settings.dihedralRetries; ++j) {
+        outcome::result<Utils::PositionCollection> conformer {DgError::DecisionListMismatch};
+
+        try {
+          conformer = generateConformation(
+            result->decisionList,
+            conformerEngine(),
+            settings.configuration,
+            settings.fitting
+          );
+        } catch(...) {}
+
+        if(conformer) {
+          result->conformer = std::move(conformer.value());
+          break;
+        }
+
+        if(conformer.error() != DgError::DecisionListMismatch) {
+          /* Only allow decision list failure retries for retries, break on
+           * anything else
+           */
+          break;
+        }
       }
+
+      results.push(result.release());
+      tryConsume();
+    }
+  }
+
+  // Drain anything pushed after the last consumer finished
+  consume();
+}
+
+DirectedConformerGenerator::Checkpoint
+DirectedConformerGenerator::Impl::checkpoint() const {
+  const auto structure = decisionLists_.structure();
+  std::vector<std::uint8_t> blocks;
+  blocks.reserve(structure.num_blocks());
+  boost::to_block_range(structure, std::back_inserter(blocks));
+
+  nlohmann::json checkpoint;
+  checkpoint["b"] = Temple::map(
+    relevantBonds_,
+    [](const BondIndex& bond) -> std::vector<AtomIndex> {
+      return {bond.first, bond.second};
     }
+  );
+  checkpoint["s"] = enumerationSeed_;
+  checkpoint["n"] = structure.size();
+  checkpoint["t"] = nlohmann::json::binary(std::move(blocks));
+
+  return nlohmann::json::to_cbor(checkpoint);
+}
+
+void DirectedConformerGenerator::Impl::resumeEnumeration(
+  const Checkpoint& checkpoint,
+  std::function<void(const DecisionList&, Utils::PositionCollection)> callback,
+  const EnumerationSettings& settings
+) {
+  using Structure = Temple::BoundedNodeTrie<std::uint8_t>::Structure;
+
+  std::vector<std::vector<AtomIndex>> bonds;
+  unsigned seed;
+  Structure structure;
+  try {
+    const auto json = nlohmann::json::from_cbor(checkpoint);
+    bonds = json.at("b").get<std::vector<std::vector<AtomIndex>>>();
+    seed = json.at("s").get<unsigned>();
+    const auto structureSize = json.at("n").get<std::size_t>();
+    const auto& blocks = json.at("t").get_binary();
+    if(blocks.size() != (structureSize + 7) / 8) {
+      throw std::invalid_argument("Checkpoint trie structure has wrong length");
+    }
+    structure = Structure(std::begin(blocks), std::end(blocks));
+    structure.resize(structureSize);
+  } catch(const nlohmann::json::exception& e) {
+    throw std::invalid_argument(std::string("Malformed checkpoint: ") + e.what());
+  }
+
+  const bool bondsMatch = (
+    bonds.size() == relevantBonds_.size()
+    && Temple::all_of(
+      Temple::Adaptors::zip(bonds, relevantBonds_),
+      [](const std::vector<AtomIndex>& pair, const BondIndex& bond) -> bool {
+        return pair.size() == 2 && BondIndex {pair.front(), pair.back()} == bond;
+      }
+    )
+  );
+  if(!bondsMatch) {
+    throw std::invalid_argument("Checkpoint was made for different considered bonds");
+  }
+
+  clear();
+  if(!relevantBonds_.empty()) {
+    decisionLists_.setStructure(structure);
   }
+  enumerationSeed_ = seed;
+  enumerateRemaining_(callback, settings);
 }
 
 DirectedConformerGenerator::Relabeler DirectedConformerGenerator::Impl::relabeler() const {
   return Relabeler(relevantBonds_, molecule_);
 }
 
+DirectedConformerGenerator::StreamingRelabeler
+DirectedConformerGenerator::Impl::streamingRelabeler(const unsigned resolution) const {
+  return StreamingRelabeler(relevantBonds_, molecule_, resolution);
+}
+
 std::vector<int>
 DirectedConformerGenerator::Impl::binMidpointIntegers(
   const DecisionList& decisions
@@ -15,6 +15,9 @@
 
 namespace Scine {
 namespace Molassembler {
+namespace DistanceGeometry {
+struct MoleculeDGInformation;
+} // namespace DistanceGeometry
 
 class DirectedConformerGenerator::Impl {
 public:
@@ -95,6 +98,11 @@ public:
     BondStereopermutator::FittingMode fitting
   ) const;
 
+  DecisionMatrix getDecisionLists(
+    const Utils::PositionCollection& frames,
+    BondStereopermutator::FittingMode fitting
+  ) const;
+
   Molecule conformationMolecule(const DecisionList& decisionList) const;
 
   void enumerate(
@@ -103,11 +111,80 @@ public:
     const EnumerationSettings& settings
   );
 
+  Checkpoint checkpoint() const;
+
+  void resumeEnumeration(
+    const Checkpoint& checkpoint,
+    std::function<void(const DecisionList&, Utils::PositionCollection)> callback,
+    const EnumerationSettings& settings
+  );
+
   Relabeler relabeler() const;
 
+  StreamingRelabeler streamingRelabeler(unsigned resolution) const;
+
   std::vector<int> binMidpointIntegers(const DecisionList& decision) const;
 
 private:
+  //! Spatial model data independent of the decision list
+  struct InvariantModel {
+    //! Loosening multiplier the data was modeled with
+    double loosening;
+    //! Shared data, null if the molecule cannot be modeled this way
+    std::shared_ptr<const DistanceGeometry::MoleculeDGInformation> dataPtr;
+  };
+
+  /*! @brief Fetches the spatial model data shared by all decision lists
+   *
+   * Models the molecule without the dihedral information of the relevant
+   * bonds, smoothing its bounds once. Modeled data is kept until a
+   * configuration with a different loosening multiplier is supplied.
+   * Configurations with fixed positions neither use nor replace it.
+   * Thread-safe.
+   *
+   * @returns Null if the data would depend on more than the decision list,
+   *   i.e. if there are fixed positions or unassigned stereopermutators other
+   *   than on relevant bonds, or if the modeled bounds are contradictory
+   */
+  std::shared_ptr<const DistanceGeometry::MoleculeDGInformation> invariantModel(
+    const DistanceGeometry::Configuration& configuration
+  ) const;
+
+  /*! @brief Generates a conformation by adding only the decision list's
+   *   dihedral constraints to the invariant spatial model data
+   */
+  outcome::result<Utils::PositionCollection> generateFromInvariantModel(
+    const DistanceGeometry::MoleculeDGInformation& invariantData,
+    const DecisionList& decisionList,
+    Random::Engine& engine,
+    const DistanceGeometry::Configuration& configuration
+  ) const;
+
+  //! @throws std::logic_error If any relevant bond lacks stereopermutators
+  void checkDecisionListPreconditions_() const;
+
+  /*! @brief Refits a copy of an atom stereopermutator to positions
+   *
+   * @throws std::logic_error If the shape or assignment of @p refitted
+   *   differs from @p stereopermutator after fitting
+   */
+  AtomStereopermutator::ShapeMap refit_(
+    AtomStereopermutator& refitted,
+    const AtomStereopermutator& stereopermutator,
+    const AngstromPositions& angstromPositions
+  ) const;
+
+  /*! @brief Enumerates conformers of all decision lists not yet in the trie
+   *
+   * Decision lists and conformer seeds are drawn independently of which
+   * decision lists are skipped, so that resumed enumerations yield the same
+   * conformers as uninterrupted ones.
+   */
+  void enumerateRemaining_(
+    const std::function<void(const DecisionList&, Utils::PositionCollection)>& callback,
+    const EnumerationSettings& settings
+  );
+
   Molecule molecule_;
   BondStereopermutator::Alignment alignment_;
   BondList relevantBonds_;
@@ -132,6 +209,11 @@ private:
    * is most different from the ones you already have.
    */
   Temple::BoundedNodeTrie<std::uint8_t> decisionLists_;
+
+  mutable boost::optional<InvariantModel> invariantModel_;
+
+  //! Seed of the last started enumeration
+  unsigned enumerationSeed_ = 0;
 };
 
 } // namespace Molassembler
@@ -20,6 +20,7 @@ namespace DistanceGeometry {
 
 constexpr double DistanceBoundsMatrix::defaultLower;
 constexpr double DistanceBoundsMatrix::defaultUpper;
+constexpr unsigned DistanceBoundsMatrix::smoothingBlockSize;
 
 DistanceBoundsMatrix::DistanceBoundsMatrix() = default;
 
@@ -56,56 +57,128 @@ bool DistanceBoundsMatrix::setLowerBound(const AtomIndex i, const AtomIndex j, c
 }
 
 void DistanceBoundsMatrix::smooth(Eigen::Ref<Eigen::MatrixXd> matrix) {
-  /* Floyd's algorithm: O(N³) */
+  /* Blocked Floyd's algorithm: O(N³)
+   *
+   * Upper and lower bounds are separated into symmetric matrices so that all
+   * accesses in the innermost loop are contiguous and branch-free. Pivots are
+   * processed in blocks. For each pivot block K, the diagonal tile (K, K) is
+   * relaxed first, then the tiles of block column K, and finally all
+   * remaining tiles. Tiles within the latter two phases are independent.
+   *
+   * Only tiles (I, J) with I >= J are kept up to date, except for block
+   * column K, which is completed by mirroring block row K before each pivot
+   * block and mirrored back afterwards.
+   */
   const unsigned N = matrix.cols();
+  if(N == 0) {
+    return;
+  }
 
-  for(AtomIndex k = 0; k < N; ++k) {
-    for(AtomIndex i = 0; i < N - 1; ++i) {
-      /* Single-branch references to lower and upper ik parts */
-      auto upperLowerIK = (i < k
-        ? std::pair<double&, double&>(matrix(i, k), matrix(k, i))
-        : std::pair<double&, double&>(matrix(k, i), matrix(i, k))
-      );
-      double& upperIK = upperLowerIK.first;
-      double& lowerIK = upperLowerIK.second;
-
-      if(lowerIK > upperIK) {
-        throw std::runtime_error("Triangle smoothing encountered bound inversion");
+  Eigen::MatrixXd upper(N, N);
+  Eigen::MatrixXd lower(N, N);
+  for(unsigned j = 0; j < N; ++j) {
+    for(unsigned i = 0; i < N; ++i) {
+      upper(i, j) = (i < j) ? matrix(i, j) : matrix(j, i);
+      lower(i, j) = (i < j) ? matrix(j, i) : matrix(i, j);
+    }
+  }
+  upper.diagonal().setZero();
+  lower.diagonal().setZero();
+
+  const unsigned blockCount = (N + smoothingBlockSize - 1) / smoothingBlockSize;
+  auto blockBegin = [](const unsigned block) -> unsigned {
+    return block * smoothingBlockSize;
+  };
+  auto blockEnd = [N](const unsigned block) -> unsigned {
+    return std::min(N, (block + 1) * smoothingBlockSize);
+  };
+
+  /* Relax the bounds of pairs in tile (I, J) through all pivots in block K.
+   * Reads tiles (I, K) and (J, K), which must be up to date.
+   */
+  auto relaxTile = [&](const unsigned I, const unsigned J, const unsigned K) {
+    const unsigned iBegin = blockBegin(I);
+    const unsigned iEnd = blockEnd(I);
+    for(unsigned k = blockBegin(K); k < blockEnd(K); ++k) {
+      const double* const upperK = upper.col(k).data();
+      const double* const lowerK = lower.col(k).data();
+
+      for(unsigned j = blockBegin(J); j < blockEnd(J); ++j) {
+        const double upperKJ = upperK[j];
+        const double lowerKJ = lowerK[j];
+        double* const upperJ = upper.col(j).data();
+        double* const lowerJ = lower.col(j).data();
+
+        // Ternaries instead of std::min and std::max enable vectorization
+#pragma omp simd
+        for(unsigned i = iBegin; i < iEnd; ++i) {
+          const double upperPath = upperK[i] + upperKJ;
+          const double lowerPath = std::max(lowerK[i] - upperKJ, lowerKJ - upperK[i]);
+          upperJ[i] = upperPath < upperJ[i] ? upperPath : upperJ[i];
+          lowerJ[i] = lowerPath > lowerJ[i] ? lowerPath : lowerJ[i];
+        }
+      }
+    }
+  };
+
+  // Copy tile (I, J) into tile (J, I)
+  auto mirrorTile = [&](const unsigned I, const unsigned J) {
+    for(unsigned j = blockBegin(J); j < blockEnd(J); ++j) {
+      for(unsigned i = blockBegin(I); i < blockEnd(I); ++i) {
+        upper(j, i) = upper(i, j);
+        lower(j, i) = lower(i, j);
       }
+    }
+  };
+
+#pragma omp parallel
+  {
+    for(unsigned K = 0; K < blockCount; ++K) {
+#pragma omp for schedule(static)
+      for(unsigned J = 0; J < K; ++J) {
+        mirrorTile(K, J);
+      }
+
+#pragma omp single
+      relaxTile(K, K, K);
 
-      for(AtomIndex j = i + 1; j < N; ++j) {
-        /* i < j is known, so lower(matrix, i, j) is always matrix(j, i),
-         * and upper(matrix, i, j) always matrix(i, j)
-         */
-        double& upperIJ = matrix(i, j);
-        double& lowerIJ = matrix(j, i);
-
-        /* Single-branch references to lower and upper jk parts */
-        auto upperLowerJK = (j < k
-          ? std::pair<double&, double&>(matrix(j, k), matrix(k, j))
-          : std::pair<double&, double&>(matrix(k, j), matrix(j, k))
-        );
-        double& upperJK = upperLowerJK.first;
-        double& lowerJK = upperLowerJK.second;
-
-        /* Actual algorithm */
-        if(upperIJ > upperIK + upperJK) {
-          upperIJ = upperIK + upperJK;
+#pragma omp for schedule(static)
+      for(unsigned B = 0; B < blockCount; ++B) {
+        if(B != K) {
+          relaxTile(B, K, K);
+          if(B < K) {
+            mirrorTile(B, K);
+          }
         }
+      }
 
-        if(lowerIJ < lowerIK - upperJK) {
-          lowerIJ = lowerIK - upperJK;
-        } else if(lowerIJ < lowerJK - upperIK) {
-          lowerIJ = lowerJK - upperIK;
+#pragma omp for schedule(dynamic)
+      for(unsigned I = 0; I < blockCount; ++I) {
+        if(I == K) {
+          continue;
         }
 
-        // Safety
-        if(lowerIJ > upperIJ) {
-          throw std::runtime_error("Triangle smoothing encountered bound inversion");
+        for(unsigned J = 0; J <= I; ++J) {
+          if(J != K) {
+            relaxTile(I, J, K);
+          }
         }
       }
     }
   }
+
+  // Bound inversions can only arise from contradictory bounds
+  if((lower.array() > upper.array()).any()) {
+    throw std::runtime_error("Triangle smoothing encountered bound inversion");
+  }
+
+  for(unsigned j = 0; j < N; ++j) {
+    for(unsigned i = 0; i < j; ++i) {
+      const bool upToDate = (i / smoothingBlockSize >= j / smoothingBlockSize);
+      matrix(i, j) = upToDate ? upper(i, j) : upper(j, i);
+      matrix(j, i) = upToDate ? lower(i, j) : lower(j, i);
+    }
+  }
 }
 
 void DistanceBoundsMatrix::smooth() {
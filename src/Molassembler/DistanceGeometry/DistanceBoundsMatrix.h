@@ -29,6 +29,8 @@ class DistanceBoundsMatrix {
 public:
   static constexpr double defaultLower = 0.0;
   static constexpr double defaultUpper = 100.0;
+  //! Number of atoms per tile in Floyd's algorithm
+  static constexpr unsigned smoothingBlockSize = 64;
 
 //!@name Static member functions
 //!@{
@@ -49,6 +51,11 @@ public:
   }
 
   /*! @brief Uses Floyd's algorithm to smooth the matrix
+   *
+   * Processes pivots in blocks of smoothingBlockSize atoms for cache
+   * locality. Independent tiles of each block are processed in parallel.
+   *
+   * @throws std::runtime_error If the bounds are contradictory
    *
    * @complexity{@math{\Theta(N^3)}}
    */
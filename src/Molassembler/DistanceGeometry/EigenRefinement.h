@@ -12,6 +12,8 @@
 
 #include "Molassembler/DistanceGeometry/DistanceBoundsMatrix.h"
 
+#include <algorithm>
+
 namespace Scine {
 namespace Molassembler {
 namespace DistanceGeometry {
@@ -153,9 +155,15 @@ public:
 
 //!@name Public members
 //!@{
-  //! Upper distance bounds squared, linearized in i < j
+  /*! @brief Upper distance bounds squared, linearized in i < j
+   *
+   * Empty if constructed from a DistanceBoundsMatrix without SIMD
+   */
   VectorType upperDistanceBoundsSquared;
-  //! Lower distance bounds squared, linearized in i < j
+  /*! @brief Lower distance bounds squared, linearized in i < j
+   *
+   * Empty if constructed from a DistanceBoundsMatrix without SIMD
+   */
   VectorType lowerDistanceBoundsSquared;
   //! Chiral upper constraints, in sequence of @p chiralConstraints
   VectorType chiralUpperConstraints;
@@ -173,6 +181,28 @@ public:
   bool compressFourthDimension = false;
   //! Whether to enable dihedral terms
   bool dihedralTerms = false;
+  /*! @brief Whether to skip distance terms that cannot contribute
+   *
+   * Atom pairs whose distance lies within their bounds by at least
+   * @p pruningSkin are excluded from an active pair list that is rebuilt
+   * whenever any atom has moved by more than half of @p pruningSkin since the
+   * last rebuild. Until then, skipped pairs cannot leave their bounds, so
+   * values and gradients are exactly those without pruning.
+   *
+   * @note Only affects the non-SIMD distance contributions
+   */
+  bool pruneDistanceTerms = true;
+  //! Margin within distance bounds for pairs to be skipped
+  FloatType pruningSkin = 1.0;
+  /*! @brief Atoms whose positions are constant, indexed by atom
+   *
+   * If non-empty, distance terms between pairs of fixed atoms are constant
+   * and are excluded from the active pair list, so that rebuilding it scales
+   * with the number of pairs involving a free atom.
+   *
+   * @note Only affects distance contributions with @p pruneDistanceTerms
+   */
+  std::vector<bool> fixedAtoms;
 //!@}
 
 //!@name Signaling members
@@ -182,6 +212,11 @@ public:
 
 //!@name Constructors
 //!@{
+  /*! @brief Constructs from squared distance bounds
+   *
+   * @param squaredBounds Squared upper bounds in the strict upper triangle,
+   *   squared lower bounds in the strict lower triangle. Copied.
+   */
   EigenRefinementProblem(
     const Eigen::MatrixXd& squaredBounds,
     std::vector<ChiralConstraint> passChiralConstraints,
@@ -189,7 +224,42 @@ public:
   ) : chiralConstraints(std::move(passChiralConstraints)),
       dihedralConstraints(std::move(passDihedralConstraints))
   {
-    const unsigned N = squaredBounds.cols();
+    linearizeSquaredBounds_(squaredBounds.cols(), squaredBounds);
+    vectorizeConstraints_();
+  }
+
+  /*! @brief Constructs from smoothed distance bounds
+   *
+   * Without SIMD, the bounds are squared on access instead of being copied,
+   * so that refining many conformers of a large molecule does not need a
+   * dense copy of the bounds for each. @p bounds must then outlive the
+   * problem.
+   */
+  EigenRefinementProblem(
+    const DistanceBoundsMatrix& bounds,
+    std::vector<ChiralConstraint> passChiralConstraints,
+    std::vector<DihedralConstraint> passDihedralConstraints
+  ) : chiralConstraints(std::move(passChiralConstraints)),
+      dihedralConstraints(std::move(passDihedralConstraints))
+  {
+    if(SIMD) {
+      linearizeSquaredBounds_(
+        bounds.N(),
+        bounds.access().cwiseProduct(bounds.access())
+      );
+    } else {
+      boundsPtr_ = &bounds.access();
+    }
+    vectorizeConstraints_();
+  }
+//!@}
+
+private:
+  template<typename Derived>
+  void linearizeSquaredBounds_(
+    const unsigned N,
+    const Eigen::MatrixBase<Derived>& squaredBounds
+  ) {
     const unsigned strictlyUpperTriangularElements = N * (N - 1) / 2;
 
     // Lineize upper distance bounds squared
@@ -202,6 +272,12 @@ public:
       }
     }
 
+    if(SIMD) {
+      inverseUpperDistanceBoundsSquared_ = upperDistanceBoundsSquared.cwiseInverse();
+    }
+  }
+
+  void vectorizeConstraints_() {
     // Vectorize chiral constraint bounds
     const unsigned C = chiralConstraints.size();
     chiralUpperConstraints.resize(C);
@@ -222,19 +298,31 @@ public:
       dihedralConstraintDiffsHalved(i) = (constraint.upper - constraint.lower) / 2;
     }
   }
-//!@}
 
+public:
 //!@name Contribution functions
 //!@{
   /*! @brief Adds pairwise distance error and gradient contributions
    *
-   * @complexity{@math{\Omega(N^2)}}
+   * @complexity{@math{\Omega(N^2)} without pruning. With pruning,
+   * @math{\Theta(N + A)} where @math{A} is the number of active pairs, plus
+   * @math{\Theta(N^2)} if the active pair list is rebuilt}
    */
   void distanceContributions(
     const VectorType& positions,
     FloatType& error,
     Eigen::Ref<VectorType> gradient
   ) const {
+    if(pruneDistanceTerms && !SIMD) {
+      assert(positions.size() == gradient.size());
+      updateActivePairs(positions);
+      DefaultTermVisitor visitor;
+      for(const ActivePair& pair : activePairs_) {
+        distancePairContribution(positions, pair.i, pair.j, pair.linearIndex, error, gradient, visitor);
+      }
+      return;
+    }
+
     // Delegate to SIMD or non-SIMD implementation
     distanceContributionsImpl(positions, error, gradient, DefaultTermVisitor {});
   }
@@ -295,6 +383,44 @@ public:
     chiralContributions(parameters, value, gradient);
   }
 
+  /*!
+   * @brief Calculates the product of the error function hessian with a vector
+   *
+   * Distance, chiral and fourth dimension terms contribute their exact
+   * hessians. Dihedral terms contribute their Gauss-Newton approximation,
+   * which omits the second derivatives of the dihedral angle.
+   *
+   * @param[in] parameters The linearized positions of all particles
+   * @param[in] direction The vector to multiply the hessian with
+   * @param[out] product The hessian-vector product
+   *
+   * @complexity{@math{\Theta(N^2 + C + D)} without pruning, @math{\Theta(N + A
+   * + C + D)} with pruning and no rebuild of the active pair list}
+   */
+  void hessianVectorProduct(
+    const VectorType& parameters,
+    const VectorType& direction,
+    Eigen::Ref<VectorType> product
+  ) const {
+    assert(parameters.size() == direction.size());
+    assert(parameters.size() == product.size());
+
+    product.setZero();
+
+    if(dimensionality == 4 && compressFourthDimension) {
+      const unsigned N = parameters.size() / dimensionality;
+      for(unsigned i = 0; i < N; ++i) {
+        product(4 * i + 3) += 2 * direction(4 * i + 3);
+      }
+    }
+
+    distanceHessianProduct(parameters, direction, product);
+    chiralHessianProduct(parameters, direction, product);
+    if(dihedralTerms) {
+      dihedralHessianProduct(parameters, direction, product);
+    }
+  }
+
   /*! @brief Calculates the number of chiral constraints with correct sign
    *
    * @complexity{@math{\Theta(C)} where @math{C} is the number of chiral
@@ -495,202 +621,267 @@ private:
 
     for(unsigned linearIndex = 0, i = 0; i < N - 1; ++i) {
       for(unsigned j = i + 1; j < N; ++j, ++linearIndex) {
-        const FloatType lowerBoundSquared = lowerDistanceBoundsSquared(linearIndex);
-        const FloatType upperBoundSquared = upperDistanceBoundsSquared(linearIndex);
-        assert(lowerBoundSquared <= upperBoundSquared);
-
-        // For both
-        const FullDimensionalVector positionDifference = (
-          positions.template segment<dimensionality>(dimensionality * i)
-          - positions.template segment<dimensionality>(dimensionality * j)
-        );
-
-        const FloatType squareDistance = positionDifference.squaredNorm();
-
-        // Upper term
-        const FloatType upperTerm = squareDistance / upperBoundSquared - 1;
-
-        if(upperTerm > 0) {
-          const FloatType value = upperTerm * upperTerm;
-          error += value;
-          visitor.distanceTerm(i, j, value);
-
-          const FullDimensionalVector f = 4 * positionDifference * upperTerm / upperBoundSquared;
-
-          gradient.template segment<dimensionality>(dimensionality * i) += f;
-          gradient.template segment<dimensionality>(dimensionality * j) -= f;
-        } else {
-          // Lower term is only possible if the upper term does not contribute
-          const FloatType quotient = lowerBoundSquared + squareDistance;
-          const FloatType lowerTerm = 2 * lowerBoundSquared / quotient - 1;
-
-          if(lowerTerm > 0) {
-            const FloatType value = lowerTerm * lowerTerm;
-            error += value;
-            visitor.distanceTerm(i, j, value);
-
-            const FullDimensionalVector g = 8 * lowerBoundSquared * positionDifference * lowerTerm / (
-              quotient * quotient
-            );
-
-            /* We use -= because the lower term needs the position vector
-             * difference (j - i), so we reuse positionDifference and just subtract
-             * from the gradient instead of adding to it
-             */
-            gradient.template segment<dimensionality>(dimensionality * i) -= g;
-            gradient.template segment<dimensionality>(dimensionality * j) += g;
-          } else {
-            visitor.distanceTerm(i, j, 0.0);
-          }
-        }
+        distancePairContribution(positions, i, j, linearIndex, error, gradient, visitor);
       }
     }
   }
 
-  /*!
-   * @brief SIMD implementation of distance contributions
-   */
-  template<class Visitor, bool dependent = SIMD, std::enable_if_t<dependent, int>...>
-  void distanceContributionsImpl(
+  //! Adds distance error and gradient contributions of a single atom pair
+  template<class Visitor>
+  void distancePairContribution(
     const VectorType& positions,
+    const unsigned i,
+    const unsigned j,
+    const unsigned linearIndex,
     FloatType& error,
     Eigen::Ref<VectorType> gradient,
-    Visitor&& /* visitor */
+    Visitor&& visitor
   ) const {
-    assert(positions.size() == gradient.size());
-    /* Using the squared distance bounds to avoid unneeded square-root calculations
-     *
-     * NOTE: positions are full-dimensional
-     *
-     * for each nonredundant pair of atoms (i < j)
-     *   Calculate a squared vector distance:
-     *   sq_distance = (position[j] - position[i]).array().square().sum()
-     *
-     *   upper_term = (sq_distance / upperBoundSquared) - 1
-     *
-     *   if upper_term > 0:
-     *     error += upper_term.square()
-     *
-     *   lower_term = (
-     *    2 * lowerBoundSquared / (lowerBoundSquared + sq_distance)
-     *   ) - 1
-     *
-     *   if lowerTerm > 0:
-     *     error += lower_term.square()
-     *
-     * SIMDize:
-     *   sq_distances = list of upper triangular square distance terms
-     *   upper_bounds_sq = list of corresponding upper bounds (identical across runs, no need to gather multiple times)
-     *   lower_bounds_sq = list of corresponding lower bounds (same as above)
-     *
-     *   upper_terms = (sq_distances / upper_bounds_sq) - 1
-     *   error += upper_terms.max(0.0).square().sum()
-     *
-     *   lower_terms = (2 * lower_bounds_sq / (lower_bounds_sq + sq_distances)) - 1
-     *   error += lower_terms.max(0.0).square().sum()
-     *
-     */
+    const FloatType lowerBoundSquared = lowerBoundSquared_(i, j, linearIndex);
+    const FloatType upperBoundSquared = upperBoundSquared_(i, j, linearIndex);
+    assert(lowerBoundSquared <= upperBoundSquared);
 
-    // Calculate all full-dimensional N(N-1) / 2 position differences
-    const unsigned N = positions.size() / dimensionality;
-    const unsigned differencesCount = N * (N - 1) / 2;
+    // For both
+    const FullDimensionalVector positionDifference = (
+      positions.template segment<dimensionality>(dimensionality * i)
+      - positions.template segment<dimensionality>(dimensionality * j)
+    );
 
-    FullDimensionalMatrixType positionDifferences(dimensionality, differencesCount);
-    {
-      unsigned offset = 0;
-      for(unsigned i = 0; i < N - 1; ++i) {
-        auto iPosition = positions.template segment<dimensionality>(dimensionality * i);
-        for(unsigned j = i + 1; j < N; ++j) {
-          positionDifferences.col(offset) = (
-            iPosition
-            - positions.template segment<dimensionality>(dimensionality * j)
-          );
-          ++offset;
-        }
+    const FloatType squareDistance = positionDifference.squaredNorm();
+
+    // Upper term
+    const FloatType upperTerm = squareDistance / upperBoundSquared - 1;
+
+    if(upperTerm > 0) {
+      const FloatType value = upperTerm * upperTerm;
+      error += value;
+      visitor.distanceTerm(i, j, value);
+
+      const FullDimensionalVector f = 4 * positionDifference * upperTerm / upperBoundSquared;
+
+      gradient.template segment<dimensionality>(dimensionality * i) += f;
+      gradient.template segment<dimensionality>(dimensionality * j) -= f;
+    } else {
+      // Lower term is only possible if the upper term does not contribute
+      const FloatType quotient = lowerBoundSquared + squareDistance;
+      const FloatType lowerTerm = 2 * lowerBoundSquared / quotient - 1;
+
+      if(lowerTerm > 0) {
+        const FloatType value = lowerTerm * lowerTerm;
+        error += value;
+        visitor.distanceTerm(i, j, value);
+
+        const FullDimensionalVector g = 8 * lowerBoundSquared * positionDifference * lowerTerm / (
+          quotient * quotient
+        );
+
+        /* We use -= because the lower term needs the position vector
+         * difference (j - i), so we reuse positionDifference and just subtract
+         * from the gradient instead of adding to it
+         */
+        gradient.template segment<dimensionality>(dimensionality * i) -= g;
+        gradient.template segment<dimensionality>(dimensionality * j) += g;
+      } else {
+        visitor.distanceTerm(i, j, 0.0);
       }
     }
+  }
 
-    // SIMD
-    const VectorType squareDistances = positionDifferences.colwise().squaredNorm();
-
-    // SIMD
-    const VectorType upperTerms = squareDistances.array() / upperDistanceBoundsSquared.array() - 1;
+  /*! @brief Rebuilds the active pair list if any atom moved too far
+   *
+   * @complexity{@math{\Theta(N)} if no rebuild is necessary,
+   * @math{\Theta(N^2)} otherwise, or @math{\Theta(NF)} for @math{F} free
+   * atoms if some atoms are fixed}
+   */
+  void updateActivePairs(const VectorType& positions) const {
+    const unsigned N = positions.size() / dimensionality;
 
-#ifndef NDEBUG
-    {
-      // Check correctness of results so far
-      unsigned offset = 0;
-      for(unsigned i = 0; i < N - 1; ++i) {
-        for(unsigned j = i + 1; j < N; ++j) {
-          const FullDimensionalVector positionDifference = (
+    if(pruningReferencePositions_.size() == positions.size()) {
+      FloatType maxSquaredDisplacement = 0;
+      for(unsigned i = 0; i < N; ++i) {
+        maxSquaredDisplacement = std::max(
+          maxSquaredDisplacement,
+          (
             positions.template segment<dimensionality>(dimensionality * i)
-            - positions.template segment<dimensionality>(dimensionality * j)
-          );
+            - pruningReferencePositions_.template segment<dimensionality>(dimensionality * i)
+          ).squaredNorm()
+        );
+      }
 
-          assert(positionDifferences.col(offset) == positionDifference);
+      // No pair distance can have changed by more than the skin
+      if(4 * maxSquaredDisplacement <= pruningSkin * pruningSkin) {
+        return;
+      }
+    }
 
-          const FloatType squareDistance = positionDifference.squaredNorm();
+    pruningReferencePositions_ = positions;
+    activePairs_.clear();
 
-          assert(squareDistance == squareDistances(offset));
+    auto addIfActive = [&](const unsigned i, const unsigned j, const unsigned linearIndex) {
+      const FloatType distance = (
+        positions.template segment<dimensionality>(dimensionality * i)
+        - positions.template segment<dimensionality>(dimensionality * j)
+      ).norm();
 
-          // Upper term
-          const FloatType upperTerm = squareDistance / upperDistanceBoundsSquared(offset) - 1;
+      const bool inactive = (
+        std::sqrt(lowerBoundSquared_(i, j, linearIndex)) + pruningSkin <= distance
+        && distance + pruningSkin <= std::sqrt(upperBoundSquared_(i, j, linearIndex))
+      );
 
-          assert(upperTerm == upperTerms(offset));
+      if(!inactive) {
+        activePairs_.push_back(ActivePair {i, j, linearIndex});
+      }
+    };
 
-          ++offset;
+    if(fixedAtoms.empty()) {
+      for(unsigned linearIndex = 0, i = 0; i + 1 < N; ++i) {
+        for(unsigned j = i + 1; j < N; ++j, ++linearIndex) {
+          addIfActive(i, j, linearIndex);
         }
       }
+      return;
     }
-#endif
 
-    // Traverse upper terms and calculate gradients
-    for(unsigned iOffset = 0, i = 0; i < N - 1; ++i) {
-      const unsigned crossTerms = N - i - 1;
-      for(unsigned jOffset = 0, j = i + 1;  j < N; ++j, ++jOffset) {
-        const FloatType upperTerm = upperTerms(iOffset + jOffset);
-        if(upperTerm > 0) {
-          error += upperTerm * upperTerm;
-
-          /* This i-j combination has an upper value contribution
-           *
-           * calculate gradient and apply to i and j
-           */
-          const FullDimensionalVector f = (
-            4 * positionDifferences.col(iOffset + jOffset) * upperTerm
-            / upperDistanceBoundsSquared(iOffset + jOffset)
-          );
-
-          // position difference is i - j, not j - i (!)
-          gradient.template segment<dimensionality>(dimensionality * i) += f;
-          gradient.template segment<dimensionality>(dimensionality * j) -= f;
-        } else {
-          /* This i-j combination MAYBE has a lower value contribution
-           */
-          const auto& lowerBoundSquared = lowerDistanceBoundsSquared(iOffset + jOffset);
-          const FloatType quotient = lowerBoundSquared + squareDistances(iOffset + jOffset);
-          const FloatType lowerTerm = 2 * lowerBoundSquared / quotient - 1;
-
-          if(lowerTerm > 0) {
-            // Add it to the error
-            error += lowerTerm * lowerTerm;
-
-            // Calculate gradient and apply
-            const FullDimensionalVector g = (
-              8 * lowerBoundSquared * positionDifferences.col(iOffset + jOffset) * lowerTerm / (
-                quotient * quotient
-              )
-            );
-
-            // position difference is i - j, not j - i (!)
-            gradient.template segment<dimensionality>(dimensionality * i) -= g;
-            gradient.template segment<dimensionality>(dimensionality * j) += g;
-          }
+    // Pair fixed atoms only with free atoms of greater index
+    assert(fixedAtoms.size() == N);
+    std::vector<unsigned> freeAtoms;
+    for(unsigned i = 0; i < N; ++i) {
+      if(!fixedAtoms[i]) {
+        freeAtoms.push_back(i);
+      }
+    }
+
+    auto freeIter = std::begin(freeAtoms);
+    for(unsigned rowStart = 0, i = 0; i + 1 < N; rowStart += N - i - 1, ++i) {
+      if(fixedAtoms[i]) {
+        freeIter = std::upper_bound(freeIter, std::end(freeAtoms), i);
+        for(auto iter = freeIter; iter != std::end(freeAtoms); ++iter) {
+          addIfActive(i, *iter, rowStart + *iter - i - 1);
+        }
+      } else {
+        for(unsigned j = i + 1; j < N; ++j) {
+          addIfActive(i, j, rowStart + j - i - 1);
         }
       }
+    }
+  }
+
+  /*!
+   * @brief SIMD implementation of distance contributions
+   *
+   * Positions and gradients are transposed into a structure-of-arrays layout
+   * in which each coordinate is contiguous. The distance terms of an atom
+   * @math{i} with all atoms @math{j > i} then involve contiguous segments of
+   * each coordinate and of the linearized squared bounds, and are evaluated
+   * in a branch-free loop explicitly vectorized with OpenMP. The width of its
+   * vector lanes is that of the instruction set compiled for (e.g. SSE, AVX2
+   * or AVX-512 depending on -march).
+   *
+   * Branches are replaced by clamping, so both terms are calculated for all
+   * pairs.
+   */
+  template<class Visitor, bool dependent = SIMD, std::enable_if_t<dependent, int>...>
+  void distanceContributionsImpl(
+    const VectorType& positions,
+    FloatType& error,
+    Eigen::Ref<VectorType> gradient,
+    Visitor&& /* visitor */
+  ) const {
+    assert(positions.size() == gradient.size());
+    const unsigned N = positions.size() / dimensionality;
+
+    // Transpose the interleaved positions into structure-of-arrays layout
+    soaPositions_ = Eigen::Map<const FullDimensionalMatrixType>(
+      positions.data(),
+      dimensionality,
+      N
+    ).transpose().array();
+    soaGradient_.setZero(N, dimensionality);
+
+    /* The fourth coordinate is read from the third column in three dimensions,
+     * but its difference is then zeroed
+     */
+    constexpr unsigned w = dimensionality - 1;
+    constexpr FloatType wFactor = (dimensionality == 4) ? 1 : 0;
+
+    for(unsigned offset = 0, i = 0; i + 1 < N; ++i) {
+      const unsigned n = N - i - 1;
+
+      const FloatType* const x = soaPositions_.col(0).data() + i + 1;
+      const FloatType* const y = soaPositions_.col(1).data() + i + 1;
+      const FloatType* const z = soaPositions_.col(2).data() + i + 1;
+      const FloatType* const v = soaPositions_.col(w).data() + i + 1;
+      FloatType* const gx = soaGradient_.col(0).data() + i + 1;
+      FloatType* const gy = soaGradient_.col(1).data() + i + 1;
+      FloatType* const gz = soaGradient_.col(2).data() + i + 1;
+      FloatType* const gv = soaGradient_.col(w).data() + i + 1;
+      const FloatType* const lowerBoundsSquared = lowerDistanceBoundsSquared.data() + offset;
+      const FloatType* const inverseUpperBoundsSquared = inverseUpperDistanceBoundsSquared_.data() + offset;
+
+      const FloatType xi = soaPositions_(i, 0);
+      const FloatType yi = soaPositions_(i, 1);
+      const FloatType zi = soaPositions_(i, 2);
+      const FloatType vi = soaPositions_(i, w);
+
+      FloatType rowError = 0;
+      FloatType gxi = 0;
+      FloatType gyi = 0;
+      FloatType gzi = 0;
+      FloatType gvi = 0;
+
+#pragma omp simd reduction(+:rowError,gxi,gyi,gzi,gvi)
+      for(unsigned j = 0; j < n; ++j) {
+        // Position difference i - j
+        const FloatType dx = xi - x[j];
+        const FloatType dy = yi - y[j];
+        const FloatType dz = zi - z[j];
+        const FloatType dv = wFactor * (vi - v[j]);
+        const FloatType squareDistance = dx * dx + dy * dy + dz * dz + dv * dv;
+
+        const FloatType inverseQuotient = 1 / (lowerBoundsSquared[j] + squareDistance);
+
+        /* Since the lower bounds do not exceed the upper bounds, at most one
+         * of the terms can be positive, and clamping both replaces branching
+         */
+        const FloatType upperTerm = std::max(squareDistance * inverseUpperBoundsSquared[j] - 1, FloatType {0});
+        const FloatType lowerTerm = std::max(2 * lowerBoundsSquared[j] * inverseQuotient - 1, FloatType {0});
+
+        rowError += upperTerm * upperTerm + lowerTerm * lowerTerm;
+
+        /* Both gradient terms are scalar multiples of the position difference.
+         * The lower term's is negative since it needs the position difference
+         * j - i.
+         */
+        const FloatType coefficient = (
+          4 * upperTerm * inverseUpperBoundsSquared[j]
+          - 8 * lowerBoundsSquared[j] * lowerTerm * inverseQuotient * inverseQuotient
+        );
+
+        gxi += coefficient * dx;
+        gyi += coefficient * dy;
+        gzi += coefficient * dz;
+        gvi += coefficient * dv;
+        gx[j] -= coefficient * dx;
+        gy[j] -= coefficient * dy;
+        gz[j] -= coefficient * dz;
+        gv[j] -= coefficient * dv;
+      }
+
+      error += rowError;
+      soaGradient_(i, 0) += gxi;
+      soaGradient_(i, 1) += gyi;
+      soaGradient_(i, 2) += gzi;
+      soaGradient_(i, w) += gvi;
 
-      iOffset += crossTerms;
+      offset += n;
     }
+
+    // Transpose the gradient back into the interleaved layout
+    Eigen::Map<FullDimensionalMatrixType>(
+      gradient.data(),
+      dimensionality,
+      N
+    ) += soaGradient_.matrix().transpose();
   }
 
   /*!
@@ -974,6 +1165,299 @@ private:
     }
   }
 //!@}
+
+//!@name Hessian-vector product implementations
+//!@{
+  //! Adds the distance term hessian-vector product of a single atom pair
+  void distancePairHessianProduct(
+    const VectorType& positions,
+    const VectorType& direction,
+    const unsigned i,
+    const unsigned j,
+    const unsigned linearIndex,
+    Eigen::Ref<VectorType> product
+  ) const {
+    const FloatType lowerBoundSquared = lowerBoundSquared_(i, j, linearIndex);
+    const FloatType upperBoundSquared = upperBoundSquared_(i, j, linearIndex);
+
+    const FullDimensionalVector positionDifference = (
+      positions.template segment<dimensionality>(dimensionality * i)
+      - positions.template segment<dimensionality>(dimensionality * j)
+    );
+    const FloatType squareDistance = positionDifference.squaredNorm();
+
+    /* The gradient of either term with respect to atom i is a scalar
+     * coefficient times the position difference d, so that the hessian block
+     * is the coefficient times the identity plus a multiple of d d^T
+     */
+    FloatType coefficient;
+    FloatType outerCoefficient;
+    const FloatType upperTerm = squareDistance / upperBoundSquared - 1;
+    if(upperTerm > 0) {
+      coefficient = 4 * upperTerm / upperBoundSquared;
+      outerCoefficient = 8 / (upperBoundSquared * upperBoundSquared);
+    } else {
+      const FloatType quotient = lowerBoundSquared + squareDistance;
+      const FloatType lowerTerm = 2 * lowerBoundSquared / quotient - 1;
+      if(lowerTerm <= 0) {
+        return;
+      }
+
+      const FloatType quotientSquared = quotient * quotient;
+      coefficient = -8 * lowerBoundSquared * lowerTerm / quotientSquared;
+      outerCoefficient = 32 * lowerBoundSquared * (
+        lowerBoundSquared + lowerTerm * quotient
+      ) / (quotientSquared * quotientSquared);
+    }
+
+    const FullDimensionalVector directionDifference = (
+      direction.template segment<dimensionality>(dimensionality * i)
+      - direction.template segment<dimensionality>(dimensionality * j)
+    );
+
+    const FullDimensionalVector f = (
+      coefficient * directionDifference
+      + outerCoefficient * positionDifference.dot(directionDifference) * positionDifference
+    );
+
+    product.template segment<dimensionality>(dimensionality * i) += f;
+    product.template segment<dimensionality>(dimensionality * j) -= f;
+  }
+
+  //! Adds the hessian-vector product of distance terms
+  void distanceHessianProduct(
+    const VectorType& positions,
+    const VectorType& direction,
+    Eigen::Ref<VectorType> product
+  ) const {
+    // Pairs skipped by pruning are within their bounds and have no curvature
+    if(pruneDistanceTerms) {
+      updateActivePairs(positions);
+      for(const ActivePair& pair : activePairs_) {
+        distancePairHessianProduct(positions, direction, pair.i, pair.j, pair.linearIndex, product);
+      }
+      return;
+    }
+
+    const unsigned N = positions.size() / dimensionality;
+    for(unsigned linearIndex = 0, i = 0; i + 1 < N; ++i) {
+      for(unsigned j = i + 1; j < N; ++j, ++linearIndex) {
+        distancePairHessianProduct(positions, direction, i, j, linearIndex, product);
+      }
+    }
+  }
+
+  //! Adds the hessian-vector product of chiral terms
+  void chiralHessianProduct(
+    const VectorType& positions,
+    const VectorType& direction,
+    Eigen::Ref<VectorType> product
+  ) const {
+    for(const auto& constraint : chiralConstraints) {
+      const ThreeDimensionalVector delta = getAveragePosition3D(positions, constraint.sites[3]);
+      const ThreeDimensionalVector A = getAveragePosition3D(positions, constraint.sites[0]) - delta;
+      const ThreeDimensionalVector B = getAveragePosition3D(positions, constraint.sites[1]) - delta;
+      const ThreeDimensionalVector C = getAveragePosition3D(positions, constraint.sites[2]) - delta;
+
+      const FloatType volume = A.dot(B.cross(C));
+      const FloatType weight = constraint.weight;
+      const FloatType upperTerm = weight * (volume - static_cast<FloatType>(constraint.upper));
+      const FloatType lowerTerm = weight * (static_cast<FloatType>(constraint.lower) - volume);
+      const FloatType factor = 2 * (
+        std::max(FloatType {0}, upperTerm)
+        - std::max(FloatType {0}, lowerTerm)
+      );
+
+      if(factor == 0) {
+        continue;
+      }
+
+      // Averaged direction differences corresponding to A, B and C
+      const ThreeDimensionalVector directionDelta = getAveragePosition3D(direction, constraint.sites[3]);
+      const ThreeDimensionalVector pA = getAveragePosition3D(direction, constraint.sites[0]) - directionDelta;
+      const ThreeDimensionalVector pB = getAveragePosition3D(direction, constraint.sites[1]) - directionDelta;
+      const ThreeDimensionalVector pC = getAveragePosition3D(direction, constraint.sites[2]) - directionDelta;
+
+      // Volume gradients and their directional derivatives
+      const ThreeDimensionalVector iGradient = B.cross(C);
+      const ThreeDimensionalVector jGradient = C.cross(A);
+      const ThreeDimensionalVector kGradient = A.cross(B);
+      const ThreeDimensionalVector iDerivative = pB.cross(C) + B.cross(pC);
+      const ThreeDimensionalVector jDerivative = pC.cross(A) + C.cross(pA);
+      const ThreeDimensionalVector kDerivative = pA.cross(B) + A.cross(pB);
+
+      const FloatType volumeDerivative = 2 * weight * (
+        iGradient.dot(pA) + jGradient.dot(pB) + kGradient.dot(pC)
+      );
+
+      const ThreeDimensionalVector iContribution = (
+        volumeDerivative * iGradient + factor * iDerivative
+      ) / constraint.sites[0].size();
+      const ThreeDimensionalVector jContribution = (
+        volumeDerivative * jGradient + factor * jDerivative
+      ) / constraint.sites[1].size();
+      const ThreeDimensionalVector kContribution = (
+        volumeDerivative * kGradient + factor * kDerivative
+      ) / constraint.sites[2].size();
+      const ThreeDimensionalVector lContribution = -(
+        volumeDerivative * (iGradient + jGradient + kGradient)
+        + factor * (iDerivative + jDerivative + kDerivative)
+      ) / constraint.sites[3].size();
+
+      for(const AtomIndex alphaI : constraint.sites[0]) {
+        product.template segment<3>(dimensionality * alphaI) += iContribution;
+      }
+
+      for(const AtomIndex betaI : constraint.sites[1]) {
+        product.template segment<3>(dimensionality * betaI) += jContribution;
+      }
+
+      for(const AtomIndex gammaI : constraint.sites[2]) {
+        product.template segment<3>(dimensionality * gammaI) += kContribution;
+      }
+
+      for(const AtomIndex deltaI : constraint.sites[3]) {
+        product.template segment<3>(dimensionality * deltaI) += lContribution;
+      }
+    }
+  }
+
+  //! Adds the Gauss-Newton hessian-vector product of dihedral terms
+  void dihedralHessianProduct(
+    const VectorType& positions,
+    const VectorType& direction,
+    Eigen::Ref<VectorType> product
+  ) const {
+    constexpr FloatType reductionFactor = 1.0 / 10;
+    constexpr FloatType pi {M_PI};
+
+    for(const DihedralConstraint& constraint : dihedralConstraints) {
+      const ThreeDimensionalVector alpha = getAveragePosition3D(positions, constraint.sites[0]);
+      const ThreeDimensionalVector beta = getAveragePosition3D(positions, constraint.sites[1]);
+      const ThreeDimensionalVector gamma = getAveragePosition3D(positions, constraint.sites[2]);
+      const ThreeDimensionalVector delta = getAveragePosition3D(positions, constraint.sites[3]);
+
+      const ThreeDimensionalVector f = alpha - beta;
+      const ThreeDimensionalVector g = beta - gamma;
+      const ThreeDimensionalVector h = delta - gamma;
+
+      ThreeDimensionalVector a = f.cross(g);
+      ThreeDimensionalVector b = h.cross(g);
+
+      const FloatType constraintSumHalved = (static_cast<FloatType>(constraint.lower) + static_cast<FloatType>(constraint.upper)) / 2;
+
+      FloatType phi = std::atan2(
+        a.cross(b).dot(-g.normalized()),
+        a.dot(b)
+      );
+
+      if(phi < constraintSumHalved - pi) {
+        phi += 2 * pi;
+      } else if(phi > constraintSumHalved + pi) {
+        phi -= 2 * pi;
+      }
+
+      const FloatType h_phi = std::fabs(phi - constraintSumHalved) - (static_cast<FloatType>(constraint.upper) - static_cast<FloatType>(constraint.lower)) / 2;
+      if(h_phi <= 0) {
+        continue;
+      }
+
+      const FloatType gLength = g.norm();
+      const FloatType aLengthSq = a.squaredNorm();
+      const FloatType bLengthSq = b.squaredNorm();
+      if(gLength == 0 || aLengthSq == 0 || bLengthSq == 0) {
+        continue;
+      }
+      a /= aLengthSq;
+      b /= bLengthSq;
+      const FloatType fDotG = f.dot(g);
+      const FloatType gDotH = g.dot(h);
+
+      // Dihedral angle gradients with respect to the averaged positions
+      const ThreeDimensionalVector iGradient = -gLength * a;
+      const ThreeDimensionalVector jGradient = (gLength + fDotG / gLength) * a - (gDotH / gLength) * b;
+      const ThreeDimensionalVector kGradient = (gDotH / gLength - gLength) * b - (fDotG / gLength) * a;
+      const ThreeDimensionalVector lGradient = gLength * b;
+
+      const FloatType phiDerivative = 2 * reductionFactor * (
+        iGradient.dot(getAveragePosition3D(direction, constraint.sites[0]))
+        + jGradient.dot(getAveragePosition3D(direction, constraint.sites[1]))
+        + kGradient.dot(getAveragePosition3D(direction, constraint.sites[2]))
+        + lGradient.dot(getAveragePosition3D(direction, constraint.sites[3]))
+      );
+
+      const ThreeDimensionalVector iContribution = phiDerivative * iGradient / constraint.sites[0].size();
+      const ThreeDimensionalVector jContribution = phiDerivative * jGradient / constraint.sites[1].size();
+      const ThreeDimensionalVector kContribution = phiDerivative * kGradient / constraint.sites[2].size();
+      const ThreeDimensionalVector lContribution = phiDerivative * lGradient / constraint.sites[3].size();
+
+      for(const AtomIndex alphaConstitutingIndex : constraint.sites[0]) {
+        product.template segment<3>(dimensionality * alphaConstitutingIndex) += iContribution;
+      }
+
+      for(const AtomIndex betaConstitutingIndex : constraint.sites[1]) {
+        product.template segment<3>(dimensionality * betaConstitutingIndex) += jContribution;
+      }
+
+      for(const AtomIndex gammaConstitutingIndex : constraint.sites[2]) {
+        product.template segment<3>(dimensionality * gammaConstitutingIndex) += kContribution;
+      }
+
+      for(const AtomIndex deltaConstitutingIndex : constraint.sites[3]) {
+        product.template segment<3>(dimensionality * deltaConstitutingIndex) += lContribution;
+      }
+    }
+  }
+//!@}
+
+  //! Atom pair whose distance term may contribute
+  struct ActivePair {
+    unsigned i;
+    unsigned j;
+    unsigned linearIndex;
+  };
+
+  //! Positions at the last rebuild of the active pair list
+  mutable VectorType pruningReferencePositions_;
+  //! Pairs whose distance terms may contribute, in linear index order
+  mutable std::vector<ActivePair> activePairs_;
+
+  //! Squared lower bound of an atom pair i < j
+  inline FloatType lowerBoundSquared_(
+    const unsigned i,
+    const unsigned j,
+    const unsigned linearIndex
+  ) const {
+    if(boundsPtr_ != nullptr) {
+      const double lower = (*boundsPtr_)(j, i);
+      return lower * lower;
+    }
+
+    return lowerDistanceBoundsSquared(linearIndex);
+  }
+
+  //! Squared upper bound of an atom pair i < j
+  inline FloatType upperBoundSquared_(
+    const unsigned i,
+    const unsigned j,
+    const unsigned linearIndex
+  ) const {
+    if(boundsPtr_ != nullptr) {
+      const double upper = (*boundsPtr_)(i, j);
+      return upper * upper;
+    }
+
+    return upperDistanceBoundsSquared(linearIndex);
+  }
+
+  //! Unsquared bounds squared on access, if not linearized
+  const Eigen::MatrixXd* boundsPtr_ = nullptr;
+  //! Inverse upper distance bounds squared, linearized in i < j (SIMD only)
+  VectorType inverseUpperDistanceBoundsSquared_;
+  //! Structure-of-arrays work buffers of the SIMD distance contributions
+  using SoaArrayType = Eigen::Array<FloatType, Eigen::Dynamic, dimensionality>;
+  mutable SoaArrayType soaPositions_;
+  mutable SoaArrayType soaGradient_;
 };
 
 /**
@@ -116,7 +116,19 @@ enum class DgError {
   /**
    * @brief Unknown exception
    */
-  UnknownException = 8
+  UnknownException = 8,
+  /**
+   * @brief Conformer generation was cancelled
+   *
+   * In budgeted ensemble generation, conformers still being generated when
+   * the budget is exhausted (i.e. enough structures were generated, the time
+   * limit passed or the failure rate shows that further attempts are futile)
+   * are cancelled. Also returned if the budget is exhausted before any
+   * conformer could be generated.
+   *
+   * If you get this error, consider increasing the time limit of the budget.
+   */
+  Cancelled = 9
 };
 
 // Boilerplate to allow interoperability of DgError with std::error_code
@@ -148,6 +160,8 @@ namespace Detail {
           return "Failed to generate decision list.";
         case DgError::UnknownException:
           return "Conformer generation encountered an unexpected exception.";
+        case DgError::Cancelled:
+          return "Conformer generation was cancelled.";
         default:
           return "Unknown error.";
       };
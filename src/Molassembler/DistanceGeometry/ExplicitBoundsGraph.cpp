@@ -11,6 +11,7 @@
 #include "Molassembler/DistanceGeometry/DistanceBoundsMatrix.h"
 #include "Molassembler/DistanceGeometry/DistanceGeometry.h"
 #include "Molassembler/DistanceGeometry/Error.h"
+#include "Molassembler/DistanceGeometry/SparseBounds.h"
 #include "Molassembler/Log.h"
 #include "Molassembler/Modeling/AtomInfo.h"
 #include "Molassembler/Molecule.h"
@@ -42,7 +43,7 @@ namespace DistanceGeometry {
 ExplicitBoundsGraph::ExplicitBoundsGraph(
   const PrivateGraph& inner,
   const BoundsMatrix& bounds
-) : graph_ {2 * inner.N()},
+) : graph_ {inner.N()},
     inner_ {inner}
 {
   const AtomIndex N = inner.N();
@@ -63,49 +64,32 @@ ExplicitBoundsGraph::ExplicitBoundsGraph(
           + AtomInfo::vdwRadius(inner.elementType(b))
         );
 
-        boost::add_edge(left(a), right(b), -vdwLowerBound, graph_);
-        boost::add_edge(left(b), right(a), -vdwLowerBound, graph_);
+        graph_.addEdge(left(a), right(b), -vdwLowerBound);
+        graph_.addEdge(left(b), right(a), -vdwLowerBound);
       } else {
         /* Add explicit edges for this a-b pair */
         // Bidirectional edge in left graph with upper weight
-        boost::add_edge(left(a), left(b), upperBound, graph_);
-        boost::add_edge(left(b), left(a), upperBound, graph_);
+        graph_.addEdge(left(a), left(b), upperBound);
+        graph_.addEdge(left(b), left(a), upperBound);
 
         // Bidirectional edge in right graph with upper weight
-        boost::add_edge(right(a), right(b), upperBound, graph_);
-        boost::add_edge(right(b), right(a), upperBound, graph_);
+        graph_.addEdge(right(a), right(b), upperBound);
+        graph_.addEdge(right(b), right(a), upperBound);
 
         // Forward edge from left to right graph with negative lower bound weight
-        boost::add_edge(left(a), right(b), -lowerBound, graph_);
-        boost::add_edge(left(b), right(a), -lowerBound, graph_);
+        graph_.addEdge(left(a), right(b), -lowerBound);
+        graph_.addEdge(left(b), right(a), -lowerBound);
       }
     }
   }
 
-  // Determine the two heaviest element types in the molecule, O(N)
-  heaviestAtoms_ = {{Utils::ElementType::H, Utils::ElementType::H}};
-  for(AtomIndex i = 0; i < N; ++i) {
-    auto elementType = inner.elementType(i);
-    if(
-      Utils::ElementInfo::Z(elementType)
-      > Utils::ElementInfo::Z(heaviestAtoms_.back())
-    ) {
-      heaviestAtoms_.back() = elementType;
-
-      if(
-        Utils::ElementInfo::Z(heaviestAtoms_.back())
-        > Utils::ElementInfo::Z(heaviestAtoms_.front())
-      ) {
-        std::swap(heaviestAtoms_.front(), heaviestAtoms_.back());
-      }
-    }
-  }
+  determineHeaviestAtoms_();
 }
 
 ExplicitBoundsGraph::ExplicitBoundsGraph(
   const PrivateGraph& inner,
   const DistanceBoundsMatrix& bounds
-) : graph_ {2 * inner.N()},
+) : graph_ {inner.N()},
     inner_ {inner}
 {
   const VertexDescriptor N = inner.N();
@@ -116,8 +100,8 @@ ExplicitBoundsGraph::ExplicitBoundsGraph(
 
       if(lower != DistanceBoundsMatrix::defaultLower) {
         // Forward edge from left to right graph with negative lower bound weight
-        boost::add_edge(left(a), right(b), -lower, graph_);
-        boost::add_edge(left(b), right(a), -lower, graph_);
+        graph_.addEdge(left(a), right(b), -lower);
+        graph_.addEdge(left(b), right(a), -lower);
       } else {
         const double vdwLowerBound = (
           AtomInfo::vdwRadius(inner_.elementType(a))
@@ -125,40 +109,67 @@ ExplicitBoundsGraph::ExplicitBoundsGraph(
         );
 
         // Implicit lower bound on distance between the vertices
-        boost::add_edge(left(a), right(b), -vdwLowerBound, graph_);
-        boost::add_edge(left(b), right(a), -vdwLowerBound, graph_);
+        graph_.addEdge(left(a), right(b), -vdwLowerBound);
+        graph_.addEdge(left(b), right(a), -vdwLowerBound);
       }
 
       if(upper != DistanceBoundsMatrix::defaultUpper) {
         // Bidirectional edge in left graph with upper weight
-        boost::add_edge(left(a), left(b), upper, graph_);
-        boost::add_edge(left(b), left(a), upper, graph_);
+        graph_.addEdge(left(a), left(b), upper);
+        graph_.addEdge(left(b), left(a), upper);
 
         // Bidirectional edge in right graph with upper weight
-        boost::add_edge(right(a), right(b), upper, graph_);
-        boost::add_edge(right(b), right(a), upper, graph_);
+        graph_.addEdge(right(a), right(b), upper);
+        graph_.addEdge(right(b), right(a), upper);
       }
     }
   }
 
-  // Determine the two heaviest element types in the molecule, O(N)
-  heaviestAtoms_ = {{Utils::ElementType::H, Utils::ElementType::H}};
-  for(AtomIndex i = 0; i < N; ++i) {
-    auto elementType = inner.elementType(i);
-    if(
-      Utils::ElementInfo::Z(elementType)
-      > Utils::ElementInfo::Z(heaviestAtoms_.back())
-    ) {
-      heaviestAtoms_.back() = elementType;
+  determineHeaviestAtoms_();
+}
 
-      if(
-        Utils::ElementInfo::Z(heaviestAtoms_.back())
-        > Utils::ElementInfo::Z(heaviestAtoms_.front())
-      ) {
-        std::swap(heaviestAtoms_.front(), heaviestAtoms_.back());
+ExplicitBoundsGraph::ExplicitBoundsGraph(
+  const PrivateGraph& inner,
+  const SparseBounds& bounds
+) : graph_ {inner.N()},
+    inner_ {inner}
+{
+  const AtomIndex N = inner.N();
+  assert(bounds.N() == N);
+
+  for(AtomIndex a = 0; a < N; ++a) {
+    /* Walk the sorted explicit pairs of a alongside all b > a so that edges
+     * are added in the same order as from the equivalent dense bounds matrix
+     */
+    const auto& entries = bounds.entries(a);
+    auto entryIter = std::begin(entries);
+    for(AtomIndex b = a + 1; b < N; ++b) {
+      if(entryIter != std::end(entries) && entryIter->partner == b) {
+        const ValueBounds& explicitBounds = entryIter->bounds;
+        assert(explicitBounds.lower <= explicitBounds.upper);
+        ++entryIter;
+
+        // Bidirectional edge in left graph with upper weight
+        graph_.addEdge(left(a), left(b), explicitBounds.upper);
+        graph_.addEdge(left(b), left(a), explicitBounds.upper);
+
+        // Bidirectional edge in right graph with upper weight
+        graph_.addEdge(right(a), right(b), explicitBounds.upper);
+        graph_.addEdge(right(b), right(a), explicitBounds.upper);
+
+        // Forward edge from left to right graph with negative lower bound weight
+        graph_.addEdge(left(a), right(b), -explicitBounds.lower);
+        graph_.addEdge(left(b), right(a), -explicitBounds.lower);
+      } else {
+        // Implicit lower bound on distance between the vertices
+        const double vdwLowerBound = bounds.impliedLower(a, b);
+        graph_.addEdge(left(a), right(b), -vdwLowerBound);
+        graph_.addEdge(left(b), right(a), -vdwLowerBound);
       }
     }
   }
+
+  determineHeaviestAtoms_();
 }
 
 void ExplicitBoundsGraph::addBound(
@@ -167,16 +178,16 @@ void ExplicitBoundsGraph::addBound(
   const ValueBounds& bound
 ) {
   // Bidirectional edge in left graph with upper weight
-  boost::add_edge(left(a), left(b), bound.upper, graph_);
-  boost::add_edge(left(b), left(a), bound.upper, graph_);
+  updateOrAddEdge_(left(a), left(b), bound.upper);
+  updateOrAddEdge_(left(b), left(a), bound.upper);
 
   // Bidirectional edge in right graph with upper weight
-  boost::add_edge(right(a), right(b), bound.upper, graph_);
-  boost::add_edge(right(b), right(a), bound.upper, graph_);
+  updateOrAddEdge_(right(a), right(b), bound.upper);
+  updateOrAddEdge_(right(b), right(a), bound.upper);
 
   // Forward edge from left to right graph with negative lower bound weight
-  boost::add_edge(left(a), right(b), -bound.lower, graph_);
-  boost::add_edge(left(b), right(a), -bound.lower, graph_);
+  updateOrAddEdge_(left(a), right(b), -bound.lower);
+  updateOrAddEdge_(left(b), right(a), -bound.lower);
 }
 
 void ExplicitBoundsGraph::explainContradictionPaths(
@@ -215,17 +226,34 @@ void ExplicitBoundsGraph::explainContradictionPaths(
   }
 }
 
+void ExplicitBoundsGraph::determineHeaviestAtoms_() {
+  // Determine the two heaviest element types in the molecule, O(N)
+  heaviestAtoms_ = {{Utils::ElementType::H, Utils::ElementType::H}};
+  const AtomIndex N = inner_.N();
+  for(AtomIndex i = 0; i < N; ++i) {
+    auto elementType = inner_.elementType(i);
+    if(
+      Utils::ElementInfo::Z(elementType)
+      > Utils::ElementInfo::Z(heaviestAtoms_.back())
+    ) {
+      heaviestAtoms_.back() = elementType;
+
+      if(
+        Utils::ElementInfo::Z(heaviestAtoms_.back())
+        > Utils::ElementInfo::Z(heaviestAtoms_.front())
+      ) {
+        std::swap(heaviestAtoms_.front(), heaviestAtoms_.back());
+      }
+    }
+  }
+}
+
 void ExplicitBoundsGraph::updateOrAddEdge_(
   const VertexDescriptor i,
   const VertexDescriptor j,
   const double edgeWeight
 ) {
-  auto edgeSearchPair = boost::edge(i, j, graph_);
-  if(edgeSearchPair.second) {
-    boost::get(boost::edge_weight, graph_, edgeSearchPair.first) = edgeWeight;
-  } else {
-    boost::add_edge(i, j, edgeWeight, graph_);
-  }
+  graph_.updateOrAddEdge(i, j, edgeWeight);
 }
 
 void ExplicitBoundsGraph::updateGraphWithFixedDistance_(
@@ -287,19 +315,27 @@ const ExplicitBoundsGraph::GraphType& ExplicitBoundsGraph::graph() const {
 }
 
 outcome::result<Eigen::MatrixXd> ExplicitBoundsGraph::makeDistanceBounds() const noexcept {
-  unsigned N = inner_.N();
+  const unsigned N = inner_.N();
 
   Eigen::MatrixXd bounds;
   bounds.resize(N, N);
   bounds.setZero();
 
-  unsigned M = boost::num_vertices(graph_);
-  std::vector<double> distances (M);
-  std::vector<VertexDescriptor> predecessors (M);
-  using ColorMapType = boost::two_bit_color_map<>;
-  ColorMapType color_map {M};
+  /* Each single-source shortest paths calculation from left(a) only writes
+   * the upper bounds in row a and the lower bounds in column a of the bounds
+   * matrix, so the sources are independent and can be processed in parallel.
+   */
+  bool contradiction = false;
+
+#pragma omp parallel
+  {
+    // Thread-private shortest paths buffers
+    const unsigned M = boost::num_vertices(graph_);
+    std::vector<double> distances (M);
+    std::vector<VertexDescriptor> predecessors (M);
+    using ColorMapType = boost::two_bit_color_map<>;
+    ColorMapType color_map {M};
 
-  for(AtomIndex a = 0; a < N - 1; ++a) {
     auto predecessor_map = boost::make_iterator_property_map(
       predecessors.begin(),
       boost::get(boost::vertex_index, graph_)
@@ -310,51 +346,72 @@ outcome::result<Eigen::MatrixXd> ExplicitBoundsGraph::makeDistanceBounds() const
       boost::get(boost::vertex_index, graph_)
     );
 
-    // re-fill color map with white
-    std::fill(
-      color_map.data.get(),
-      color_map.data.get() + (color_map.n + ColorMapType::elements_per_char - 1)
-        / ColorMapType::elements_per_char,
-      0
-    );
+#pragma omp for schedule(dynamic)
+    for(AtomIndex a = 0; a < N - 1; ++a) {
+      bool skip;
+#pragma omp atomic read
+      skip = contradiction;
+      if(skip) {
+        continue;
+      }
+
+      // re-fill color map with white
+      std::fill(
+        color_map.data.get(),
+        color_map.data.get() + (color_map.n + ColorMapType::elements_per_char - 1)
+          / ColorMapType::elements_per_char,
+        0
+      );
 
 #ifdef MOLASSEMBLER_EXPLICIT_GRAPH_USE_SPECIALIZED_GOR1_ALGORITHM
-    boost::gor1_ig_shortest_paths(
-      *this,
-      VertexDescriptor {left(a)},
-      predecessor_map,
-      color_map,
-      distance_map
-    );
+      boost::gor1_ig_shortest_paths(
+        *this,
+        VertexDescriptor {left(a)},
+        predecessor_map,
+        color_map,
+        distance_map
+      );
 #else
-    boost::gor1_simplified_shortest_paths(
-      graph_,
-      VertexDescriptor {left(a)},
-      predecessor_map,
-      color_map,
-      distance_map
-    );
+      boost::gor1_simplified_shortest_paths(
+        graph_,
+        VertexDescriptor {left(a)},
+        predecessor_map,
+        color_map,
+        distance_map
+      );
 #endif
 
-    for(AtomIndex b = a + 1; b < N; ++b) {
-      // Get upper bound from distances
-      bounds(a, b) = distances.at(left(b));
-      // Get lower bound from distances
-      bounds(b, a) = -distances.at(right(b));
-
-      // If the upper bound is less than the lower bound, we have a contradiction
-      if(bounds(a, b) < bounds(b, a)) {
-        explainContradictionPaths(a, b, predecessors, distances);
-        return DgError::GraphImpossible;
-      }
-
-      // Negative values are not allowed
-      if(bounds(a, b) <= 0 || bounds(b, a) <= 0) {
-        return DgError::GraphImpossible;
+      for(AtomIndex b = a + 1; b < N; ++b) {
+        // Get upper bound from distances
+        bounds(a, b) = distances[left(b)];
+        // Get lower bound from distances
+        bounds(b, a) = -distances[right(b)];
+
+        // If the upper bound is less than the lower bound, we have a contradiction
+        if(bounds(a, b) < bounds(b, a)) {
+#pragma omp critical(explainContradiction)
+          {
+            explainContradictionPaths(a, b, predecessors, distances);
+          }
+#pragma omp atomic write
+          contradiction = true;
+          break;
+        }
+
+        // Negative values are not allowed
+        if(bounds(a, b) <= 0 || bounds(b, a) <= 0) {
+#pragma omp atomic write
+          contradiction = true;
+          break;
+        }
       }
     }
   }
 
+  if(contradiction) {
+    return DgError::GraphImpossible;
+  }
+
   return bounds;
 }
 
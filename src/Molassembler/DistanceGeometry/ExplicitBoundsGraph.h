@@ -14,7 +14,7 @@
 
 // #define MOLASSEMBLER_EXPLICIT_GRAPH_USE_SPECIALIZED_GOR1_ALGORITHM
 
-#include "boost/graph/adjacency_list.hpp"
+#include "Molassembler/DistanceGeometry/FlatBoundsGraph.h"
 #include "Eigen/Core"
 #include "Utils/Geometry/ElementInfo.h"
 
@@ -37,6 +37,7 @@ namespace DistanceGeometry {
 
 // Forward-declarations
 class DistanceBoundsMatrix;
+class SparseBounds;
 
 
 /*! @brief BGL wrapper to help with distance bounds smoothing
@@ -53,23 +54,19 @@ class DistanceBoundsMatrix;
  * generateDistanceMatrix called upon it. This procedure modifies the
  * underlying graph and hence cannot be called repeatedly.
  *
- * The underlying data structure is a fully explicit BGL graph containing all
- * edges and edge weights.
+ * The underlying data structure is a fully explicit, BGL-compatible graph
+ * containing all edges and edge weights in flat per-vertex storage. Copying
+ * an instance requires no per-edge allocations. Since implied lower bounds are
+ * explicit edges, the graph has two edges for each atom pair without explicit
+ * bounds.
  */
 class ExplicitBoundsGraph {
 public:
 //!@name Member types
 //!@{
-  using EdgeWeightProperty = boost::property<boost::edge_weight_t, double>;
-  using GraphType = boost::adjacency_list<
-    boost::vecS,
-    boost::vecS,
-    boost::directedS,
-    boost::no_property,
-    EdgeWeightProperty
-  >;
-  using VertexDescriptor = GraphType::vertex_descriptor;
-  using EdgeDescriptor = GraphType::edge_descriptor;
+  using GraphType = FlatBoundsGraph;
+  using VertexDescriptor = boost::graph_traits<GraphType>::vertex_descriptor;
+  using EdgeDescriptor = boost::graph_traits<GraphType>::edge_descriptor;
 
   using BoundsMatrix = Eigen::MatrixXd;
 //!@}
@@ -93,6 +90,17 @@ public:
     const PrivateGraph& inner,
     const BoundsMatrix& bounds
   );
+
+  /*! @brief Construct from sparse bounds
+   *
+   * Equivalent to construction from the dense bounds matrix of @p bounds.
+   *
+   * @complexity{@math{\Theta(N^2)}}
+   */
+  ExplicitBoundsGraph(
+    const PrivateGraph& inner,
+    const SparseBounds& bounds
+  );
 //!@}
 
 //!@name Static member functions
@@ -149,6 +157,8 @@ public:
    * - Edges from the left vertices of a and b to the right opposite one with
    *   the negative lower bound
    *
+   * Existing edges between a and b are overwritten.
+   *
    * @complexity{@math{\Theta(1)}}
    */
   void addBound(
@@ -197,6 +207,10 @@ public:
   const GraphType& graph() const;
 
   /*! @brief Make smooth distance bounds
+   *
+   * @note This function is parallelized over the shortest paths sources. Use
+   * the OMP_NUM_THREADS environment variable to control the number of threads
+   * used.
    *
    * @complexity{@math{\Theta(V \cdot E)}}
    */
@@ -209,6 +223,9 @@ private:
   //! Stores the two heaviest element types
   std::array<Utils::ElementType, 2> heaviestAtoms_;
 
+  //! Sets the two heaviest element types of the graph being modeled
+  void determineHeaviestAtoms_();
+
   void updateOrAddEdge_(
     VertexDescriptor i,
     VertexDescriptor j,
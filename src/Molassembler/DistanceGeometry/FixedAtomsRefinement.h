@@ -0,0 +1,324 @@
+/*!@file
+ * @copyright This code is licensed under the 3-clause BSD license.
+ *   Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.
+ *   See LICENSE.txt for details.
+ * @brief Refinement error function with fixed atoms eliminated
+ */
+
+#ifndef INCLUDE_MOLASSEMBLER_DG_FIXED_ATOMS_REFINEMENT_PROBLEM_H
+#define INCLUDE_MOLASSEMBLER_DG_FIXED_ATOMS_REFINEMENT_PROBLEM_H
+
+#include "Molassembler/DistanceGeometry/EigenRefinement.h"
+
+namespace Scine {
+namespace Molassembler {
+namespace DistanceGeometry {
+
+/**
+ * @brief Refinement error function over the positions of free atoms only
+ *
+ * Fixed atoms are removed from the parameter vector, so that optimizers
+ * operate on positions of free atoms only. Terms involving only fixed atoms
+ * are constant and are dropped: Distance terms between fixed atoms are
+ * excluded from the active pair list, and chiral and dihedral constraints
+ * whose sites are all fixed are removed. The error function value therefore
+ * differs from that of the full problem by a constant.
+ *
+ * Fixed atom positions are set by reduce() and kept constant. Terms involving
+ * free atoms are evaluated by an EigenRefinementProblem over all atoms, into
+ * which free atom parameters are scattered.
+ *
+ * Public members mirror EigenRefinementProblem's, so that both can be passed
+ * to the same refinement stages.
+ *
+ * @tparam dimensionality 3 or 4 spatial dimensions to refine in
+ * @tparam FloatType float or double
+ * @tparam SIMD Must be false, since distance term pruning is required
+ */
+template<unsigned dimensionality, typename FloatType, bool SIMD>
+class FixedAtomsRefinementProblem {
+  static_assert(
+    !SIMD,
+    "Elimination of fixed atoms requires non-SIMD distance term pruning"
+  );
+
+public:
+//!@name Public types
+//!@{
+  //! Refinement problem over all atoms
+  using FullProblemType = EigenRefinementProblem<dimensionality, FloatType, SIMD>;
+  //! Vector layout of positions
+  using VectorType = typename FullProblemType::VectorType;
+  //! Template argument specifying floating-point type
+  using FloatingPointType = FloatType;
+//!@}
+
+//!@name Public members
+//!@{
+  //! Whether to compress the fourth dimension
+  bool compressFourthDimension = false;
+  //! Whether to enable dihedral terms
+  bool dihedralTerms = false;
+//!@}
+
+//!@name Signaling members
+//!@{
+  mutable double proportionChiralConstraintsCorrectSign = 0.0;
+//!@}
+
+//!@name Constructors
+//!@{
+  /*! @brief Constructor
+   *
+   * @param squaredBounds Squared distance bounds of all atoms
+   * @param passChiralConstraints Chiral constraints of all atoms
+   * @param passDihedralConstraints Dihedral constraints of all atoms
+   * @param passFixedAtoms Whether each atom is fixed
+   *
+   * @complexity{@math{\Theta(N^2 + C + D)}}
+   */
+  FixedAtomsRefinementProblem(
+    const Eigen::MatrixXd& squaredBounds,
+    const std::vector<ChiralConstraint>& passChiralConstraints,
+    const std::vector<DihedralConstraint>& passDihedralConstraints,
+    std::vector<bool> passFixedAtoms
+  ) : full_(
+        squaredBounds,
+        freeConstraints(passChiralConstraints, passFixedAtoms),
+        freeConstraints(passDihedralConstraints, passFixedAtoms)
+      )
+  {
+    assert(passFixedAtoms.size() == static_cast<unsigned>(squaredBounds.cols()));
+    setFixedAtoms_(std::move(passFixedAtoms));
+  }
+
+  /*! @brief Constructor from smoothed distance bounds
+   *
+   * @param bounds Distance bounds of all atoms. Without SIMD, these are not
+   *   copied and must outlive the problem.
+   * @param passChiralConstraints Chiral constraints of all atoms
+   * @param passDihedralConstraints Dihedral constraints of all atoms
+   * @param passFixedAtoms Whether each atom is fixed
+   *
+   * @complexity{@math{\Theta(N + C + D)} without SIMD}
+   */
+  FixedAtomsRefinementProblem(
+    const DistanceBoundsMatrix& bounds,
+    const std::vector<ChiralConstraint>& passChiralConstraints,
+    const std::vector<DihedralConstraint>& passDihedralConstraints,
+    std::vector<bool> passFixedAtoms
+  ) : full_(
+        bounds,
+        freeConstraints(passChiralConstraints, passFixedAtoms),
+        freeConstraints(passDihedralConstraints, passFixedAtoms)
+      )
+  {
+    assert(passFixedAtoms.size() == bounds.N());
+    setFixedAtoms_(std::move(passFixedAtoms));
+  }
+//!@}
+
+private:
+  void setFixedAtoms_(std::vector<bool> passFixedAtoms) {
+    const unsigned N = passFixedAtoms.size();
+    for(unsigned i = 0; i < N; ++i) {
+      if(!passFixedAtoms[i]) {
+        freeAtoms_.push_back(i);
+      }
+    }
+
+    full_.pruneDistanceTerms = true;
+    full_.fixedAtoms = std::move(passFixedAtoms);
+    positions_ = VectorType::Zero(dimensionality * N);
+    buffer_ = VectorType::Zero(dimensionality * N);
+    direction_ = VectorType::Zero(dimensionality * N);
+  }
+
+public:
+//!@name Static member functions
+//!@{
+  /*! @brief Selects constraints with at least one free site atom
+   *
+   * @complexity{@math{\Theta(C)}}
+   */
+  template<typename Constraint>
+  static std::vector<Constraint> freeConstraints(
+    const std::vector<Constraint>& constraints,
+    const std::vector<bool>& fixedAtoms
+  ) {
+    std::vector<Constraint> selected;
+    for(const Constraint& constraint : constraints) {
+      const bool anyFree = std::any_of(
+        std::begin(constraint.sites),
+        std::end(constraint.sites),
+        [&](const auto& site) {
+          return std::any_of(
+            std::begin(site),
+            std::end(site),
+            [&](const AtomIndex i) { return !fixedAtoms.at(i); }
+          );
+        }
+      );
+      if(anyFree) {
+        selected.push_back(constraint);
+      }
+    }
+    return selected;
+  }
+//!@}
+
+//!@name Parameter conversion
+//!@{
+  /*! @brief Sets fixed atom positions and extracts free atom parameters
+   *
+   * @param positions Linearized positions of all atoms
+   *
+   * @returns Linearized positions of free atoms
+   *
+   * @complexity{@math{\Theta(N)}}
+   */
+  VectorType reduce(const VectorType& positions) {
+    assert(positions.size() == positions_.size());
+    positions_ = positions;
+    VectorType parameters(dimensionality * freeAtoms_.size());
+    gatherInto_(positions, parameters);
+    return parameters;
+  }
+
+  /*! @brief Linearized positions of all atoms from free atom parameters
+   *
+   * @complexity{@math{\Theta(N)}}
+   */
+  VectorType expand(const VectorType& parameters) const {
+    scatter_(parameters);
+    return positions_;
+  }
+
+  //! Number of free atoms
+  unsigned freeAtomCount() const {
+    return freeAtoms_.size();
+  }
+
+  //! Underlying refinement problem over all atoms
+  const FullProblemType& fullProblem() const {
+    return full_;
+  }
+//!@}
+
+  /*!
+   * @brief Calculates the error value and gradient for all non-constant terms
+   * @param[in] parameters The linearized positions of free atoms
+   * @param[out] value The error function value for the given parameters
+   * @param[out] gradient The gradient for the given parameters
+   *
+   * @complexity{@math{\Theta(N + A + C + D)} without rebuild of the active
+   * pair list}
+   */
+  void operator() (const VectorType& parameters, FloatType& value, Eigen::Ref<VectorType> gradient) const {
+    assert(parameters.size() == gradient.size());
+    scatter_(parameters);
+    syncFlags_();
+    full_(positions_, value, buffer_);
+    proportionChiralConstraintsCorrectSign = full_.proportionChiralConstraintsCorrectSign;
+    gatherInto_(buffer_, gradient);
+  }
+
+  /*!
+   * @brief Calculates the product of the error function hessian with a vector
+   *
+   * Since fixed atoms do not move, this is the product of the free atom block
+   * of the full hessian.
+   *
+   * @complexity{@math{\Theta(N + A + C + D)} without rebuild of the active
+   * pair list}
+   */
+  void hessianVectorProduct(
+    const VectorType& parameters,
+    const VectorType& direction,
+    Eigen::Ref<VectorType> product
+  ) const {
+    assert(parameters.size() == direction.size());
+    assert(parameters.size() == product.size());
+    scatter_(parameters);
+    syncFlags_();
+
+    // Fixed atoms do not move along the direction
+    direction_.setZero();
+    scatterInto_(direction, direction_);
+    full_.hessianVectorProduct(positions_, direction_, buffer_);
+    gatherInto_(buffer_, product);
+  }
+
+  /*! @brief Calculates the number of chiral constraints with correct sign
+   *
+   * @complexity{@math{\Theta(N + C)}}
+   */
+  double calculateProportionChiralConstraintsCorrectSign(const VectorType& parameters) const {
+    scatter_(parameters);
+    proportionChiralConstraintsCorrectSign = full_.calculateProportionChiralConstraintsCorrectSign(positions_);
+    return proportionChiralConstraintsCorrectSign;
+  }
+
+  /*! @brief Visit all unfulfilled constraints of free atoms
+   *
+   * Distance bounds between fixed atoms are visited too.
+   *
+   * @see EigenRefinementProblem::visitUnfulfilledConstraints
+   */
+  template<typename Visitor>
+  auto visitUnfulfilledConstraints(
+    const DistanceBoundsMatrix& bounds,
+    const VectorType& parameters,
+    Visitor&& visitor
+  ) const {
+    scatter_(parameters);
+    return full_.visitUnfulfilledConstraints(
+      bounds,
+      positions_,
+      std::forward<Visitor>(visitor)
+    );
+  }
+
+private:
+  mutable FullProblemType full_;
+  std::vector<AtomIndex> freeAtoms_;
+  //! Positions of all atoms, fixed atoms' positions are constant
+  mutable VectorType positions_;
+  //! Gradient and hessian-vector product buffer for all atoms
+  mutable VectorType buffer_;
+  //! Hessian-vector product direction for all atoms
+  mutable VectorType direction_;
+
+  void syncFlags_() const {
+    full_.compressFourthDimension = compressFourthDimension;
+    full_.dihedralTerms = dihedralTerms;
+  }
+
+  void scatterInto_(const VectorType& parameters, VectorType& positions) const {
+    const unsigned F = freeAtoms_.size();
+    assert(parameters.size() == dimensionality * F);
+    for(unsigned k = 0; k < F; ++k) {
+      positions.template segment<dimensionality>(dimensionality * freeAtoms_[k])
+        = parameters.template segment<dimensionality>(dimensionality * k);
+    }
+  }
+
+  void scatter_(const VectorType& parameters) const {
+    scatterInto_(parameters, positions_);
+  }
+
+  void gatherInto_(const VectorType& full, Eigen::Ref<VectorType> parameters) const {
+    const unsigned F = freeAtoms_.size();
+    assert(parameters.size() == dimensionality * F);
+    for(unsigned k = 0; k < F; ++k) {
+      parameters.template segment<dimensionality>(dimensionality * k)
+        = full.template segment<dimensionality>(dimensionality * freeAtoms_[k]);
+    }
+  }
+};
+
+} // namespace DistanceGeometry
+} // namespace Molassembler
+} // namespace Scine
+
+#endif
@@ -0,0 +1,104 @@
+/*!@file
+ * @copyright This code is licensed under the 3-clause BSD license.
+ *   Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.
+ *   See LICENSE.txt for details.
+ */
+
+#include "Molassembler/DistanceGeometry/FlatBoundsGraph.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+namespace Scine {
+namespace Molassembler {
+namespace DistanceGeometry {
+
+FlatBoundsGraph::FlatBoundsGraph(const std::size_t N) : outEdges_(2 * N) {}
+
+void FlatBoundsGraph::addEdge(
+  const VertexDescriptor u,
+  const VertexDescriptor v,
+  const double weight
+) {
+  assert(u != v && !edge(u, v).second);
+  outEdges_[u].push_back(OutEdge {static_cast<unsigned>(v), weight});
+}
+
+void FlatBoundsGraph::updateOrAddEdge(
+  const VertexDescriptor u,
+  const VertexDescriptor v,
+  const double weight
+) {
+  auto& uEdges = outEdges_[u];
+  const auto findIter = std::find_if(
+    std::begin(uEdges),
+    std::end(uEdges),
+    [v](const OutEdge& e) -> bool { return e.target == v; }
+  );
+  if(findIter == std::end(uEdges)) {
+    uEdges.push_back(OutEdge {static_cast<unsigned>(v), weight});
+  } else {
+    findIter->weight = weight;
+  }
+}
+
+std::size_t FlatBoundsGraph::numEdges() const {
+  return std::accumulate(
+    std::begin(outEdges_),
+    std::end(outEdges_),
+    std::size_t {0},
+    [](const std::size_t count, const std::vector<OutEdge>& uEdges) -> std::size_t {
+      return count + uEdges.size();
+    }
+  );
+}
+
+std::pair<FlatBoundsGraph::EdgeDescriptor, bool> FlatBoundsGraph::edge(
+  const VertexDescriptor u,
+  const VertexDescriptor v
+) const {
+  const auto& uEdges = outEdges_[u];
+  const auto findIter = std::find_if(
+    std::begin(uEdges),
+    std::end(uEdges),
+    [v](const OutEdge& e) -> bool { return e.target == v; }
+  );
+  if(findIter == std::end(uEdges)) {
+    return {EdgeDescriptor {}, false};
+  }
+
+  return {
+    EdgeDescriptor {u, static_cast<std::size_t>(findIter - std::begin(uEdges))},
+    true
+  };
+}
+
+FlatBoundsGraph::edge_iterator::edge_iterator(
+  const FlatBoundsGraph& base,
+  const VertexDescriptor u
+) : basePtr_(&base),
+    edge_ {u, 0}
+{
+  skipExhausted_();
+}
+
+void FlatBoundsGraph::edge_iterator::skipExhausted_() {
+  const VertexDescriptor M = basePtr_->numVertices();
+  while(
+    edge_.source < M
+    && edge_.index == basePtr_->outEdges_[edge_.source].size()
+  ) {
+    ++edge_.source;
+    edge_.index = 0;
+  }
+}
+
+void FlatBoundsGraph::edge_iterator::increment() {
+  ++edge_.index;
+  skipExhausted_();
+}
+
+} // namespace DistanceGeometry
+} // namespace Molassembler
+} // namespace Scine
@@ -0,0 +1,366 @@
+/*!@file
+ * @copyright This code is licensed under the 3-clause BSD license.
+ *   Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.
+ *   See LICENSE.txt for details.
+ * @brief Flat edge-weighted graph for distance bounds
+ *
+ * Declares a directed edge-weighted graph with contiguous per-vertex out-edge
+ * storage for use in ExplicitBoundsGraph, along with the traits and functions
+ * necessary for interoperability with boost::graph algorithms.
+ */
+
+#ifndef INCLUDE_MOLASSEMBLER_DG_FLAT_BOUNDS_GRAPH_H
+#define INCLUDE_MOLASSEMBLER_DG_FLAT_BOUNDS_GRAPH_H
+
+#include "boost/graph/graph_traits.hpp"
+#include "boost/graph/properties.hpp"
+#include "boost/iterator/counting_iterator.hpp"
+#include "boost/iterator/iterator_facade.hpp"
+#include "boost/property_map/property_map.hpp"
+
+#include <limits>
+#include <vector>
+
+namespace Scine {
+namespace Molassembler {
+namespace DistanceGeometry {
+
+/*! @brief Directed edge-weighted graph with flat per-vertex edge storage
+ *
+ * A bounds graph over N atoms has vertices left(a) = 2a and right(a) = 2a + 1.
+ * Out-edges of each vertex are stored contiguously in a single array in order
+ * of insertion. Storage is proportional to the number of edges present, not
+ * to the number of possible edges, and copying the graph allocates once per
+ * vertex rather than once per edge.
+ *
+ * Edge lookup is linear in the out-degree of the source vertex.
+ */
+class FlatBoundsGraph {
+public:
+//!@name Member types
+//!@{
+  using VertexDescriptor = std::size_t;
+
+  //! Edges are identified by their source and position in its out-edges
+  struct EdgeDescriptor {
+    VertexDescriptor source = 0;
+    std::size_t index = 0;
+
+    inline bool operator == (const EdgeDescriptor& other) const {
+      return index == other.index && source == other.source;
+    }
+
+    inline bool operator != (const EdgeDescriptor& other) const {
+      return !(*this == other);
+    }
+  };
+
+  // BGL-style aliases
+  using vertex_descriptor = VertexDescriptor;
+  using edge_descriptor = EdgeDescriptor;
+
+  using vertex_iterator = boost::counting_iterator<VertexDescriptor>;
+
+  //! Iterator through the out-edges of a single vertex
+  class out_edge_iterator : public boost::iterator_facade<
+    out_edge_iterator,
+    EdgeDescriptor,
+    boost::forward_traversal_tag,
+    EdgeDescriptor
+  > {
+  public:
+    out_edge_iterator() = default;
+    out_edge_iterator(VertexDescriptor u, std::size_t index) : edge_ {u, index} {}
+
+  private:
+    friend class boost::iterator_core_access;
+
+    EdgeDescriptor edge_;
+
+    inline void increment() { ++edge_.index; }
+    inline bool equal(const out_edge_iterator& other) const { return edge_ == other.edge_; }
+    inline EdgeDescriptor dereference() const { return edge_; }
+  };
+
+  //! Iterator through all edges of the graph
+  class edge_iterator : public boost::iterator_facade<
+    edge_iterator,
+    EdgeDescriptor,
+    boost::forward_traversal_tag,
+    EdgeDescriptor
+  > {
+  public:
+    edge_iterator() = default;
+    edge_iterator(const FlatBoundsGraph& base, VertexDescriptor u);
+
+  private:
+    friend class boost::iterator_core_access;
+
+    const FlatBoundsGraph* basePtr_ = nullptr;
+    EdgeDescriptor edge_;
+
+    //! Advance to the next vertex with out-edges if the current one is exhausted
+    void skipExhausted_();
+
+    void increment();
+    inline bool equal(const edge_iterator& other) const { return edge_ == other.edge_; }
+    inline EdgeDescriptor dereference() const { return edge_; }
+  };
+
+  //! Read-only access to edge weights via edge descriptors
+  struct EdgeWeightMap : public boost::put_get_helper<double, EdgeWeightMap> {
+    using value_type = double;
+    using reference = double;
+    using key_type = EdgeDescriptor;
+    using category = boost::readable_property_map_tag;
+
+    const FlatBoundsGraph* basePtr;
+
+    explicit EdgeWeightMap(const FlatBoundsGraph& base) : basePtr(&base) {}
+
+    inline double operator [] (const EdgeDescriptor& e) const {
+      return basePtr->weight(e);
+    }
+  };
+
+  using VertexIndexMap = boost::typed_identity_property_map<VertexDescriptor>;
+//!@}
+
+//!@name Special member functions
+//!@{
+  //! Constructs an empty graph
+  FlatBoundsGraph() = default;
+
+  /*! @brief Constructs an edgeless graph for @p N atoms
+   *
+   * @complexity{@math{\Theta(N)}}
+   */
+  explicit FlatBoundsGraph(std::size_t N);
+//!@}
+
+//!@name Modifiers
+//!@{
+  /*! @brief Adds an edge to the graph
+   *
+   * @pre The edge does not exist yet
+   * @complexity{Amortized @math{\Theta(1)}}
+   */
+  void addEdge(VertexDescriptor u, VertexDescriptor v, double weight);
+
+  /*! @brief Sets an edge's weight, adding it if it does not exist yet
+   *
+   * @complexity{@math{O(D)} where @math{D} is the out-degree of @p u}
+   */
+  void updateOrAddEdge(VertexDescriptor u, VertexDescriptor v, double weight);
+//!@}
+
+//!@name Information
+//!@{
+  //! Number of vertices, i.e. twice the number of atoms
+  inline VertexDescriptor numVertices() const {
+    return outEdges_.size();
+  }
+
+  /*! @brief Number of edges
+   *
+   * @complexity{@math{\Theta(V)}}
+   */
+  std::size_t numEdges() const;
+
+  //! Number of out-edges of a vertex
+  inline std::size_t outDegree(const VertexDescriptor u) const {
+    return outEdges_[u].size();
+  }
+
+  /*! @brief Look up an edge
+   *
+   * @complexity{@math{O(D)} where @math{D} is the out-degree of @p u}
+   */
+  std::pair<EdgeDescriptor, bool> edge(VertexDescriptor u, VertexDescriptor v) const;
+
+  inline VertexDescriptor target(const EdgeDescriptor& e) const {
+    return outEdges_[e.source][e.index].target;
+  }
+
+  inline double weight(const EdgeDescriptor& e) const {
+    return outEdges_[e.source][e.index].weight;
+  }
+
+  inline out_edge_iterator obegin(const VertexDescriptor u) const {
+    return {u, 0};
+  }
+
+  inline out_edge_iterator oend(const VertexDescriptor u) const {
+    return {u, outEdges_[u].size()};
+  }
+
+  inline edge_iterator ebegin() const {
+    return {*this, 0};
+  }
+
+  inline edge_iterator eend() const {
+    return {*this, numVertices()};
+  }
+//!@}
+
+private:
+  struct OutEdge {
+    unsigned target;
+    double weight;
+  };
+
+  //! Out-edges of each vertex in order of insertion
+  std::vector<std::vector<OutEdge>> outEdges_;
+};
+
+} // namespace DistanceGeometry
+} // namespace Molassembler
+} // namespace Scine
+
+namespace boost {
+
+template<>
+struct graph_traits<Scine::Molassembler::DistanceGeometry::FlatBoundsGraph> {
+  // Shortcut typedef
+  using T = Scine::Molassembler::DistanceGeometry::FlatBoundsGraph;
+
+  struct traversal_category
+    : virtual vertex_list_graph_tag,
+      virtual edge_list_graph_tag,
+      virtual incidence_graph_tag,
+      virtual adjacency_matrix_tag {};
+
+  using vertex_descriptor = T::VertexDescriptor;
+  using edge_descriptor = T::EdgeDescriptor;
+
+  using directed_category = directed_tag;
+  using edge_parallel_category = disallow_parallel_edge_tag;
+
+  using vertices_size_type = std::size_t;
+  using edges_size_type = std::size_t;
+  using degree_size_type = std::size_t;
+
+  static vertex_descriptor null_vertex() {
+    return std::numeric_limits<vertex_descriptor>::max();
+  }
+
+  using vertex_iterator = T::vertex_iterator;
+  using edge_iterator = T::edge_iterator;
+  using out_edge_iterator = T::out_edge_iterator;
+};
+
+template<>
+struct graph_traits<const Scine::Molassembler::DistanceGeometry::FlatBoundsGraph>
+  : graph_traits<Scine::Molassembler::DistanceGeometry::FlatBoundsGraph> {};
+
+template<>
+struct property_map<Scine::Molassembler::DistanceGeometry::FlatBoundsGraph, edge_weight_t> {
+  using T = Scine::Molassembler::DistanceGeometry::FlatBoundsGraph;
+
+  using type = T::EdgeWeightMap;
+  using const_type = T::EdgeWeightMap;
+};
+
+template<>
+struct property_map<Scine::Molassembler::DistanceGeometry::FlatBoundsGraph, vertex_index_t> {
+  using T = Scine::Molassembler::DistanceGeometry::FlatBoundsGraph;
+
+  using type = T::VertexIndexMap;
+  using const_type = T::VertexIndexMap;
+};
+
+/* VertexListGraph concept */
+inline std::pair<
+  Scine::Molassembler::DistanceGeometry::FlatBoundsGraph::vertex_iterator,
+  Scine::Molassembler::DistanceGeometry::FlatBoundsGraph::vertex_iterator
+> vertices(const Scine::Molassembler::DistanceGeometry::FlatBoundsGraph& g) {
+  using Iter = Scine::Molassembler::DistanceGeometry::FlatBoundsGraph::vertex_iterator;
+  return {Iter {0}, Iter {g.numVertices()}};
+}
+
+inline std::size_t num_vertices(const Scine::Molassembler::DistanceGeometry::FlatBoundsGraph& g) {
+  return g.numVertices();
+}
+
+/* EdgeListGraph concept */
+inline std::pair<
+  Scine::Molassembler::DistanceGeometry::FlatBoundsGraph::edge_iterator,
+  Scine::Molassembler::DistanceGeometry::FlatBoundsGraph::edge_iterator
+> edges(const Scine::Molassembler::DistanceGeometry::FlatBoundsGraph& g) {
+  return {g.ebegin(), g.eend()};
+}
+
+inline std::size_t num_edges(const Scine::Molassembler::DistanceGeometry::FlatBoundsGraph& g) {
+  return g.numEdges();
+}
+
+inline std::size_t source(
+  const Scine::Molassembler::DistanceGeometry::FlatBoundsGraph::EdgeDescriptor& e,
+  const Scine::Molassembler::DistanceGeometry::FlatBoundsGraph& /* g */
+) {
+  return e.source;
+}
+
+inline std::size_t target(
+  const Scine::Molassembler::DistanceGeometry::FlatBoundsGraph::EdgeDescriptor& e,
+  const Scine::Molassembler::DistanceGeometry::FlatBoundsGraph& g
+) {
+  return g.target(e);
+}
+
+/* IncidenceGraph concept */
+inline std::pair<
+  Scine::Molassembler::DistanceGeometry::FlatBoundsGraph::out_edge_iterator,
+  Scine::Molassembler::DistanceGeometry::FlatBoundsGraph::out_edge_iterator
+> out_edges(
+  const std::size_t u,
+  const Scine::Molassembler::DistanceGeometry::FlatBoundsGraph& g
+) {
+  return {g.obegin(u), g.oend(u)};
+}
+
+inline std::size_t out_degree(
+  const std::size_t u,
+  const Scine::Molassembler::DistanceGeometry::FlatBoundsGraph& g
+) {
+  return g.outDegree(u);
+}
+
+/* AdjacencyMatrix concept */
+inline std::pair<
+  Scine::Molassembler::DistanceGeometry::FlatBoundsGraph::EdgeDescriptor,
+  bool
+> edge(
+  const std::size_t u,
+  const std::size_t v,
+  const Scine::Molassembler::DistanceGeometry::FlatBoundsGraph& g
+) {
+  return g.edge(u, v);
+}
+
+/* PropertyGraph concept */
+inline Scine::Molassembler::DistanceGeometry::FlatBoundsGraph::EdgeWeightMap get(
+  const edge_weight_t& /* tag */,
+  const Scine::Molassembler::DistanceGeometry::FlatBoundsGraph& g
+) {
+  return Scine::Molassembler::DistanceGeometry::FlatBoundsGraph::EdgeWeightMap {g};
+}
+
+inline double get(
+  const edge_weight_t& /* tag */,
+  const Scine::Molassembler::DistanceGeometry::FlatBoundsGraph& g,
+  const Scine::Molassembler::DistanceGeometry::FlatBoundsGraph::EdgeDescriptor& e
+) {
+  return g.weight(e);
+}
+
+inline Scine::Molassembler::DistanceGeometry::FlatBoundsGraph::VertexIndexMap get(
+  const vertex_index_t& /* tag */,
+  const Scine::Molassembler::DistanceGeometry::FlatBoundsGraph& /* g */
+) {
+  return {};
+}
+
+} // namespace boost
+
+#endif
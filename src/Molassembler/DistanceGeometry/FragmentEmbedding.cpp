@@ -0,0 +1,367 @@
+/*!@file
+ * @copyright This code is licensed under the 3-clause BSD license.
+ *   Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.
+ *   See LICENSE.txt for details.
+ */
+
+#include "Molassembler/DistanceGeometry/FragmentEmbedding.h"
+
+#include "Molassembler/DistanceGeometry/Error.h"
+#include "Molassembler/DistanceGeometry/MetricMatrix.h"
+#include "Molassembler/Graph/PrivateGraph.h"
+#include "Utils/Math/QuaternionFit.h"
+
+#include "Molassembler/Temple/Functional.h"
+#include "Molassembler/Temple/Random.h"
+
+#include "boost/optional.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <queue>
+
+namespace Scine {
+namespace Molassembler {
+namespace DistanceGeometry {
+namespace {
+
+//! Union-find over atom components with size tracking
+struct Components {
+  explicit Components(const unsigned N) : parents(N), sizes(N, 1) {
+    std::iota(std::begin(parents), std::end(parents), 0);
+  }
+
+  unsigned find(unsigned i) {
+    while(parents[i] != i) {
+      parents[i] = parents[parents[i]];
+      i = parents[i];
+    }
+    return i;
+  }
+
+  void join(unsigned a, unsigned b) {
+    a = find(a);
+    b = find(b);
+    if(a == b) {
+      return;
+    }
+    if(sizes[a] < sizes[b]) {
+      std::swap(a, b);
+    }
+    parents[b] = a;
+    sizes[a] += sizes[b];
+  }
+
+  std::vector<unsigned> parents;
+  std::vector<unsigned> sizes;
+};
+
+//! Index of a value in a sorted vector containing it
+unsigned sortedIndex(const std::vector<AtomIndex>& sorted, const AtomIndex i) {
+  const auto findIter = std::lower_bound(std::begin(sorted), std::end(sorted), i);
+  assert(findIter != std::end(sorted) && *findIter == i);
+  return findIter - std::begin(sorted);
+}
+
+/*! @brief Maps a constraint's sites into fragment-local atom indices
+ *
+ * @returns None if any site atom is not part of the fragment
+ */
+template<typename Constraint>
+boost::optional<Constraint> localConstraint(
+  const Constraint& constraint,
+  const std::vector<int>& localIndices
+) {
+  Constraint local = constraint;
+  for(auto& site : local.sites) {
+    for(AtomIndex& i : site) {
+      if(localIndices.at(i) < 0) {
+        return boost::none;
+      }
+      i = localIndices.at(i);
+    }
+  }
+  return local;
+}
+
+/*! @brief Embeds and refines a single fragment
+ *
+ * @returns Refined fragment positions with rows in order of @p atoms
+ */
+outcome::result<AngstromPositions> embedFragment(
+  const PrivateGraph& inner,
+  const MoleculeDGInformation& data,
+  const std::vector<AtomIndex>& atoms,
+  const Configuration& configuration,
+  Random::Engine& engine,
+  const Cancellation* const cancellationPtr
+) {
+  const unsigned N = inner.N();
+  const unsigned M = atoms.size();
+
+  std::vector<int> localIndices(N, -1);
+  for(unsigned i = 0; i < M; ++i) {
+    localIndices[atoms[i]] = i;
+  }
+
+  // Fragment graph. Bounds graphs only need its element types.
+  PrivateGraph fragmentGraph(M);
+  for(unsigned i = 0; i < M; ++i) {
+    fragmentGraph.elementType(i) = inner.elementType(atoms[i]);
+  }
+  for(const PrivateGraph::Edge& edge : inner.edges()) {
+    const int a = localIndices[inner.source(edge)];
+    const int b = localIndices[inner.target(edge)];
+    if(a >= 0 && b >= 0) {
+      fragmentGraph.addEdge(a, b, inner.bondType(edge));
+    }
+  }
+
+  auto fragmentDataPtr = std::make_shared<MoleculeDGInformation>();
+  fragmentDataPtr->boundsPtr = std::make_shared<SparseBounds>(
+    data.boundsPtr->subset(atoms)
+  );
+
+  for(const ChiralConstraint& constraint : data.chiralConstraints) {
+    if(auto localOption = localConstraint(constraint, localIndices)) {
+      fragmentDataPtr->chiralConstraints.push_back(std::move(localOption.value()));
+    }
+  }
+  for(const DihedralConstraint& constraint : data.dihedralConstraints) {
+    if(auto localOption = localConstraint(constraint, localIndices)) {
+      fragmentDataPtr->dihedralConstraints.push_back(std::move(localOption.value()));
+    }
+  }
+
+  auto smoothingResult = smoothBounds(*fragmentDataPtr, fragmentGraph);
+  if(!smoothingResult) {
+    return smoothingResult.as_failure();
+  }
+
+  ExplicitBoundsGraph explicitGraph = *fragmentDataPtr->boundsGraphPtr;
+  auto distanceMatrixResult = explicitGraph.makeDistanceMatrix(
+    engine,
+    configuration.partiality
+  );
+  if(!distanceMatrixResult) {
+    return distanceMatrixResult.as_failure();
+  }
+
+  MetricMatrix metric(std::move(distanceMatrixResult.value()));
+
+  if(cancellationPtr != nullptr && cancellationPtr->requested()) {
+    return DgError::Cancelled;
+  }
+
+  return refine(
+    metric.embed(),
+    *fragmentDataPtr->distanceBoundsPtr,
+    configuration,
+    fragmentDataPtr,
+    cancellationPtr
+  );
+}
+
+} // namespace
+
+Fragmentation Fragmentation::make(
+  const PrivateGraph& inner,
+  const MoleculeDGInformation::GroupMapType& rotatableGroups,
+  const unsigned targetSize
+) {
+  const unsigned N = inner.N();
+
+  /* Bridges between non-terminal atoms are candidates for cuts. Atoms
+   * connected by any other bond are always part of the same fragment.
+   */
+  const auto& bridges = inner.removalSafetyData().bridges;
+  Components components(N);
+  std::vector<BondIndex> candidates;
+  for(const PrivateGraph::Edge& edge : inner.edges()) {
+    const AtomIndex a = inner.source(edge);
+    const AtomIndex b = inner.target(edge);
+    if(bridges.count(edge) > 0 && inner.degree(a) > 1 && inner.degree(b) > 1) {
+      candidates.emplace_back(a, b);
+    } else {
+      components.join(a, b);
+    }
+  }
+
+  // Merge across rotatable bonds last so that cuts preferably lie on them
+  std::stable_sort(
+    std::begin(candidates),
+    std::end(candidates),
+    [&](const BondIndex& a, const BondIndex& b) -> bool {
+      return rotatableGroups.count(a) < rotatableGroups.count(b);
+    }
+  );
+
+  Fragmentation fragmentation;
+  for(const BondIndex& bond : candidates) {
+    const unsigned a = components.find(bond.first);
+    const unsigned b = components.find(bond.second);
+    if(components.sizes[a] + components.sizes[b] <= targetSize) {
+      components.join(a, b);
+    } else {
+      fragmentation.cutBonds.push_back(bond);
+    }
+  }
+
+  // Collect fragments in order of their smallest atom index
+  std::vector<int> fragmentIndices(N, -1);
+  for(AtomIndex i = 0; i < N; ++i) {
+    const unsigned root = components.find(i);
+    if(fragmentIndices[root] < 0) {
+      fragmentIndices[root] = fragmentation.fragments.size();
+      fragmentation.fragments.emplace_back();
+    }
+    fragmentation.fragments.at(fragmentIndices[root]).push_back(i);
+  }
+
+  // Extend each fragment by the nearby atoms across its cut bonds
+  fragmentation.extendedFragments = fragmentation.fragments;
+  for(const BondIndex& bond : fragmentation.cutBonds) {
+    for(const AtomIndex i : bond) {
+      const AtomIndex j = (i == bond.first) ? bond.second : bond.first;
+      auto& extended = fragmentation.extendedFragments.at(
+        fragmentIndices[components.find(i)]
+      );
+      extended.push_back(j);
+      for(const AtomIndex k : inner.adjacents(j)) {
+        extended.push_back(k);
+      }
+    }
+  }
+  for(auto& extended : fragmentation.extendedFragments) {
+    Temple::sort(extended);
+    extended.erase(std::unique(std::begin(extended), std::end(extended)), std::end(extended));
+  }
+
+  return fragmentation;
+}
+
+outcome::result<Eigen::MatrixXd> embedFragments(
+  const PrivateGraph& inner,
+  const MoleculeDGInformation& data,
+  const Fragmentation& fragmentation,
+  const Configuration& configuration,
+  Random::Engine& engine,
+  const Cancellation* const cancellationPtr
+) {
+  const unsigned N = inner.N();
+  const unsigned F = fragmentation.fragments.size();
+
+  // Seeds are drawn sequentially so results are independent of scheduling
+  const auto seeds = Temple::Random::getN<int>(
+    0,
+    std::numeric_limits<int>::max(),
+    F,
+    engine
+  );
+
+  std::vector<outcome::result<AngstromPositions>> results(
+    F,
+    outcome::result<AngstromPositions>(DgError::UnknownException)
+  );
+
+  /* Within an enclosing parallel region (e.g. ensemble generation), this
+   * nested region is inactive and fragments are embedded sequentially.
+   * Exceptions must not escape the parallel region, so a fragment whose
+   * embedding throws keeps its unknown exception result.
+   */
+#pragma omp parallel for schedule(dynamic)
+  for(unsigned f = 0; f < F; ++f) {
+    Random::Engine fragmentEngine(seeds.at(f));
+    try {
+      results.at(f) = embedFragment(
+        inner,
+        data,
+        fragmentation.extendedFragments.at(f),
+        configuration,
+        fragmentEngine,
+        cancellationPtr
+      );
+    } catch(...) {}
+  }
+
+  for(const auto& result : results) {
+    if(!result) {
+      return result.as_failure();
+    }
+  }
+
+  // Adjacency of fragments across cut bonds
+  std::vector<unsigned> fragmentOf(N);
+  for(unsigned f = 0; f < F; ++f) {
+    for(const AtomIndex i : fragmentation.fragments.at(f)) {
+      fragmentOf[i] = f;
+    }
+  }
+  std::vector<std::vector<unsigned>> adjacentFragments(F);
+  for(const BondIndex& bond : fragmentation.cutBonds) {
+    const unsigned a = fragmentOf[bond.first];
+    const unsigned b = fragmentOf[bond.second];
+    adjacentFragments.at(a).push_back(b);
+    adjacentFragments.at(b).push_back(a);
+  }
+
+  /* Place fragments breadth-first. Each newly placed fragment is superimposed
+   * onto the placed coordinates of the atoms it shares with the fragment it is
+   * reached from.
+   */
+  std::vector<Eigen::MatrixXd> placed(F);
+  std::vector<bool> isPlaced(F, false);
+  std::queue<unsigned> placementQueue;
+  placed.front() = results.front().value().positions;
+  isPlaced.front() = true;
+  placementQueue.push(0);
+  while(!placementQueue.empty()) {
+    const unsigned p = placementQueue.front();
+    placementQueue.pop();
+    const auto& extendedP = fragmentation.extendedFragments.at(p);
+
+    for(const unsigned q : adjacentFragments.at(p)) {
+      if(isPlaced.at(q)) {
+        continue;
+      }
+
+      const auto& extendedQ = fragmentation.extendedFragments.at(q);
+      const Eigen::MatrixXd& local = results.at(q).value().positions;
+      Eigen::MatrixXd reference = Eigen::MatrixXd::Zero(extendedQ.size(), 3);
+      Eigen::VectorXd weights = Eigen::VectorXd::Zero(extendedQ.size());
+      for(unsigned i = 0; i < extendedQ.size(); ++i) {
+        const auto findIter = std::lower_bound(
+          std::begin(extendedP),
+          std::end(extendedP),
+          extendedQ.at(i)
+        );
+        if(findIter != std::end(extendedP) && *findIter == extendedQ.at(i)) {
+          reference.row(i) = placed.at(p).row(findIter - std::begin(extendedP));
+          weights(i) = 1;
+        }
+      }
+
+      Utils::QuaternionFit fit(reference, local, weights);
+      placed.at(q) = fit.getFittedData();
+      isPlaced.at(q) = true;
+      placementQueue.push(q);
+    }
+  }
+
+  assert(std::all_of(std::begin(isPlaced), std::end(isPlaced), [](bool x) { return x; }));
+
+  // Each atom's position is taken from the fragment it belongs to
+  Eigen::MatrixXd embedded = Eigen::MatrixXd::Zero(4, N);
+  for(unsigned f = 0; f < F; ++f) {
+    const auto& extended = fragmentation.extendedFragments.at(f);
+    for(const AtomIndex i : fragmentation.fragments.at(f)) {
+      embedded.col(i).head<3>() = placed.at(f).row(sortedIndex(extended, i)).transpose();
+    }
+  }
+
+  return embedded;
+}
+
+} // namespace DistanceGeometry
+} // namespace Molassembler
+} // namespace Scine
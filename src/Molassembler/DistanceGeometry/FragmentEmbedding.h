@@ -0,0 +1,87 @@
+/*!@file
+ * @copyright This code is licensed under the 3-clause BSD license.
+ *   Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.
+ *   See LICENSE.txt for details.
+ * @brief Divide-and-conquer embedding of large molecules
+ *
+ * Metrization and embedding of a whole molecule scale cubically in the number
+ * of atoms. For very large molecules, the molecule can instead be split into
+ * fragments along bridge bonds. The fragments are embedded and refined
+ * independently, and their coordinates are assembled by superimposing the
+ * atoms shared between adjacent fragments. The assembled coordinates then
+ * serve as the starting point for refinement of the whole molecule, in which
+ * most intra-fragment distance terms are already satisfied and hence pruned.
+ */
+
+#ifndef INCLUDE_MOLASSEMBLER_DISTANCE_GEOMETRY_FRAGMENT_EMBEDDING_H
+#define INCLUDE_MOLASSEMBLER_DISTANCE_GEOMETRY_FRAGMENT_EMBEDDING_H
+
+#include "Molassembler/DistanceGeometry/ConformerGeneration.h"
+
+namespace Scine {
+namespace Molassembler {
+namespace DistanceGeometry {
+
+//! @brief Partition of a molecule into fragments joined by bridge bonds
+struct Fragmentation {
+  /*! @brief Splits a molecule into fragments along bridge bonds
+   *
+   * Bridge bonds between non-terminal atoms are candidates for cuts. The
+   * connected components remaining after removing all candidates are merged
+   * across candidate bonds as long as the merged fragment does not exceed
+   * @p targetSize atoms. Rotatable bonds are merged across last so that cuts
+   * preferably lie on them. Fragments can be larger than @p targetSize if the
+   * molecule offers no suitable bridge bonds, e.g. in large cyclic systems.
+   *
+   * @param inner Molecular graph
+   * @param rotatableGroups Rotatable bonds of the molecule
+   * @param targetSize Maximum number of atoms to merge fragments up to
+   *
+   * @complexity{@math{\Theta(N + B \log B)}}
+   */
+  static Fragmentation make(
+    const PrivateGraph& inner,
+    const MoleculeDGInformation::GroupMapType& rotatableGroups,
+    unsigned targetSize
+  );
+
+  //! Atoms of each fragment, sorted
+  std::vector<std::vector<AtomIndex>> fragments;
+  /*! @brief Atoms of each fragment and the atoms nearby across cut bonds, sorted
+   *
+   * For each cut bond, the atom on the other side and its neighbors are
+   * included. Adjacent fragments then share at least the atoms of the cut bond
+   * and their neighbors, which suffices to superimpose them.
+   */
+  std::vector<std::vector<AtomIndex>> extendedFragments;
+  //! Bonds between fragments
+  std::vector<BondIndex> cutBonds;
+};
+
+/*! @brief Embeds and refines fragments independently and assembles them
+ *
+ * Each fragment is embedded from the pairwise bounds, chiral and dihedral
+ * constraints of @p data that involve only its extended fragment atoms.
+ * Fragments are generated in an OpenMP parallel loop. Within an enclosing
+ * parallel region, e.g. in ensemble generation, that loop is inactive and
+ * fragments are generated sequentially. Each fragment has its own engine
+ * seeded from @p engine, so results do not depend on scheduling.
+ *
+ * @returns Assembled positions in the format of MetricMatrix::embed, i.e. a
+ *   four by N matrix whose columns are atom positions, with a zero fourth
+ *   dimension. If any fragment fails to embed, that fragment's error.
+ */
+outcome::result<Eigen::MatrixXd> embedFragments(
+  const PrivateGraph& inner,
+  const MoleculeDGInformation& data,
+  const Fragmentation& fragmentation,
+  const Configuration& configuration,
+  Random::Engine& engine,
+  const Cancellation* cancellationPtr = nullptr
+);
+
+} // namespace DistanceGeometry
+} // namespace Molassembler
+} // namespace Scine
+
+#endif
@@ -8,10 +8,78 @@
 #include "Molassembler/Types.h"
 
 #include <Eigen/Eigenvalues>
+#include <Eigen/QR>
+#include "boost/optional.hpp"
+
+#include <cmath>
 
 namespace Scine {
 namespace Molassembler {
 namespace DistanceGeometry {
+namespace {
+
+constexpr unsigned dimensionality = 4;
+
+/*! @brief Calculates embedded coordinates from the largest eigenpairs
+ *
+ * @param eigenvalues Up to four eigenvalues in decreasing order
+ * @param eigenvectors Corresponding eigenvectors as columns
+ *
+ * @returns A 4 x N matrix whose columns are particle coordinates
+ */
+Eigen::MatrixXd embedEigenpairs(
+  const Eigen::VectorXd& eigenvalues,
+  const Eigen::MatrixXd& eigenvectors
+) {
+  const unsigned numEigenvalues = std::min(
+    static_cast<unsigned>(eigenvalues.size()),
+    dimensionality
+  );
+
+  // Construct L. Only eigenpairs with positive eigenvalues are used.
+  Eigen::MatrixXd L = Eigen::MatrixXd::Zero(dimensionality, dimensionality);
+  for(unsigned i = 0; i < numEigenvalues; ++i) {
+    if(eigenvalues(i) > 0) {
+      L.diagonal()(i) = std::sqrt(eigenvalues(i));
+    }
+  }
+
+  // V is N x dimensionality, zero-padded if there are fewer eigenpairs
+  Eigen::MatrixXd V = Eigen::MatrixXd::Zero(eigenvectors.rows(), dimensionality);
+  V.leftCols(numEigenvalues) = eigenvectors.leftCols(numEigenvalues);
+
+  /* Calculate X = VL
+   * (N x 4) · (4 x 4) -> (N x 4), but we want (4 x N), so we transpose
+   */
+  return (V * L).transpose();
+}
+
+/*! @brief Rayleigh-Ritz procedure for the algebraically largest eigenpairs
+ *
+ * @param basis Orthonormal basis of the search subspace
+ * @param imageBasis Matrix product of the metric matrix with @p basis
+ * @param m Number of eigenpairs to extract
+ *
+ * @returns Ritz values in decreasing order and the corresponding coefficients
+ *   of the Ritz vectors in @p basis
+ */
+std::pair<Eigen::VectorXd, Eigen::MatrixXd> rayleighRitz(
+  const Eigen::MatrixXd& basis,
+  const Eigen::MatrixXd& imageBasis,
+  const unsigned m
+) {
+  Eigen::MatrixXd projected = basis.transpose() * imageBasis;
+  projected = (projected + projected.transpose()).eval() / 2;
+
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigenSolver(projected);
+  // Eigenpairs are sorted by increasing eigenvalue, but we want the largest
+  return {
+    eigenSolver.eigenvalues().tail(m).reverse(),
+    eigenSolver.eigenvectors().rightCols(m).rowwise().reverse()
+  };
+}
+
+} // namespace
 
 void MetricMatrix::constructFromTemporary_(Eigen::MatrixXd&& distances) {
   /* We have to be a little careful since only strict upper triangle of
@@ -105,49 +173,131 @@ const Eigen::MatrixXd& MetricMatrix::access() const {
 }
 
 Eigen::MatrixXd MetricMatrix::embed() const {
+  constexpr unsigned partialDiagonalizationThreshold = 150;
+  if(matrix_.rows() > partialDiagonalizationThreshold) {
+    if(auto embeddingOption = embedWithPartialDiagonalization()) {
+      return std::move(embeddingOption.value());
+    }
+  }
+
   return embedWithFullDiagonalization();
 }
 
 Eigen::MatrixXd MetricMatrix::embedWithFullDiagonalization() const {
-  constexpr unsigned dimensionality = 4;
-
   // SelfAdjointEigenSolver only references the lower triangle
   Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigenSolver(matrix_);
 
-  Eigen::VectorXd eigenvalues = eigenSolver.eigenvalues();
-
-  // Construct L
-  Eigen::MatrixXd L = Eigen::MatrixXd::Zero(dimensionality, dimensionality);
-  // We want the algebraically largest eigenvalues (up to four, if present)
-  unsigned numEigenvalues = std::min(
-    static_cast<unsigned>(eigenvalues.size()),
+  /* Since Eigen stores eigenpairs in increasing order of eigenvalues, we have
+   * to fetch the algebraically largest from the back.
+   */
+  const unsigned numEigenvalues = std::min(
+    static_cast<unsigned>(matrix_.rows()),
     dimensionality
   );
-  for(unsigned i = 0; i < numEigenvalues; ++i) {
-    /* Since Eigen stores them in increasing order, we have to fetch the
-     * algebraically largest from the back. We only want to use the eigenpair
-     * if the eigenvalue is greater than zero.
-     */
-    if(eigenvalues(eigenvalues.size() - i - 1) > 0) {
-      L.diagonal()(i) = std::sqrt(
-        eigenvalues(eigenvalues.size() - i - 1)
-      );
-    }
-  }
+  return embedEigenpairs(
+    eigenSolver.eigenvalues().tail(numEigenvalues).reverse(),
+    eigenSolver.eigenvectors().rightCols(numEigenvalues).rowwise().reverse()
+  );
+}
 
-  // V is initially N x N
-  Eigen::MatrixXd V = eigenSolver.eigenvectors();
-  /* Again, eigenvectors are sorted in increasing corresponding eigenvalues
-   * algebraic value. We have to reverse them to match the ordering in L.
+boost::optional<Eigen::MatrixXd> MetricMatrix::embedWithPartialDiagonalization() const {
+  constexpr unsigned iterationLimit = 500;
+  constexpr double residualTolerance = 1e-8;
+
+  const unsigned N = matrix_.rows();
+  /* Additional guard vectors in the block improve convergence of the four
+   * wanted eigenpairs. For very small matrices, there is nothing to gain.
    */
-  V.rowwise().reverseInPlace();
-  V.conservativeResize(V.rows(), dimensionality);
-  // now N x dimensionality
+  const unsigned m = 2 * dimensionality;
+  if(N <= 3 * m) {
+    return embedWithFullDiagonalization();
+  }
 
-  /* Calculate X = VL
-   * (N x 4) · (4 x 4) -> (N x 4), but we want (4 x N), so we transpose
+  // Only the lower triangle is set
+  const auto A = matrix_.selfadjointView<Eigen::Lower>();
+
+  /* Deterministic starting block, improved by a single power iteration. Using
+   * the randomness engine would alter the sequence of subsequent random
+   * numbers depending on the embedding method.
    */
-  return (V * L).transpose();
+  Eigen::MatrixXd X(N, m);
+  for(unsigned j = 0; j < m; ++j) {
+    for(unsigned i = 0; i < N; ++i) {
+      X(i, j) = std::cos((i + 1.0) * (j + 1.0));
+    }
+  }
+  X = (A * X).eval();
+  X = Eigen::HouseholderQR<Eigen::MatrixXd>(X).householderQ() * Eigen::MatrixXd::Identity(N, m);
+  Eigen::MatrixXd AX = A * X;
+
+  auto ritz = rayleighRitz(X, AX, m);
+  X = X * ritz.second;
+  AX = AX * ritz.second;
+  Eigen::VectorXd& ritzValues = ritz.first;
+
+  // Search directions from the previous iteration
+  Eigen::MatrixXd P(N, 0);
+
+  for(unsigned iteration = 0; iteration < iterationLimit; ++iteration) {
+    const Eigen::MatrixXd R = AX - X * ritzValues.asDiagonal();
+
+    // Check convergence of the wanted eigenpairs
+    const double scale = std::max(
+      ritzValues.cwiseAbs().maxCoeff(),
+      std::numeric_limits<double>::min()
+    );
+    bool converged = true;
+    for(unsigned i = 0; i < dimensionality; ++i) {
+      if(R.col(i).norm() > residualTolerance * scale) {
+        converged = false;
+        break;
+      }
+    }
+
+    if(converged) {
+      return embedEigenpairs(
+        ritzValues.head(dimensionality),
+        X.leftCols(dimensionality)
+      );
+    }
+
+    /* Orthonormalize residuals and previous search directions against the
+     * current Ritz vectors and each other, discarding linearly dependent
+     * directions
+     */
+    Eigen::MatrixXd W(N, R.cols() + P.cols());
+    W << R, P;
+    for(unsigned repeat = 0; repeat < 2; ++repeat) {
+      W -= X * (X.transpose() * W);
+    }
+
+    Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(W);
+    qr.setThreshold(1e-10);
+    const unsigned rank = qr.rank();
+    if(rank == 0) {
+      break;
+    }
+    Eigen::MatrixXd Q = qr.householderQ() * Eigen::MatrixXd::Identity(N, rank);
+    Q -= X * (X.transpose() * Q);
+    Q = Eigen::HouseholderQR<Eigen::MatrixXd>(Q).householderQ() * Eigen::MatrixXd::Identity(N, rank);
+
+    const Eigen::MatrixXd AQ = A * Q;
+
+    Eigen::MatrixXd S(N, m + rank);
+    S << X, Q;
+    Eigen::MatrixXd AS(N, m + rank);
+    AS << AX, AQ;
+
+    ritz = rayleighRitz(S, AS, m);
+    const Eigen::MatrixXd& coefficients = ritz.second;
+
+    // New search directions are the components outside the current Ritz vectors
+    P = Q * coefficients.bottomRows(rank);
+    X = S * coefficients;
+    AX = AS * coefficients;
+  }
+
+  return boost::none;
 }
 
 bool MetricMatrix::operator == (const MetricMatrix& other) const {
@@ -26,6 +26,7 @@
 #define INCLUDE_MOLASSEMBLER_DISTANCE_GEOMETRY_METRIC_MATRIX_H
 
 #include <Eigen/Core>
+#include "boost/optional/optional_fwd.hpp"
 
 #include "Molassembler/DistanceGeometry/DistanceGeometry.h"
 
@@ -51,9 +52,9 @@ public:
    * Embeds itself into 4D space, returning a dynamically sized Matrix where
    * every column vector is the coordinates of a particle.
    *
-   * @note For Molecules of size 20 and lower, employs full diagonalization. If
-   * larger, attempts to calculate only the required eigenpairs. If that fails,
-   * falls back on full diagonalization.
+   * @note For Molecules of size 150 and lower, employs full diagonalization.
+   * If larger, attempts to calculate only the required eigenpairs. If that
+   * fails, falls back on full diagonalization.
    */
   Eigen::MatrixXd embed() const;
 
@@ -66,10 +67,22 @@ public:
    * @complexity{@math{\Theta(9 N^3)} for the eigenvalue decomposition per
    * Eigen's documentation}
    *
-   * @note Faster for roughly N < 20
+   * @note Faster for roughly N < 150
    */
   Eigen::MatrixXd embedWithFullDiagonalization() const;
 
+  /*! @brief Implements embedding employing partial diagonalization
+   *
+   * Calculates only the four algebraically largest eigenpairs with the
+   * locally optimal block preconditioned conjugate gradient method (LOBPCG).
+   *
+   * @complexity{@math{\Theta(N^2)} per iteration. The number of iterations
+   * depends on the gap between the fourth and fifth largest eigenvalues.}
+   *
+   * @returns None if the eigenpairs do not converge
+   */
+  boost::optional<Eigen::MatrixXd> embedWithPartialDiagonalization() const;
+
 /* Operators */
   bool operator == (const MetricMatrix& other) const;
 
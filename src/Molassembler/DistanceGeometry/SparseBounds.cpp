@@ -0,0 +1,194 @@
+/*!@file
+ * @copyright This code is licensed under the 3-clause BSD license.
+ *   Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.
+ *   See LICENSE.txt for details.
+ */
+
+#include "Molassembler/DistanceGeometry/SparseBounds.h"
+
+#include "Molassembler/DistanceGeometry/DistanceBoundsMatrix.h"
+#include "Molassembler/Graph/PrivateGraph.h"
+#include "Molassembler/Modeling/AtomInfo.h"
+
+#include "boost/optional.hpp"
+
+#include <algorithm>
+
+namespace Scine {
+namespace Molassembler {
+namespace DistanceGeometry {
+namespace {
+
+bool partnerLess(const SparseBounds::Entry& entry, const AtomIndex j) {
+  return entry.partner < j;
+}
+
+} // namespace
+
+SparseBounds::SparseBounds(const PrivateGraph& inner)
+  : vdwRadii_(inner.N()),
+    entries_(inner.N())
+{
+  const AtomIndex N = inner.N();
+  for(AtomIndex i = 0; i < N; ++i) {
+    vdwRadii_[i] = AtomInfo::vdwRadius(inner.elementType(i));
+  }
+}
+
+SparseBounds::SparseBounds(
+  const PrivateGraph& inner,
+  const Eigen::MatrixXd& bounds
+) : SparseBounds(inner) {
+  const AtomIndex N = inner.N();
+  assert(
+    static_cast<AtomIndex>(bounds.rows()) == N
+    && static_cast<AtomIndex>(bounds.cols()) == N
+  );
+  for(AtomIndex i = 0; i < N; ++i) {
+    for(AtomIndex j = i + 1; j < N; ++j) {
+      const double lower = bounds(j, i);
+      const double upper = bounds(i, j);
+      if(lower != 0.0 || upper != 0.0) {
+        entries_[i].push_back(Entry {j, ValueBounds {lower, upper}});
+      }
+    }
+  }
+}
+
+std::vector<SparseBounds::Entry>::iterator SparseBounds::find_(
+  AtomIndex i,
+  AtomIndex j
+) {
+  assert(i != j);
+  if(j < i) {
+    std::swap(i, j);
+  }
+
+  auto& row = entries_.at(i);
+  auto findIter = std::lower_bound(std::begin(row), std::end(row), j, partnerLess);
+  if(findIter == std::end(row) || findIter->partner != j) {
+    findIter = row.insert(findIter, Entry {j, ValueBounds {0.0, 0.0}});
+  }
+  return findIter;
+}
+
+void SparseBounds::add(
+  const AtomIndex i,
+  const AtomIndex j,
+  const ValueBounds& bounds
+) {
+  /* As in SpatialModel::BoundsMatrixHelper::add, overlapping information may
+   * only ever raise the lower bound and lower the upper bound without
+   * inverting the bounds.
+   */
+  ValueBounds& stored = find_(i, j)->bounds;
+  assert(bounds.lower <= bounds.upper);
+  assert(stored.lower <= stored.upper);
+
+  if(stored.lower != 0.0 && stored.upper != 0.0) {
+    if(bounds.lower > stored.lower && bounds.lower < stored.upper) {
+      stored.lower = bounds.lower;
+    }
+
+    if(bounds.upper < stored.upper && bounds.upper > stored.lower) {
+      stored.upper = bounds.upper;
+    }
+  } else {
+    stored = bounds;
+  }
+}
+
+void SparseBounds::set(
+  const AtomIndex i,
+  const AtomIndex j,
+  const ValueBounds& bounds
+) {
+  find_(i, j)->bounds = bounds;
+}
+
+AtomIndex SparseBounds::N() const {
+  return vdwRadii_.size();
+}
+
+unsigned SparseBounds::explicitCount() const {
+  unsigned count = 0;
+  for(const auto& row : entries_) {
+    count += row.size();
+  }
+  return count;
+}
+
+boost::optional<ValueBounds> SparseBounds::explicitBounds(
+  AtomIndex i,
+  AtomIndex j
+) const {
+  if(j < i) {
+    std::swap(i, j);
+  }
+
+  const auto& row = entries_.at(i);
+  const auto findIter = std::lower_bound(std::begin(row), std::end(row), j, partnerLess);
+  if(findIter == std::end(row) || findIter->partner != j) {
+    return boost::none;
+  }
+
+  return findIter->bounds;
+}
+
+ValueBounds SparseBounds::bounds(const AtomIndex i, const AtomIndex j) const {
+  if(auto explicitOption = explicitBounds(i, j)) {
+    return explicitOption.value();
+  }
+
+  return ValueBounds {impliedLower(i, j), DistanceBoundsMatrix::defaultUpper};
+}
+
+double SparseBounds::impliedLower(const AtomIndex i, const AtomIndex j) const {
+  return vdwRadii_.at(i) + vdwRadii_.at(j);
+}
+
+const std::vector<SparseBounds::Entry>& SparseBounds::entries(const AtomIndex i) const {
+  return entries_.at(i);
+}
+
+SparseBounds SparseBounds::subset(const std::vector<AtomIndex>& atoms) const {
+  assert(std::is_sorted(std::begin(atoms), std::end(atoms)));
+  const AtomIndex M = atoms.size();
+
+  std::vector<int> localIndices(N(), -1);
+  for(AtomIndex k = 0; k < M; ++k) {
+    localIndices.at(atoms[k]) = k;
+  }
+
+  SparseBounds sub;
+  sub.vdwRadii_.resize(M);
+  sub.entries_.resize(M);
+  for(AtomIndex k = 0; k < M; ++k) {
+    sub.vdwRadii_[k] = vdwRadii_.at(atoms[k]);
+    // Since atoms are sorted, partners remain sorted and of greater index
+    for(const Entry& entry : entries_.at(atoms[k])) {
+      const int l = localIndices.at(entry.partner);
+      if(l >= 0) {
+        sub.entries_[k].push_back(Entry {static_cast<AtomIndex>(l), entry.bounds});
+      }
+    }
+  }
+
+  return sub;
+}
+
+Eigen::MatrixXd SparseBounds::dense() const {
+  const AtomIndex size = N();
+  Eigen::MatrixXd matrix = Eigen::MatrixXd::Zero(size, size);
+  for(AtomIndex i = 0; i < size; ++i) {
+    for(const Entry& entry : entries_[i]) {
+      matrix(entry.partner, i) = entry.bounds.lower;
+      matrix(i, entry.partner) = entry.bounds.upper;
+    }
+  }
+  return matrix;
+}
+
+} // namespace DistanceGeometry
+} // namespace Molassembler
+} // namespace Scine
@@ -0,0 +1,164 @@
+/*!@file
+ * @copyright This code is licensed under the 3-clause BSD license.
+ *   Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.
+ *   See LICENSE.txt for details.
+ * @brief Sparse storage of atom-pairwise distance bounds
+ */
+
+#ifndef INCLUDE_MOLASSEMBLER_DISTANCE_GEOMETRY_SPARSE_BOUNDS_H
+#define INCLUDE_MOLASSEMBLER_DISTANCE_GEOMETRY_SPARSE_BOUNDS_H
+
+#include "Molassembler/DistanceGeometry/ValueBounds.h"
+#include "Molassembler/Types.h"
+
+#include <Eigen/Core>
+#include "boost/optional/optional_fwd.hpp"
+
+#include <vector>
+
+namespace Scine {
+namespace Molassembler {
+
+// Forward-declarations
+class PrivateGraph;
+
+namespace DistanceGeometry {
+
+/**
+ * @brief Atom-pairwise distance bounds storing only explicitly modeled pairs
+ *
+ * Spatial modeling yields explicit bounds only for atom pairs separated by
+ * few bonds. All other pairs merely have an implied lower bound of the sum of
+ * their atoms' van der Waals radii, as in the bounds graphs. Storing only the
+ * explicit pairs makes the pairwise bounds roughly linear in the number of
+ * atoms.
+ *
+ * @note This covers only the pairwise bounds of MoleculeDGInformation.
+ * Embedding remains quadratic in memory: the triangle-smoothed
+ * DistanceBoundsMatrix shared by all conformers, the implied lower bound edges
+ * of each ExplicitBoundsGraph and each conformer's distance and metric
+ * matrices are dense. Refinement squares the shared smoothed bounds on access
+ * instead of copying them.
+ *
+ * Each atom's explicit pairs with atoms of greater index are kept in a vector
+ * sorted by that index.
+ */
+class SparseBounds {
+public:
+//!@name Member types
+//!@{
+  //! Explicit bounds on a pair with an atom of greater index
+  struct Entry {
+    AtomIndex partner;
+    ValueBounds bounds;
+  };
+//!@}
+
+//!@name Special member functions
+//!@{
+  SparseBounds() = default;
+
+  /*! @brief Construct without explicit bounds for the atoms of a graph
+   *
+   * @complexity{@math{\Theta(N)}}
+   */
+  explicit SparseBounds(const PrivateGraph& inner);
+
+  /*! @brief Construct from a dense bounds matrix
+   *
+   * Pairs whose lower and upper bounds are both zero are implied.
+   *
+   * @param inner Graph whose atoms' van der Waals radii imply bounds
+   * @param bounds Lower bounds in the strict lower triangle, upper bounds in
+   *   the strict upper triangle
+   *
+   * @complexity{@math{\Theta(N^2)}}
+   */
+  SparseBounds(const PrivateGraph& inner, const Eigen::MatrixXd& bounds);
+//!@}
+
+//!@name Modification
+//!@{
+  /*! @brief Merges bounds into a pair's explicit bounds
+   *
+   * If the pair has no explicit bounds yet, sets them. Otherwise, only raises
+   * the lower bound and lowers the upper bound, never inverting them.
+   *
+   * @complexity{@math{O(P)} where @math{P} is the number of explicit pairs of
+   * the smaller index}
+   */
+  void add(AtomIndex i, AtomIndex j, const ValueBounds& bounds);
+
+  /*! @brief Overwrites a pair's explicit bounds
+   *
+   * @complexity{@math{O(P)} where @math{P} is the number of explicit pairs of
+   * the smaller index}
+   */
+  void set(AtomIndex i, AtomIndex j, const ValueBounds& bounds);
+//!@}
+
+//!@name Information
+//!@{
+  //! Number of atoms
+  AtomIndex N() const;
+
+  //! Number of explicitly bounded pairs
+  unsigned explicitCount() const;
+
+  /*! @brief Explicit bounds of a pair, if any
+   *
+   * @complexity{@math{O(\log P)} where @math{P} is the number of explicit
+   * pairs of the smaller index}
+   */
+  boost::optional<ValueBounds> explicitBounds(AtomIndex i, AtomIndex j) const;
+
+  /*! @brief Bounds of a pair, implied if not explicit
+   *
+   * Implied bounds are the sum of van der Waals radii and
+   * DistanceBoundsMatrix::defaultUpper.
+   *
+   * @complexity{@math{O(\log P)} where @math{P} is the number of explicit
+   * pairs of the smaller index}
+   */
+  ValueBounds bounds(AtomIndex i, AtomIndex j) const;
+
+  //! Implied lower bound of a pair from van der Waals radii
+  double impliedLower(AtomIndex i, AtomIndex j) const;
+
+  /*! @brief Explicit pairs of an atom with atoms of greater index
+   *
+   * @complexity{@math{\Theta(1)}}
+   */
+  const std::vector<Entry>& entries(AtomIndex i) const;
+
+  /*! @brief Bounds restricted to a subset of atoms
+   *
+   * @param atoms Sorted atom indices. Atom @p atoms[k] is atom k of the
+   *   result.
+   *
+   * @complexity{@math{O(N + M \cdot P \log M)} for @math{M} atoms in the
+   * subset}
+   */
+  SparseBounds subset(const std::vector<AtomIndex>& atoms) const;
+
+  /*! @brief Dense bounds matrix with zeros for implied pairs
+   *
+   * The format matches SpatialModel::BoundsMatrix.
+   *
+   * @complexity{@math{\Theta(N^2)}}
+   */
+  Eigen::MatrixXd dense() const;
+//!@}
+
+private:
+  std::vector<double> vdwRadii_;
+  std::vector<std::vector<Entry>> entries_;
+
+  std::vector<Entry>::iterator find_(AtomIndex i, AtomIndex j);
+};
+
+} // namespace DistanceGeometry
+} // namespace Molassembler
+} // namespace Scine
+
+#endif
@@ -98,6 +98,133 @@ Eigen::Vector3d averagePosition(
   return mean / siteAtoms.size();
 }
 
+using PermutatorPair = std::pair<const AtomStereopermutator&, const AtomStereopermutator&>;
+
+// Match atom stereopermutators to the order in a bond stereopermutator's Composite
+PermutatorPair orderByComposite(
+  const BondStereopermutator& permutator,
+  const AtomStereopermutator& stereopermutatorA,
+  const AtomStereopermutator& stereopermutatorB
+) {
+  if(stereopermutatorA.placement() == permutator.composite().orientations().first.identifier)  {
+    return {stereopermutatorA, stereopermutatorB};
+  }
+
+  return {stereopermutatorB, stereopermutatorA};
+}
+
+/* Calls a function with the site indices of each modeled dihedral of an
+ * assigned bond stereopermutator, its bounds and whether a dihedral constraint
+ * is to be emitted for it
+ */
+template<typename F>
+void forEachModeledDihedral(
+  const BondStereopermutator& permutator,
+  const PermutatorPair& atomPermutators,
+  const double looseningMultiplier,
+  F&& f
+) {
+  const Stereopermutations::Composite& composite = permutator.composite();
+  const unsigned permutation = permutator.indexOfPermutation().value();
+  const auto& dihedrals = composite.allPermutations().at(permutation).dihedrals;
+  const auto& firstDihedral = dihedrals.front();
+  const auto vertexCountPair = composite.orders();
+  const bool leftIsSideWithMoreVertices = vertexCountPair.first < vertexCountPair.second;
+
+  Shapes::Vertex firstShapePosition;
+  Shapes::Vertex secondShapePosition;
+  double dihedralAngle;
+
+  for(const auto& dihedralTuple : dihedrals) {
+    std::tie(firstShapePosition, secondShapePosition, dihedralAngle) = dihedralTuple;
+
+    const SiteIndex iAtFirst = atomPermutators.first.getShapePositionMap().indexOf(firstShapePosition);
+    const SiteIndex lAtSecond = atomPermutators.second.getShapePositionMap().indexOf(secondShapePosition);
+
+    const auto& coneAngleIOption = atomPermutators.first.getFeasible().coneAngles.at(iAtFirst);
+    const auto& coneAngleLOption = atomPermutators.second.getFeasible().coneAngles.at(lAtSecond);
+
+    // Do not emit chiral constraints if cone angles are unknown
+    if(!coneAngleIOption || !coneAngleLOption) {
+      continue;
+    }
+
+    const ValueBounds& coneAngleI = *coneAngleIOption;
+    const ValueBounds& coneAngleL = *coneAngleLOption;
+
+    double dihedralVariance = coneAngleI.upper + coneAngleL.upper;
+    if(permutator.alignment() == BondStereopermutator::Alignment::Eclipsed) {
+      dihedralVariance += SpatialModel::dihedralAbsoluteVariance * looseningMultiplier;
+    } else if(permutator.alignment() == BondStereopermutator::Alignment::Staggered) {
+      // Staggered dihedrals can be significantly looser
+      dihedralVariance += 5 * SpatialModel::dihedralAbsoluteVariance * looseningMultiplier;
+    }
+
+    /* If the width of the dihedral angle is now larger than 2π, then we may
+     * overrepresent some dihedral values when choosing randomly in that
+     * interval, and it is preferable just not to emit a dihedral constraint or
+     * enter any dihedral distance information (the default values are covered
+     * by addDefaultDihedrals).
+     *
+     * This should be very rare or not occur at all; it's just a safeguard.
+     */
+    if(dihedralVariance >= M_PI) {
+      continue;
+    }
+
+    /* Modify the dihedral angle by the upper cone angles of the i and l
+     * sites and the usual variances.
+     *
+     * NOTE: Don't worry about periodicity here, the error function terms in
+     * refinement takes care of that.
+     */
+    const ValueBounds dihedralBounds = SpatialModel::makeBoundsFromCentralValue(
+      dihedralAngle,
+      dihedralVariance
+    );
+
+    /* Dihedral constraints are tricky, and having either all-to-all or
+     * one-to-all can be problematic for minimization, especially if adjacent
+     * bonds are affected simultaneously. So we place as few dihedral
+     * constraints on each bond as possible.
+     *
+     * It's important to "anchor" the dihedral constraints at the side of the
+     * bond with more vertices. This cuts down on the number of dihedral
+     * constraints emitted and keeps their gradient contributions from
+     * counteracting each other. So we want to emit constraints only
+     * referencing one of the vertices on the side with more vertices.
+     */
+    bool emitConstraint = true;
+    if(composite.alignment() != Stereopermutations::Composite::Alignment::Eclipsed) {
+      if(leftIsSideWithMoreVertices) {
+        emitConstraint = (std::get<1>(firstDihedral) == secondShapePosition);
+      } else {
+        emitConstraint = (std::get<0>(firstDihedral) == firstShapePosition);
+      }
+    }
+
+    f(iAtFirst, lAtSecond, dihedralBounds, emitConstraint);
+  }
+}
+
+DihedralConstraint makeDihedralConstraint(
+  const PermutatorPair& atomPermutators,
+  const SiteIndex iAtFirst,
+  const SiteIndex lAtSecond,
+  const ValueBounds& dihedralBounds
+) {
+  return DihedralConstraint {
+    DihedralConstraint::SiteSequence {
+      atomPermutators.first.getRanking().sites.at(iAtFirst),
+      {atomPermutators.first.placement()},
+      {atomPermutators.second.placement()},
+      atomPermutators.second.getRanking().sites.at(lAtSecond)
+    },
+    dihedralBounds.lower,
+    dihedralBounds.upper
+  };
+}
+
 } // namespace
 
 // General availability of static constexpr members
@@ -110,7 +237,8 @@ const ValueBounds SpatialModel::defaultDihedralBounds {std::nextafter(-M_PI, 0),
 
 SpatialModel::SpatialModel(
   const Molecule& molecule,
-  const Configuration& configuration
+  const Configuration& configuration,
+  const std::vector<BondIndex>& deferredBonds
 ) : molecule_(molecule) {
   /* This is overall a pretty complicated constructor since it encompasses the
    * entire conversion from a molecular graph into some model of the internal
@@ -134,10 +262,23 @@ SpatialModel::SpatialModel(
    * positions, not generated from graph or stereopermutator information.
    */
 
+  const auto isDeferred = [&](const BondStereopermutator& permutator) -> bool {
+    return Temple::makeContainsPredicate(deferredBonds)(permutator.placement());
+  };
+
   // Check invariants
   if(
     molecule.stereopermutators().hasZeroAssignmentStereopermutators()
-    || molecule.stereopermutators().hasUnassignedStereopermutators()
+    || Temple::any_of(
+      molecule.stereopermutators().atomStereopermutators(),
+      [](const AtomStereopermutator& permutator) { return !permutator.assigned(); }
+    )
+    || Temple::any_of(
+      molecule.stereopermutators().bondStereopermutators(),
+      [&](const BondStereopermutator& permutator) {
+        return !permutator.assigned() && !isDeferred(permutator);
+      }
+    )
   ) {
     throw std::logic_error("Failed precondition: molecule has zero-assignment or unassigned stereopermutators");
   }
@@ -225,6 +366,10 @@ SpatialModel::SpatialModel(
 
   // Get 1-4 information from BondStereopermutators
   for(const auto& bondStereopermutator : molecule_.stereopermutators().bondStereopermutators()) {
+    if(isDeferred(bondStereopermutator)) {
+      continue;
+    }
+
     addBondStereopermutatorInformation(
       bondStereopermutator,
       molecule_.stereopermutators().at(bondStereopermutator.placement().first),
@@ -539,136 +684,92 @@ void SpatialModel::addBondStereopermutatorInformation(
   // Check precondition that the permutator must be assigned
   assert(permutator.indexOfPermutation());
 
-  // Match stereopermutators to the order in Composite
-  const Stereopermutations::Composite& composite = permutator.composite();
-  using PermutatorPair = std::pair<const AtomStereopermutator&, const AtomStereopermutator&>;
-  const auto atomPermutators = [&]() -> PermutatorPair {
-    if(stereopermutatorA.placement() == composite.orientations().first.identifier)  {
-      return {stereopermutatorA, stereopermutatorB};
-    }
-
-    return {stereopermutatorB, stereopermutatorA};
-  }();
-
-  const unsigned permutation = permutator.indexOfPermutation().value();
+  const PermutatorPair atomPermutators = orderByComposite(
+    permutator,
+    stereopermutatorA,
+    stereopermutatorB
+  );
 
   // Separate modeling code for partially fixed bonds
   if(modelPartiallyFixedBond(permutator, atomPermutators, fixedAngstromPositions)) {
     return;
   }
 
-  const auto& dihedrals = composite.allPermutations().at(permutation).dihedrals;
-  const auto& firstDihedral = dihedrals.front();
-  const auto vertexCountPair = composite.orders();
-  const bool leftIsSideWithMoreVertices = vertexCountPair.first < vertexCountPair.second;
-
   // Default case: No part of the dihedral is fixed
-  Shapes::Vertex firstShapePosition;
-  Shapes::Vertex secondShapePosition;
-  double dihedralAngle;
-
-  for(const auto& dihedralTuple : dihedrals) {
-    std::tie(firstShapePosition, secondShapePosition, dihedralAngle) = dihedralTuple;
-
-    const SiteIndex iAtFirst = atomPermutators.first.getShapePositionMap().indexOf(firstShapePosition);
-    const SiteIndex lAtSecond = atomPermutators.second.getShapePositionMap().indexOf(secondShapePosition);
-
-    const auto& coneAngleIOption = atomPermutators.first.getFeasible().coneAngles.at(iAtFirst);
-    const auto& coneAngleLOption = atomPermutators.second.getFeasible().coneAngles.at(lAtSecond);
-
-    // Do not emit chiral constraints if cone angles are unknown
-    if(!coneAngleIOption || !coneAngleLOption) {
-      continue;
-    }
-
-    const ValueBounds& coneAngleI = *coneAngleIOption;
-    const ValueBounds& coneAngleL = *coneAngleLOption;
+  forEachModeledDihedral(
+    permutator,
+    atomPermutators,
+    looseningMultiplier,
+    [&](
+      const SiteIndex iAtFirst,
+      const SiteIndex lAtSecond,
+      const ValueBounds& dihedralBounds,
+      const bool emitConstraint
+    ) {
+      // Set per-atom sequence dihedral distance bounds
+      Temple::forEach(
+        Temple::Adaptors::allPairs(
+          atomPermutators.first.getRanking().sites.at(iAtFirst),
+          atomPermutators.second.getRanking().sites.at(lAtSecond)
+        ),
+        [&](const AtomIndex firstIndex, const AtomIndex secondIndex) -> void {
+          // NOTE: Reordering the sequence does not affect the dihedral bound
+          setDihedralBoundsIfEmpty(
+            orderedSequence(
+              firstIndex,
+              atomPermutators.first.placement(),
+              atomPermutators.second.placement(),
+              secondIndex
+            ),
+            dihedralBounds
+          );
+        }
+      );
 
-    double dihedralVariance = coneAngleI.upper + coneAngleL.upper;
-    if(permutator.alignment() == BondStereopermutator::Alignment::Eclipsed) {
-      dihedralVariance += dihedralAbsoluteVariance * looseningMultiplier;
-    } else if(permutator.alignment() == BondStereopermutator::Alignment::Staggered) {
-      // Staggered dihedrals can be significantly looser
-      dihedralVariance += 5 * dihedralAbsoluteVariance * looseningMultiplier;
+      if(emitConstraint) {
+        dihedralConstraints_.push_back(
+          makeDihedralConstraint(atomPermutators, iAtFirst, lAtSecond, dihedralBounds)
+        );
+      }
     }
+  );
+}
 
-    /* If the width of the dihedral angle is now larger than 2π, then we may
-     * overrepresent some dihedral values when choosing randomly in that
-     * interval, and it is preferable just not to emit a dihedral constraint or
-     * enter any dihedral distance information (the default values are covered
-     * by addDefaultDihedrals).
-     *
-     * This should be very rare or not occur at all; it's just a safeguard.
-     */
-    if(dihedralVariance >= M_PI) {
-      continue;
-    }
+std::vector<DihedralConstraint> SpatialModel::makeDihedralConstraints(
+  const BondStereopermutator& permutator,
+  const AtomStereopermutator& stereopermutatorA,
+  const AtomStereopermutator& stereopermutatorB,
+  const double looseningMultiplier
+) {
+  if(!permutator.assigned()) {
+    throw std::logic_error("Bond stereopermutator must be assigned");
+  }
 
-    /* Modify the dihedral angle by the upper cone angles of the i and l
-     * sites and the usual variances.
-     *
-     * NOTE: Don't worry about periodicity here, the error function terms in
-     * refinement takes care of that.
-     */
-    const ValueBounds dihedralBounds = makeBoundsFromCentralValue(
-      dihedralAngle,
-      dihedralVariance
-    );
+  const PermutatorPair atomPermutators = orderByComposite(
+    permutator,
+    stereopermutatorA,
+    stereopermutatorB
+  );
 
-    // Set per-atom sequence dihedral distance bounds
-    Temple::forEach(
-      Temple::Adaptors::allPairs(
-        atomPermutators.first.getRanking().sites.at(iAtFirst),
-        atomPermutators.second.getRanking().sites.at(lAtSecond)
-      ),
-      [&](const AtomIndex firstIndex, const AtomIndex secondIndex) -> void {
-        // NOTE: Reordering the sequence does not affect the dihedral bound
-        setDihedralBoundsIfEmpty(
-          orderedSequence(
-            firstIndex,
-            atomPermutators.first.placement(),
-            atomPermutators.second.placement(),
-            secondIndex
-          ),
-          dihedralBounds
+  std::vector<DihedralConstraint> constraints;
+  forEachModeledDihedral(
+    permutator,
+    atomPermutators,
+    looseningMultiplier,
+    [&](
+      const SiteIndex iAtFirst,
+      const SiteIndex lAtSecond,
+      const ValueBounds& dihedralBounds,
+      const bool emitConstraint
+    ) {
+      if(emitConstraint) {
+        constraints.push_back(
+          makeDihedralConstraint(atomPermutators, iAtFirst, lAtSecond, dihedralBounds)
         );
       }
-    );
-
-    /* Dihedral constraints are tricky, and having either all-to-all or
-     * one-to-all can be problematic for minimization, especially if adjacent
-     * bonds are affected simultaneously. So we place as few dihedral
-     * constraints on each bond as possible.
-     *
-     * It's important to "anchor" the dihedral constraints at the side of the
-     * bond with more vertices. This cuts down on the number of dihedral
-     * constraints emitted and keeps their gradient contributions from
-     * counteracting each other. So we want to emit constraints only
-     * referencing one of the vertices on the side with more vertices.
-     */
-    if(composite.alignment() != Stereopermutations::Composite::Alignment::Eclipsed) {
-      if(leftIsSideWithMoreVertices) {
-        if(std::get<1>(firstDihedral) != secondShapePosition) {
-          continue;
-        }
-      } else {
-        if(std::get<0>(firstDihedral) != firstShapePosition) {
-          continue;
-        }
-      }
     }
-
-    dihedralConstraints_.emplace_back(
-      DihedralConstraint::SiteSequence {
-        atomPermutators.first.getRanking().sites.at(iAtFirst),
-        {atomPermutators.first.placement()},
-        {atomPermutators.second.placement()},
-        atomPermutators.second.getRanking().sites.at(lAtSecond)
-      },
-      dihedralBounds.lower,
-      dihedralBounds.upper
-    );
-  }
+  );
+  return constraints;
 }
 
 bool SpatialModel::modelPartiallyFixedBond(
@@ -778,15 +879,40 @@ bool bondInformationIsPresent(
   );
 }
 
-SpatialModel::BoundsMatrix SpatialModel::makePairwiseBounds(
-  unsigned N,
-  const BoundsMapType<2>& fixedPositionBounds,
-  const BoundsMapType<2>& bondBounds,
-  const BoundsMapType<3>& angleBounds,
-  const BoundsMapType<4>& dihedralBounds
-) {
-  BoundsMatrixHelper bounds(N);
+namespace {
+
+/* Adapts SparseBounds to the interface of SpatialModel::BoundsMatrixHelper.
+ * Absent pairs read as zero bounds, as in the dense helper.
+ */
+struct SparseBoundsHelper {
+  explicit SparseBoundsHelper(const PrivateGraph& inner) : bounds(inner) {}
+
+  void add(AtomIndex i, AtomIndex j, const ValueBounds& valueBounds) {
+    bounds.add(i, j, valueBounds);
+  }
+
+  void addMap(const SpatialModel::BoundsMapType<2>& boundsMap) {
+    for(const auto& indexArrayBoundsPair : boundsMap) {
+      const std::array<AtomIndex, 2>& indexArray = indexArrayBoundsPair.first;
+      bounds.set(indexArray.front(), indexArray.back(), indexArrayBoundsPair.second);
+    }
+  }
+
+  ValueBounds get(AtomIndex i, AtomIndex j) const {
+    return bounds.explicitBounds(i, j).value_or(ValueBounds {0.0, 0.0});
+  }
+
+  SparseBounds bounds;
+};
 
+template<typename Helper>
+void populatePairwiseBounds(
+  Helper& bounds,
+  const SpatialModel::BoundsMapType<2>& fixedPositionBounds,
+  const SpatialModel::BoundsMapType<2>& bondBounds,
+  const SpatialModel::BoundsMapType<3>& angleBounds,
+  const SpatialModel::BoundsMapType<4>& dihedralBounds
+) {
   // Copy the constraints as ground truth
   bounds.addMap(fixedPositionBounds);
 
@@ -882,10 +1008,46 @@ SpatialModel::BoundsMatrix SpatialModel::makePairwiseBounds(
       )
     );
   }
+}
+
+} // namespace
 
+SpatialModel::BoundsMatrix SpatialModel::makePairwiseBounds(
+  unsigned N,
+  const BoundsMapType<2>& fixedPositionBounds,
+  const BoundsMapType<2>& bondBounds,
+  const BoundsMapType<3>& angleBounds,
+  const BoundsMapType<4>& dihedralBounds
+) {
+  BoundsMatrixHelper bounds(N);
+  populatePairwiseBounds(
+    bounds,
+    fixedPositionBounds,
+    bondBounds,
+    angleBounds,
+    dihedralBounds
+  );
   return bounds.matrix;
 }
 
+SparseBounds SpatialModel::makeSparsePairwiseBounds(
+  const PrivateGraph& inner,
+  const BoundsMapType<2>& fixedPositionBounds,
+  const BoundsMapType<2>& bondBounds,
+  const BoundsMapType<3>& angleBounds,
+  const BoundsMapType<4>& dihedralBounds
+) {
+  SparseBoundsHelper bounds(inner);
+  populatePairwiseBounds(
+    bounds,
+    fixedPositionBounds,
+    bondBounds,
+    angleBounds,
+    dihedralBounds
+  );
+  return std::move(bounds.bounds);
+}
+
 double SpatialModel::siteCentralAngle(
   const AtomIndex placement,
   const Shapes::Shape& shape,
@@ -1221,6 +1383,16 @@ SpatialModel::BoundsMatrix SpatialModel::makePairwiseBounds() const {
   );
 }
 
+SparseBounds SpatialModel::makeSparsePairwiseBounds() const {
+  return makeSparsePairwiseBounds(
+    molecule_.graph().inner(),
+    constraints_,
+    bondBounds_,
+    angleBounds_,
+    dihedralBounds_
+  );
+}
+
 std::vector<DistanceGeometry::ChiralConstraint> SpatialModel::getChiralConstraints() const {
   return chiralConstraints_;
 }
@@ -19,6 +19,7 @@
 #define INCLUDE_MOLASSEMBLER_DISTANCE_GEOMETRY_SPATIAL_MODEL_H
 
 #include "Molassembler/DistanceGeometry/DistanceBoundsMatrix.h"
+#include "Molassembler/DistanceGeometry/SparseBounds.h"
 #include "Molassembler/Molecule.h"
 #include "Molassembler/Graph.h"
 #include "Molassembler/StereopermutatorList.h"
@@ -222,6 +223,30 @@ public:
     const BoundsMapType<4>& dihedralBounds
   );
 
+  /*!
+   * @brief Generates sparse atom-pairwise distance bounds
+   *
+   * Stores only the pairs that makePairwiseBounds would set, leaving all
+   * other pairs implied from van der Waals radii.
+   *
+   * @complexity{@math{O((P_2 + P_3 + P_4) \cdot D)} where @math{P_i} is the
+   * number of distinct paths of length @math{i} in the graph and @math{D}
+   * is the number of explicit pairs per atom}
+   *
+   * @param inner Graph being modeled
+   * @param fixedPositionbounds Distances to enforce due to fixed positions
+   * @param bondBounds Distances to enforce for bonds
+   * @param angleBounds Angle bounds to enforce on atom index triples
+   * @param dihedralBounds Dihedral bounds to enforce on atom index quadruplet
+   */
+  static SparseBounds makeSparsePairwiseBounds(
+    const PrivateGraph& inner,
+    const BoundsMapType<2>& fixedPositionBounds,
+    const BoundsMapType<2>& bondBounds,
+    const BoundsMapType<3>& angleBounds,
+    const BoundsMapType<4>& dihedralBounds
+  );
+
   /** @brief Determines the central value of the angle between
    *   AtomStereopermutator sites
    *
@@ -334,14 +359,21 @@ public:
    * scale at least linearly in the number of vertices.}
    *
    * @param molecule The molecule that is to be modeled. This may not contain
-   *   stereopermutators with zero assignments or unassigned stereopermutators.
+   *   stereopermutators with zero assignments or unassigned stereopermutators
+   *   other than on @p deferredBonds.
    * @param configuration The Distance Geometry configuration object. Relevant
    *   for this stage of the process are the loosening multiplier and fixed
    *   positions, if set.
+   * @param deferredBonds Bonds whose bond stereopermutators' dihedral
+   *   information is not modeled. Their stereopermutators may be unassigned,
+   *   but still force chiral constraint emission at their constituting atoms.
+   *   Dihedral constraints for them can be added later with
+   *   makeDihedralConstraints.
    */
   SpatialModel(
     const Molecule& molecule,
-    const Configuration& configuration
+    const Configuration& configuration,
+    const std::vector<BondIndex>& deferredBonds = {}
   );
 //!@}
 
@@ -433,6 +465,29 @@ public:
     const std::unordered_map<AtomIndex, Utils::Position>& fixedAngstromPositions
   );
 
+  /** @brief Creates the dihedral constraints of an assigned bond
+   *   stereopermutator without modeling its dihedral distance bounds
+   *
+   * Yields the same dihedral constraints as addBondStereopermutatorInformation
+   * in the absence of fixed positions.
+   *
+   * @complexity{@math{O(S^2)} where @math{S} is the size of the larger modeled
+   * shape}
+   *
+   * @param permutator The BondStereopermutator to create constraints for
+   * @param stereopermutatorA One AtomStereopermutator constituting the BondStereopermutator
+   * @param stereopermutatorB The other AtomStereopermutator constituting the BondStereopermutator
+   * @param looseningMultiplier A loosening factor for the overall model
+   *
+   * @throws std::logic_error If @p permutator is unassigned
+   */
+  static std::vector<DihedralConstraint> makeDihedralConstraints(
+    const BondStereopermutator& permutator,
+    const AtomStereopermutator& stereopermutatorA,
+    const AtomStereopermutator& stereopermutatorB,
+    double looseningMultiplier
+  );
+
   bool modelPartiallyFixedBond(
     const BondStereopermutator& permutator,
     const std::pair<const AtomStereopermutator&, const AtomStereopermutator&>& atomPermutators,
@@ -470,6 +525,18 @@ public:
    */
   BoundsMatrix makePairwiseBounds() const;
 
+  /*! @brief Generates sparse atom-pairwise distance bounds from the internal
+   * coordinate bounds and fixed positions from which this was constructed
+   *
+   * @complexity{@math{O((P_2 + P_3 + P_4) \cdot D)} where @math{P_i} is the
+   * number of distinct paths of length @math{i} in the graph and @math{D}
+   * is the number of explicit pairs per atom}
+   *
+   * @return The same explicit pairs as makePairwiseBounds, with all other
+   * pairs implied from van der Waals radii.
+   */
+  SparseBounds makeSparsePairwiseBounds() const;
+
   /** @brief Generates a string graphviz representation of the modeled molecule
    *
    * The graph contains basic connectivity, stereopermutator information
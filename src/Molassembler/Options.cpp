@@ -7,6 +7,8 @@
 #include "Molassembler/Options.h"
 
 #include "Molassembler/Shapes/Data.h"
+#include "Molassembler/Stereopermutation/Composites.h"
+#include "Molassembler/Stereopermutators/AbstractPermutations.h"
 
 namespace Scine {
 namespace Molassembler {
@@ -23,6 +25,24 @@ bool Options::Thermalization::bartellMechanism = true;
 
 ChiralStatePreservation Options::chiralStatePreservation = ChiralStatePreservation::EffortlessAndUnique;
 ShapeTransition Options::shapeTransition = ShapeTransition::MaximizeChiralStatePreservation;
+unsigned Options::abstractStereopermutationCacheCapacity = 1024;
+unsigned Options::compositeCacheCapacity = 256;
+
+CacheStatistics abstractStereopermutationCacheStatistics() {
+  return Stereopermutators::Abstract::cacheStatistics();
+}
+
+void clearAbstractStereopermutationCache() {
+  Stereopermutators::Abstract::clearCache();
+}
+
+CacheStatistics compositeCacheStatistics() {
+  return Stereopermutations::Composite::cacheStatistics();
+}
+
+void clearCompositeCache() {
+  Stereopermutations::Composite::clearCache();
+}
 
 } // namespace Molassembler
 } // namespace Scine
@@ -10,6 +10,7 @@
 
 #include "Molassembler/Shapes/Shapes.h"
 #include "Molassembler/Prng.h"
+#include "Molassembler/Temple/Cache.h"
 
 #include "Utils/Geometry/ElementTypes.h"
 #include "Molassembler/AngstromPositions.h"
@@ -168,6 +169,9 @@ enum class MASM_EXPORT ShapeTransition {
   MaximizeChiralStatePreservation
 };
 
+//! @brief Usage statistics of a process-wide cache
+using CacheStatistics = Temple::CacheStatistics;
+
 /**
  * @brief Contains all global settings for the library
  */
@@ -230,8 +234,54 @@ struct MASM_EXPORT Options {
    * Defaults to MaximizeChiralStatePreservation
    */
   static ShapeTransition shapeTransition;
+
+  /**
+   * @brief Maximum number of entries in the process-wide cache of abstract
+   *   stereopermutations
+   *
+   * The abstract stereopermutations of an atom stereopermutator and the
+   * graph-independent data needed to decide their feasibility depend only on
+   * its shape and the ranking characters and links of its sites. These are
+   * memoized across all molecules. Least recently used entries are evicted
+   * beyond this capacity. A capacity of zero disables memoization.
+   *
+   * Defaults to 1024.
+   */
+  static unsigned abstractStereopermutationCacheCapacity;
+
+  /**
+   * @brief Maximum number of entries in the process-wide cache of bond
+   *   stereopermutation lists
+   *
+   * The stereopermutations of a composite of two shapes depend only on the
+   * shapes, the fused vertices, the ranking characters at the remaining
+   * vertices and the alignment. These are memoized across all composites.
+   * Least recently used entries are evicted beyond this capacity. A capacity
+   * of zero disables memoization.
+   *
+   * Defaults to 256.
+   */
+  static unsigned compositeCacheCapacity;
 };
 
+/*! @brief Usage statistics of the abstract stereopermutation cache
+ *
+ * @see Options::abstractStereopermutationCacheCapacity
+ */
+MASM_EXPORT CacheStatistics abstractStereopermutationCacheStatistics();
+
+//! @brief Empties the abstract stereopermutation cache and resets its statistics
+MASM_EXPORT void clearAbstractStereopermutationCache();
+
+/*! @brief Usage statistics of the composite stereopermutation cache
+ *
+ * @see Options::compositeCacheCapacity
+ */
+MASM_EXPORT CacheStatistics compositeCacheStatistics();
+
+//! @brief Empties the composite stereopermutation cache and resets its statistics
+MASM_EXPORT void clearCompositeCache();
+
 } // namespace Molassembler
 } // namespace Scine
 
@@ -98,6 +98,25 @@ double sample(const Shapes::Shape shape, PRNG& prng) {
 
 using Matrix = Eigen::Matrix<double, 3, Eigen::Dynamic>;
 
+namespace Detail {
+
+/* Kearsley's quaternion fit matrix contribution of a pair of positions. The
+ * smallest eigenvalue of the sum of contributions of several pairs is their
+ * minimal sum of squared deviations over proper rotations.
+ */
+Eigen::Matrix4d quaternionFitContribution(
+  const Eigen::Vector3d& statorCol,
+  const Eigen::Vector3d& rotorCol
+) {
+  Eigen::Matrix4d a = Eigen::Matrix4d::Zero();
+  a.block<1, 3>(0, 1) = (rotorCol - statorCol).transpose();
+  a.block<3, 1>(1, 0) = statorCol - rotorCol;
+  a.block<3, 3>(1, 1) = Eigen::Matrix3d::Identity().rowwise().cross(statorCol + rotorCol);
+  return a.transpose() * a;
+}
+
+} // namespace Detail
+
 template<typename Derived>
 bool centroidIsZero(const Eigen::MatrixBase<Derived>& a) {
   assert(a.rows() == 3);
@@ -112,14 +131,7 @@ Eigen::Matrix3d fitQuaternion(const Eigen::MatrixBase<DerivedA>& stator, const E
   Eigen::Matrix4d b = Eigen::Matrix4d::Zero();
   // generate decomposable matrix per atom and add them
   for (int i = 0; i < rotor.cols(); i++) {
-    auto& rotorCol = rotor.col(i);
-    auto& statorCol = stator.col(i);
-
-    Eigen::Matrix4d a = Eigen::Matrix4d::Zero();
-    a.block<1, 3>(0, 1) = (rotorCol - statorCol).transpose();
-    a.block<3, 1>(1, 0) = statorCol - rotorCol;
-    a.block<3, 3>(1, 1) = Eigen::Matrix3d::Identity().rowwise().cross(statorCol + rotorCol);
-    b += a.transpose() * a;
+    b += Detail::quaternionFitContribution(stator.col(i), rotor.col(i));
   }
 
   // Decompose b
@@ -141,14 +153,10 @@ Eigen::Matrix3d fitQuaternion(
   Eigen::Matrix4d b = Eigen::Matrix4d::Zero();
   // generate decomposable matrix per atom and add them
   for(const auto& iterPair : p) {
-    const auto& statorCol = stator.col(iterPair.first);
-    const auto& rotorCol = rotor.col(iterPair.second);
-
-    Eigen::Matrix4d a = Eigen::Matrix4d::Zero();
-    a.block<1, 3>(0, 1) = (rotorCol - statorCol).transpose();
-    a.block<3, 1>(1, 0) = statorCol - rotorCol;
-    a.block<3, 3>(1, 1) = Eigen::Matrix3d::Identity().rowwise().cross(statorCol + rotorCol);
-    b += a.transpose() * a;
+    b += Detail::quaternionFitContribution(
+      stator.col(iterPair.first),
+      rotor.col(iterPair.second)
+    );
   }
 
   // Decompose b
@@ -1589,20 +1597,253 @@ ShapeResult shapeHeuristicsCentroidLast(
   };
 }
 
+namespace Detail {
+
+double minimalRotationalDeviation(const Eigen::Matrix4d& b) {
+  Eigen::SelfAdjointEigenSolver<Eigen::Matrix4d> eigensolver(b, Eigen::EigenvaluesOnly);
+  return std::max(eigensolver.eigenvalues()(0), 0.0);
+}
+
+/* Exact minimization of the rotational fit over all mappings by depth-first
+ * branch and bound over partial mappings.
+ *
+ * Positions are mapped in order of decreasing distance from the origin. A
+ * partial mapping's lower bound is the sum of
+ * - the minimal deviation of its mapped pairs over rotations, and
+ * - the minimal deviation of the unmapped positions' distances from the
+ *   origin from those of the free shape vertices. Since deviations of
+ *   positions are at least the deviations of their distances from the origin
+ *   for any rotation, this is admissible. The minimal cost assignment of these
+ *   rotation-invariant descriptors is found by sorting, since their costs are
+ *   convex in a single dimension.
+ *
+ * Children are explored in order of increasing lower bound so that good
+ * mappings are found early.
+ *
+ * Mappings equivalent by a rotation of the shape are not skipped, since the
+ * shape coordinates are only approximately symmetric.
+ */
+class ShapeBranchAndBound {
+public:
+  ShapeBranchAndBound(
+    const PositionCollection& positions,
+    const PositionCollection& shapeCoordinates,
+    const bool centroidLast
+  ) : positions_(positions),
+      shapeCoordinates_(shapeCoordinates),
+      mapping_(positions.cols()),
+      vertexUsed_(positions.cols(), false)
+  {
+    const unsigned N = positions.cols();
+
+    Eigen::Matrix4d b = Eigen::Matrix4d::Zero();
+    if(centroidLast) {
+      mapping_.at(N - 1) = Vertex(N - 1);
+      vertexUsed_.at(N - 1) = true;
+      b += quaternionFitContribution(positions.col(N - 1), shapeCoordinates.col(N - 1));
+    }
+
+    const unsigned M = centroidLast ? N - 1 : N;
+    order_ = Temple::sorted(
+      Temple::iota<unsigned>(M),
+      [&](const unsigned i, const unsigned j) -> bool {
+        return positions.col(i).squaredNorm() > positions.col(j).squaredNorm();
+      }
+    );
+
+    // Sorted distances from the origin of positions left unmapped at each depth
+    remainingNorms_.resize(M + 1);
+    for(unsigned depth = 0; depth <= M; ++depth) {
+      for(unsigned k = depth; k < M; ++k) {
+        remainingNorms_.at(depth).push_back(positions.col(order_.at(k)).norm());
+      }
+      Temple::sort(remainingNorms_.at(depth));
+    }
+
+    shapeNorms_ = Temple::map(
+      Temple::iota<unsigned>(N),
+      [&](const unsigned i) -> double { return shapeCoordinates.col(i).norm(); }
+    );
+
+    branch_(0, b);
+  }
+
+  const std::vector<Vertex>& mapping() const {
+    return bestMapping_;
+  }
+
+  double deviation() const {
+    return bestDeviation_;
+  }
+
+private:
+  const PositionCollection& positions_;
+  const PositionCollection& shapeCoordinates_;
+  std::vector<unsigned> order_;
+  std::vector<std::vector<double>> remainingNorms_;
+  std::vector<double> shapeNorms_;
+
+  std::vector<Vertex> mapping_;
+  std::vector<bool> vertexUsed_;
+  std::vector<Vertex> bestMapping_;
+  double bestDeviation_ = std::numeric_limits<double>::max();
+
+  //! Lower bound on deviations of unmapped positions at a depth
+  double remainingBound_(const unsigned depth) const {
+    const auto& norms = remainingNorms_.at(depth);
+    if(norms.empty()) {
+      return 0.0;
+    }
+
+    std::vector<double> freeNorms;
+    freeNorms.reserve(norms.size());
+    for(unsigned j = 0; j < shapeNorms_.size(); ++j) {
+      if(!vertexUsed_.at(j)) {
+        freeNorms.push_back(shapeNorms_.at(j));
+      }
+    }
+    Temple::sort(freeNorms);
+    assert(freeNorms.size() == norms.size());
+
+    double bound = 0.0;
+    for(unsigned k = 0; k < norms.size(); ++k) {
+      bound += std::pow(norms.at(k) - freeNorms.at(k), 2);
+    }
+    return bound;
+  }
+
+  void branch_(const unsigned depth, const Eigen::Matrix4d& b) {
+    if(depth == order_.size()) {
+      const double deviation = minimalRotationalDeviation(b);
+      if(deviation < bestDeviation_) {
+        bestDeviation_ = deviation;
+        bestMapping_ = mapping_;
+      }
+      return;
+    }
+
+    const unsigned i = order_.at(depth);
+    const unsigned N = shapeCoordinates_.cols();
+
+    /* Children store no fixed-size Eigen matrices, which would need aligned
+     * allocation. Their fit matrices are recomputed when descending.
+     */
+    struct Child {
+      double bound;
+      unsigned vertex;
+    };
+    std::vector<Child> children;
+    for(unsigned j = 0; j < N; ++j) {
+      if(vertexUsed_.at(j)) {
+        continue;
+      }
+
+      const Eigen::Matrix4d childB = b + quaternionFitContribution(positions_.col(i), shapeCoordinates_.col(j));
+      vertexUsed_.at(j) = true;
+      const double bound = minimalRotationalDeviation(childB) + remainingBound_(depth + 1);
+      vertexUsed_.at(j) = false;
+      if(bound < bestDeviation_) {
+        children.push_back(Child {bound, j});
+      }
+    }
+
+    std::sort(
+      std::begin(children),
+      std::end(children),
+      [](const Child& x, const Child& y) -> bool { return x.bound < y.bound; }
+    );
+
+    for(const Child& child : children) {
+      // Bound on the best deviation may have decreased in a prior child
+      if(child.bound >= bestDeviation_) {
+        break;
+      }
+
+      mapping_.at(i) = Vertex(child.vertex);
+      vertexUsed_.at(child.vertex) = true;
+      branch_(
+        depth + 1,
+        b + quaternionFitContribution(positions_.col(i), shapeCoordinates_.col(child.vertex))
+      );
+      vertexUsed_.at(child.vertex) = false;
+    }
+  }
+};
+
+ShapeResult shapeBranchAndBoundBase(
+  const PositionCollection& normalizedPositions,
+  const Shape shape,
+  const bool centroidLast
+) {
+  assert(isNormalized(normalizedPositions));
+  const unsigned N = normalizedPositions.cols();
+
+  if(N != size(shape) + 1) {
+    throw std::logic_error("Mismatched number of positions between supplied coordinates and shape!");
+  }
+
+  // Add origin to shape coordinates and renormalize
+  PositionCollection shapeCoords (3, N);
+  shapeCoords.leftCols(N - 1) = coordinates(shape);
+  shapeCoords.col(N - 1) = Eigen::Vector3d::Zero();
+  shapeCoords = normalize(shapeCoords);
+
+  ShapeBranchAndBound search(normalizedPositions, shapeCoords, centroidLast);
+  std::vector<Vertex> bestPermutation = search.mapping();
+
+  /* As in the alternate implementation, minimize over the isotropic scaling
+   * factor for the best mapping of the rotational fit
+   */
+  PositionCollection permutedShape(3, N);
+  for(unsigned i = 0; i < N; ++i) {
+    permutedShape.col(i) = shapeCoords.col(bestPermutation.at(i));
+  }
+  auto R = fitQuaternion(normalizedPositions, permutedShape);
+  permutedShape = R * permutedShape;
+
+  constexpr double scalingLowerBound = 0.5;
+  constexpr double scalingUpperBound = 1.1;
+
+  auto scalingMinimizationResult = boost::math::tools::brent_find_minima(
+    [&](double scaling) { return (normalizedPositions - scaling * permutedShape).colwise().squaredNorm().sum(); },
+    scalingLowerBound,
+    scalingUpperBound,
+    std::numeric_limits<double>::digits
+  );
+
+  const double normalization = normalizedPositions.colwise().squaredNorm().sum();
+
+  return {
+    std::move(bestPermutation),
+    100 * scalingMinimizationResult.second / normalization
+  };
+}
+
+} // namespace Detail
+
+ShapeResult shapeBranchAndBound(
+  const PositionCollection& normalizedPositions,
+  const Shape shape
+) {
+  return Detail::shapeBranchAndBoundBase(normalizedPositions, shape, false);
+}
+
+ShapeResult shapeBranchAndBoundCentroidLast(
+  const PositionCollection& normalizedPositions,
+  const Shape shape
+) {
+  return Detail::shapeBranchAndBoundBase(normalizedPositions, shape, true);
+}
+
 
 ShapeResult shape(
   const PositionCollection& normalizedPositions,
   const Shape shape
 ) {
-#ifdef NDEBUG
-  // In release builds, use heuristics starting from size 9
-  constexpr unsigned minSizeForHeuristics = 8;
-#else
-  // In debug builds, use heuristics starting from size 6
-  constexpr unsigned minSizeForHeuristics = 6;
-#endif
-  if(size(shape) >= minSizeForHeuristics) {
-    return shapeHeuristics(normalizedPositions, shape);
+  // Exhaustive search is competitive only for very small shapes
+  constexpr unsigned minSizeForBranchAndBound = 5;
+  if(size(shape) >= minSizeForBranchAndBound) {
+    return shapeBranchAndBound(normalizedPositions, shape);
   }
 
   return shapeAlternateImplementation(normalizedPositions, shape);
@@ -1612,15 +1853,10 @@ ShapeResult shapeCentroidLast(
   const PositionCollection& normalizedPositions,
   const Shape shape
 ) {
-#ifdef NDEBUG
-  // In release builds, use heuristics starting from size 8
-  constexpr unsigned minSizeForHeuristics = 8;
-#else
-  // In debug builds, use heuristics starting from size 6
-  constexpr unsigned minSizeForHeuristics = 6;
-#endif
-  if(size(shape) >= minSizeForHeuristics) {
-    return shapeHeuristicsCentroidLast(normalizedPositions, shape);
+  // Exhaustive search is competitive only for very small shapes
+  constexpr unsigned minSizeForBranchAndBound = 5;
+  if(size(shape) >= minSizeForBranchAndBound) {
+    return shapeBranchAndBoundCentroidLast(normalizedPositions, shape);
   }
 
   return shapeAlternateImplementationCentroidLast(normalizedPositions, shape);
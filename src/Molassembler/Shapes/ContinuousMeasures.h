@@ -222,13 +222,43 @@ MASM_EXPORT ShapeResult shapeHeuristicsCentroidLast(
   Shape shape
 );
 
+/**
+ * @brief Exact calculation of the continuous shape measure by branch and bound
+ *   over partial mappings
+ *
+ * Minimizes the rotational fit over all mappings like
+ * shapeAlternateImplementation(), but prunes partial mappings whose lower
+ * bound exceeds the best mapping found so far. Lower bounds are the minimal
+ * rotational fit of the mapped positions plus an optimal assignment of the
+ * unmapped positions' distances from the centroid onto those of the free
+ * shape vertices.
+ *
+ * @param normalizedPositions set of coordinates to compare with the shape
+ * @param shape Reference shape to compare against
+ *
+ * @complexity{@math{O(N!)} quaternion fits in the worst case, but typically
+ * orders of magnitude fewer. Note that @math{N} is the size of the shape plus
+ * one since a centroid is involved as well.}
+ *
+ * @return The exact continuous shape measure
+ */
+MASM_EXPORT ShapeResult shapeBranchAndBound(
+  const PositionCollection& normalizedPositions,
+  Shape shape
+);
+
+//! @brief Same as shapeBranchAndBound(), except with set centroid mapping
+MASM_EXPORT ShapeResult shapeBranchAndBoundCentroidLast(
+  const PositionCollection& normalizedPositions,
+  Shape shape
+);
+
 /**
  * @brief Forwarding function to calculate the continuous shape measure
  *
- * Forwards its call to shapeAlternateImplementation() by default. In debug
- * builds, forwards its call to shapeHeuristics() from shape size 6 onwards. In
- * release builds, forwards its call to shapeHeuristics() from shape size 9
- * onwards.
+ * Forwards its call to shapeAlternateImplementation() for shapes of size four
+ * and smaller, and to shapeBranchAndBound() from shape size 5 onwards. Both
+ * are exact.
  */
 MASM_EXPORT ShapeResult shape(
   const PositionCollection& normalizedPositions,
@@ -247,9 +277,6 @@ MASM_EXPORT ShapeResult shapeCentroidLast(
  *
  * @math{k_XY = \sqrt{\textrm{CShM}A_(B)} = \sqrt{\textrm{CShM}B_(A)} = 10 \sin(\theta_AB)}
  *
- * @warning This function calls shape(), where heuristics are used for
- * particular shape sizes.
- *
  * @complexity{One continuous shape calculation.}
  */
 MASM_EXPORT double minimumDistortionAngle(Shape a, Shape b);
@@ -267,9 +294,6 @@ MASM_EXPORT double minimumDistortionAngle(Shape a, Shape b);
  * This function form avoids two shape calculations if the minimum distortion
  * angle between a and b is known.
  *
- * @warning This function calls shape(), where heuristics are used for
- * particular shape sizes.
- *
  * @complexity{Two continuous shape calculations.}
  */
 MASM_EXPORT double minimalDistortionPathDeviation(
@@ -10,6 +10,12 @@
 #include "Molassembler/Temple/constexpr/TupleTypePairs.h"
 #include "Molassembler/Temple/Functional.h"
 
+#include "nlohmann/json.hpp"
+
+#include <algorithm>
+#include <map>
+#include <shared_mutex>
+
 namespace Scine {
 namespace Molassembler {
 namespace Shapes {
@@ -55,28 +61,57 @@ constexpr Temple::UpperTriangularMatrix<
 );
 #endif
 
-Temple::MinimalCache<
-  std::tuple<Shape, Shape, boost::optional<unsigned>>,
-  Properties::ShapeTransitionGroup
-> mappingsCache;
+namespace {
 
-boost::optional<const Properties::ShapeTransitionGroup&> getMapping(
-  const Shape a,
-  const Shape b,
-  const boost::optional<Vertex>& removedIndexOption
-) {
-  if(a == b) {
-    return boost::none;
-  }
+//! Source and target shape and removed source vertex for ligand loss
+using MappingKey = std::tuple<Shape, Shape, boost::optional<unsigned>>;
 
-  using Key = typename decltype(mappingsCache)::key_type;
+/* Read-mostly store of transition mappings. Entries are never modified or
+ * removed once inserted, so references to them remain valid without holding
+ * the lock.
+ */
+class MappingsStore {
+public:
+  const Properties::ShapeTransitionGroup* find(const MappingKey& key) const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+    const auto findIter = mappings_.find(key);
+    if(findIter == std::end(mappings_)) {
+      return nullptr;
+    }
+
+    return &findIter->second;
+  }
 
-  const Key key {a, b, removedIndexOption};
+  const Properties::ShapeTransitionGroup& insert(
+    const MappingKey& key,
+    Properties::ShapeTransitionGroup group
+  ) {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex_);
+    return mappings_.emplace(key, std::move(group)).first->second;
+  }
 
-  if(mappingsCache.has(key)) {
-    return mappingsCache.getOption(key);
+  //! Copies all stored mappings
+  std::map<MappingKey, Properties::ShapeTransitionGroup> mappings() const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+    return mappings_;
   }
 
+private:
+  mutable std::shared_timed_mutex mutex_;
+  std::map<MappingKey, Properties::ShapeTransitionGroup> mappings_;
+};
+
+MappingsStore& mappingsStore() {
+  // Pursuant to Construct-on-first-use idiom
+  static MappingsStore store;
+  return store;
+}
+
+boost::optional<Properties::ShapeTransitionGroup> calculateMapping(
+  const Shape a,
+  const Shape b,
+  const boost::optional<Vertex>& removedIndexOption
+) {
   int sizeDiff = static_cast<int>(Shapes::size(b)) - static_cast<int>(Shapes::size(a));
 
   if(sizeDiff == 1 || sizeDiff == 0) {
@@ -117,38 +152,201 @@ boost::optional<const Properties::ShapeTransitionGroup&> getMapping(
       stlResult.angularDistortion = constexprMappings.angularDistortion;
       stlResult.chiralDistortion = constexprMappings.chiralDistortion;
 
-      mappingsCache.add(
-        key,
-        stlResult
-      );
-    } else {
-      // Calculate dynamically (relevant for targets of size 9 and higher)
-      mappingsCache.add(
-        key,
-        Properties::selectBestTransitionMappings(
-          Properties::shapeTransitionMappings(a, b)
-        )
-      );
+      return stlResult;
     }
+
+    // Calculate dynamically (relevant for targets of size 9 and higher)
+    return Properties::selectBestTransitionMappings(
+      Properties::shapeTransitionMappings(a, b)
+    );
 #else
-    mappingsCache.add(
-      key,
-      Properties::selectBestTransitionMappings(
-        Properties::shapeTransitionMappings(a, b)
-      )
+    return Properties::selectBestTransitionMappings(
+      Properties::shapeTransitionMappings(a, b)
     );
 #endif
-  } else if(sizeDiff == -1 && removedIndexOption) {
+  }
+
+  if(sizeDiff == -1 && removedIndexOption) {
     // Deletion case (always dynamic)
-    mappingsCache.add(
-      key,
-      Properties::selectBestTransitionMappings(
-        Properties::ligandLossTransitionMappings(a, b, removedIndexOption.value())
-      )
+    return Properties::selectBestTransitionMappings(
+      Properties::ligandLossTransitionMappings(a, b, removedIndexOption.value())
+    );
+  }
+
+  return boost::none;
+}
+
+} // namespace
+
+boost::optional<const Properties::ShapeTransitionGroup&> getMapping(
+  const Shape a,
+  const Shape b,
+  const boost::optional<Vertex>& removedIndexOption
+) {
+  if(a == b) {
+    return boost::none;
+  }
+
+  const MappingKey key {a, b, removedIndexOption};
+  MappingsStore& store = mappingsStore();
+  if(const Properties::ShapeTransitionGroup* groupPtr = store.find(key)) {
+    return *groupPtr;
+  }
+
+  // Calculate outside of the lock. Concurrent calculations store only once.
+  auto groupOption = calculateMapping(a, b, removedIndexOption);
+  if(!groupOption) {
+    return boost::none;
+  }
+
+  return store.insert(key, std::move(groupOption.value()));
+}
+
+void populateMappings(const unsigned maxShapeSize) {
+  MappingsStore& store = mappingsStore();
+
+  std::vector<MappingKey> keys;
+  for(const Shape a : allShapes) {
+    for(const Shape b : allShapes) {
+      if(a == b || Shapes::size(a) > maxShapeSize || Shapes::size(b) > maxShapeSize) {
+        continue;
+      }
+
+      const int sizeDiff = static_cast<int>(Shapes::size(b)) - static_cast<int>(Shapes::size(a));
+      if(sizeDiff == 1 || sizeDiff == 0) {
+        keys.emplace_back(a, b, boost::none);
+      } else if(sizeDiff == -1) {
+        for(unsigned i = 0; i < Shapes::size(a); ++i) {
+          keys.emplace_back(a, b, i);
+        }
+      }
+    }
+  }
+
+  keys.erase(
+    std::remove_if(
+      std::begin(keys),
+      std::end(keys),
+      [&](const MappingKey& key) { return store.find(key) != nullptr; }
+    ),
+    std::end(keys)
+  );
+
+  const unsigned K = keys.size();
+  std::vector<boost::optional<Properties::ShapeTransitionGroup>> groups(K);
+#pragma omp parallel for schedule(dynamic)
+  for(unsigned i = 0; i < K; ++i) {
+    const MappingKey& key = keys[i];
+    boost::optional<Vertex> removedVertexOption;
+    if(std::get<2>(key)) {
+      removedVertexOption = Vertex(std::get<2>(key).value());
+    }
+    groups[i] = calculateMapping(std::get<0>(key), std::get<1>(key), removedVertexOption);
+  }
+
+  for(unsigned i = 0; i < K; ++i) {
+    if(groups[i]) {
+      store.insert(keys[i], std::move(groups[i].value()));
+    }
+  }
+}
+
+std::vector<std::uint8_t> dumpMappings() {
+  /* Each transition is stored as an array of source and target shape indices,
+   * the removed vertex (-1 if none), angular and chiral distortion and the
+   * index mappings
+   */
+  nlohmann::json transitions = nlohmann::json::array();
+  for(const auto& mappingPair : mappingsStore().mappings()) {
+    const MappingKey& key = mappingPair.first;
+    const Properties::ShapeTransitionGroup& group = mappingPair.second;
+    transitions.push_back(
+      nlohmann::json::array({
+        static_cast<unsigned>(std::get<0>(key)),
+        static_cast<unsigned>(std::get<1>(key)),
+        std::get<2>(key) ? static_cast<int>(std::get<2>(key).value()) : -1,
+        group.angularDistortion,
+        group.chiralDistortion,
+        Temple::map(
+          group.indexMappings,
+          [](const std::vector<Vertex>& mapping) {
+            return Temple::map(mapping, [](const Vertex v) -> unsigned { return v; });
+          }
+        )
+      })
     );
   }
 
-  return mappingsCache.getOption(key);
+  nlohmann::json table;
+  table["n"] = nShapes;
+  table["t"] = std::move(transitions);
+  return nlohmann::json::to_cbor(table);
+}
+
+void loadMappings(const std::vector<std::uint8_t>& table) {
+  std::vector<std::pair<MappingKey, Properties::ShapeTransitionGroup>> entries;
+  try {
+    const auto json = nlohmann::json::from_cbor(table);
+    if(json.at("n").get<unsigned>() != nShapes) {
+      throw std::invalid_argument("Mappings table was generated for different shapes");
+    }
+
+    for(const auto& transition : json.at("t")) {
+      const auto a = transition.at(0).get<unsigned>();
+      const auto b = transition.at(1).get<unsigned>();
+      const auto removed = transition.at(2).get<int>();
+      if(a >= nShapes || b >= nShapes || a == b) {
+        throw std::invalid_argument("Mappings table contains invalid shapes");
+      }
+
+      const Shape source = allShapes.at(a);
+      const Shape target = allShapes.at(b);
+      const int sizeDiff = static_cast<int>(Shapes::size(target)) - static_cast<int>(Shapes::size(source));
+      if(sizeDiff < -1 || sizeDiff > 1) {
+        throw std::invalid_argument("Mappings table contains invalid transition");
+      }
+
+      // Only ligand loss transitions have a removed vertex
+      const bool validRemoved = (sizeDiff == -1)
+        ? (removed >= 0 && removed < static_cast<int>(Shapes::size(source)))
+        : removed == -1;
+      if(!validRemoved) {
+        throw std::invalid_argument("Mappings table contains invalid removed vertex");
+      }
+
+      /* Ligand loss mappings have an entry for each target vertex, all others
+       * for each vertex of the larger shape
+       */
+      const unsigned S = std::max(Shapes::size(source), Shapes::size(target));
+      const unsigned mappingSize = (sizeDiff == -1) ? Shapes::size(target) : S;
+      Properties::ShapeTransitionGroup group;
+      group.angularDistortion = transition.at(3).get<double>();
+      group.chiralDistortion = transition.at(4).get<double>();
+      for(const auto& mapping : transition.at(5).get<std::vector<std::vector<unsigned>>>()) {
+        if(mapping.size() != mappingSize) {
+          throw std::invalid_argument("Mappings table contains mapping of invalid length");
+        }
+        if(Temple::any_of(mapping, [S](const unsigned v) { return v >= S; })) {
+          throw std::invalid_argument("Mappings table contains invalid vertices");
+        }
+        group.indexMappings.emplace_back(std::begin(mapping), std::end(mapping));
+      }
+
+      boost::optional<unsigned> removedOption;
+      if(removed >= 0) {
+        removedOption = static_cast<unsigned>(removed);
+      }
+      entries.emplace_back(MappingKey {source, target, removedOption}, std::move(group));
+    }
+  } catch(const nlohmann::json::exception& e) {
+    throw std::invalid_argument(std::string("Malformed mappings table: ") + e.what());
+  }
+
+  // Store only once the whole table is valid
+  MappingsStore& store = mappingsStore();
+  for(auto& entry : entries) {
+    store.insert(entry.first, std::move(entry.second));
+  }
 }
 
 #ifdef USE_CONSTEXPR_HAS_MULTIPLE_UNLINKED_STEREOPERMUTATIONS
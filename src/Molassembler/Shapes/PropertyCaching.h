@@ -11,6 +11,9 @@
 #include "Molassembler/Shapes/constexpr/Properties.h"
 #include "Molassembler/Shapes/Properties.h"
 
+#include <cstdint>
+#include <vector>
+
 namespace Scine {
 namespace Molassembler {
 namespace Shapes {
@@ -64,19 +67,15 @@ extern const Temple::UpperTriangularMatrix<
 #endif
 
 /* Dynamic access to constexpr data */
-/*! @brief Cache for on-the-fly generated mappings between symmetries
- *
- * Accesses allMappings if it was generated.
- */
-extern Temple::MinimalCache<
-  std::tuple<Shape, Shape, boost::optional<unsigned>>,
-  Properties::ShapeTransitionGroup
-> mappingsCache;
-
 /*! @brief Cached access to mappings. Populates the cache from constexpr if generated.
+ *
+ * Mappings are kept in a process-wide, read-mostly store that is safe for
+ * concurrent use. Stored mappings are never modified or removed, so the
+ * returned references remain valid for the lifetime of the process.
  *
  * @complexity{@math{\Theta(S!)} where @math{S} is the size of the symmetry if
- * the transition is not cached, @math{\Theta(1)} otherwise.}
+ * the transition is not stored, @math{\Theta(\log T)} otherwise for @math{T}
+ * stored transitions.}
  *
  * @param a Source shape
  * @param b Target shape
@@ -92,6 +91,34 @@ boost::optional<const Properties::ShapeTransitionGroup&> getMapping(
   const boost::optional<Vertex>& removedIndexOption = boost::none
 );
 
+/*! @brief Calculates and stores all transition mappings between shapes up to
+ *   a size ahead of time
+ *
+ * Afterwards, getMapping does not calculate for shapes of at most
+ * @p maxShapeSize vertices, giving deterministic latency. Includes ligand loss
+ * transitions for each removed vertex. Parallelized if OpenMP is enabled.
+ *
+ * @complexity{@math{\Theta(T \cdot S!)} for @math{T} transitions between
+ * shapes of at most size @math{S}}
+ */
+MASM_EXPORT void populateMappings(unsigned maxShapeSize = 8);
+
+/*! @brief Serializes all stored transition mappings into a binary table
+ *
+ * Tables are CBOR-encoded and can be loaded with loadMappings, e.g. to ship
+ * a table generated with populateMappings.
+ */
+MASM_EXPORT std::vector<std::uint8_t> dumpMappings();
+
+/*! @brief Stores all transition mappings of a binary table
+ *
+ * Transitions that are already stored are kept.
+ *
+ * @throws std::invalid_argument If the table is malformed or does not match
+ *   the library's shapes
+ */
+MASM_EXPORT void loadMappings(const std::vector<std::uint8_t>& table);
+
 #ifdef USE_CONSTEXPR_HAS_MULTIPLE_UNLINKED_STEREOPERMUTATIONS
 /*! @brief All precomputed values for hasMultipleUnlinkedStereopermutations
  *
@@ -7,8 +7,10 @@
 #include "Molassembler/Stereopermutation/Composites.h"
 
 #include "boost/dynamic_bitset.hpp"
+#include "boost/functional/hash.hpp"
 #include "Eigen/Geometry"
 
+#include "Molassembler/Options.h"
 #include "Molassembler/Shapes/Properties.h"
 #include "Molassembler/Shapes/Data.h"
 #include "Molassembler/Detail/Cartesian.h"
@@ -86,6 +88,56 @@ void translateCoordinates(
   }
 }
 
+/* Generated permutations depend on the ordered orientation states without
+ * their identifiers and the alignment
+ */
+using PermutationsKey = std::tuple<
+  Shapes::Shape, Shapes::Vertex, std::vector<char>,
+  Shapes::Shape, Shapes::Vertex, std::vector<char>,
+  Composite::Alignment
+>;
+
+struct PermutationsKeyHash {
+  std::size_t operator() (const PermutationsKey& key) const {
+    std::size_t seed = 0;
+    boost::hash_combine(seed, static_cast<unsigned>(std::get<0>(key)));
+    boost::hash_combine(seed, static_cast<unsigned>(std::get<1>(key)));
+    boost::hash_combine(seed, std::get<2>(key));
+    boost::hash_combine(seed, static_cast<unsigned>(std::get<3>(key)));
+    boost::hash_combine(seed, static_cast<unsigned>(std::get<4>(key)));
+    boost::hash_combine(seed, std::get<5>(key));
+    boost::hash_combine(seed, static_cast<unsigned>(std::get<6>(key)));
+    return seed;
+  }
+};
+
+PermutationsKey makePermutationsKey(
+  const Temple::OrderedPair<Composite::OrientationState>& orientations,
+  const Composite::Alignment alignment
+) {
+  return PermutationsKey {
+    orientations.first.shape,
+    orientations.first.fusedVertex,
+    orientations.first.characters,
+    orientations.second.shape,
+    orientations.second.fusedVertex,
+    orientations.second.characters,
+    alignment
+  };
+}
+
+using PermutationsCache = Temple::ConcurrentLruCache<
+  PermutationsKey,
+  Composite::PermutationsList,
+  PermutationsKeyHash
+>;
+
+PermutationsCache& permutationsCache() {
+  // Pursuant to Construct-on-first-use idiom
+  static PermutationsCache cache;
+  return cache;
+}
+
 } // namespace
 
 constexpr Temple::Floating::ExpandedAbsoluteEqualityComparator<double> Composite::fpComparator;
@@ -911,6 +963,14 @@ std::vector<Shapes::Vertex> Composite::rotation(
   return {};
 }
 
+Temple::CacheStatistics Composite::cacheStatistics() {
+  return permutationsCache().statistics();
+}
+
+void Composite::clearCache() {
+  permutationsCache().clear();
+}
+
 Composite::Composite(
   OrientationState first,
   OrientationState second,
@@ -921,21 +981,30 @@ Composite::Composite(
   // Do not construct the ordered pair of OrientationStates with same identifier
   assert(orientations_.first.identifier != orientations_.second.identifier);
 
-  PermutationGenerator generator(orientations_);
-  stereopermutations_ = generator.generate(alignment);
+  stereopermutations_ = permutationsCache().get(
+    makePermutationsKey(orientations_, alignment),
+    Options::compositeCacheCapacity,
+    [&]() {
+      PermutationGenerator generator(orientations_);
+      PermutationsList permutations = generator.generate(alignment);
+
+      if(alignment == Alignment::Eclipsed) {
+        /* Reverse the stereopermutation sequence. This is so that the indices
+         * of the generated permutations yield the following simple
+         * comparison:
+         *
+         *   0 is E, 1 is Z
+         *   1 > 0 == Z > E
+         */
+        std::reverse(
+          std::begin(permutations),
+          std::end(permutations)
+        );
+      }
 
-  if(alignment == Alignment::Eclipsed) {
-    /* Reverse the stereopermutation sequence. This is so that the indices of the
-     * generated permutations yield the following simple comparison:
-     *
-     *   0 is E, 1 is Z
-     *   1 > 0 == Z > E
-     */
-    std::reverse(
-      std::begin(stereopermutations_),
-      std::end(stereopermutations_)
-    );
-  }
+      return permutations;
+    }
+  );
 }
 
 void Composite::applyIdentifierPermutation(const std::vector<std::size_t>& permutation) {
@@ -945,7 +1014,7 @@ void Composite::applyIdentifierPermutation(const std::vector<std::size_t>& permu
 }
 
 const Composite::PermutationsList& Composite::allPermutations() const {
-  return stereopermutations_;
+  return *stereopermutations_;
 }
 
 Composite::Alignment Composite::alignment() const {
@@ -953,14 +1022,14 @@ Composite::Alignment Composite::alignment() const {
 }
 
 unsigned Composite::rankingEquivalentBase(const unsigned permutation) const {
-  const Permutation& stereopermutation = stereopermutations_.at(permutation);
+  const Permutation& stereopermutation = stereopermutations_->at(permutation);
 
   if(!stereopermutation.rankingEquivalentTo) {
     return permutation;
   }
 
   auto findIter = Temple::find_if(
-    stereopermutations_,
+    *stereopermutations_,
     [&](const auto& searchPermutation) {
       return (
         searchPermutation.alignment == stereopermutation.alignment
@@ -969,16 +1038,16 @@ unsigned Composite::rankingEquivalentBase(const unsigned permutation) const {
     }
   );
 
-  assert(findIter != std::end(stereopermutations_));
+  assert(findIter != std::end(*stereopermutations_));
 
-  return findIter - std::begin(stereopermutations_);
+  return findIter - std::begin(*stereopermutations_);
 }
 
 std::vector<unsigned> Composite::nonEquivalentPermutationIndices() const {
   std::vector<unsigned> indices;
-  const unsigned N = stereopermutations_.size();
+  const unsigned N = stereopermutations_->size();
   for(unsigned i = 0; i < N; ++i) {
-    if(!stereopermutations_.at(i).rankingEquivalentTo) {
+    if(!stereopermutations_->at(i).rankingEquivalentTo) {
       indices.push_back(i);
     }
   }
@@ -987,7 +1056,7 @@ std::vector<unsigned> Composite::nonEquivalentPermutationIndices() const {
 
 unsigned Composite::countNonEquivalentPermutations() const {
   return Temple::accumulate(
-    stereopermutations_,
+    *stereopermutations_,
     0U,
     [](unsigned carry, const Permutation& permutation) -> unsigned {
       if(permutation.rankingEquivalentTo) {
@@ -1010,7 +1079,7 @@ std::pair<unsigned, unsigned> Composite::orders() const {
    */
   const auto countDistinct = [&](auto&& f) {
     std::set<unsigned> positions;
-    for(const Permutation::DihedralTuple& t : stereopermutations_.front().dihedrals) {
+    for(const Permutation::DihedralTuple& t : stereopermutations_->front().dihedrals) {
       positions.insert(f(t));
     }
     return positions.size();
@@ -1036,13 +1105,13 @@ unsigned Composite::rotationalAxisSymmetryOrder() const {
    */
 
   std::set<unsigned> counts;
-  for(const Permutation& permutation : stereopermutations_) {
+  for(const Permutation& permutation : *stereopermutations_) {
     if(permutation.rankingEquivalentTo) {
       continue;
     }
 
     const auto count = Temple::accumulate(
-      stereopermutations_,
+      *stereopermutations_,
       1U,
       [&](unsigned carry, const Permutation& other) -> unsigned {
         if(
@@ -1076,11 +1145,11 @@ const Temple::OrderedPair<Composite::OrientationState>& Composite::orientations(
 }
 
 Composite::PermutationsList::const_iterator Composite::begin() const {
-  return std::begin(stereopermutations_);
+  return std::begin(*stereopermutations_);
 }
 
 Composite::PermutationsList::const_iterator Composite::end() const {
-  return std::end(stereopermutations_);
+  return std::end(*stereopermutations_);
 }
 
 bool Composite::operator < (const Composite& other) const {
@@ -14,11 +14,14 @@
 
 #include "Molassembler/Shapes/Shapes.h"
 #include "Molassembler/Shapes/Data.h"
+#include "Molassembler/Temple/Cache.h"
 #include "Molassembler/Temple/OrderedPair.h"
 #include "Molassembler/Temple/constexpr/FloatingPointComparison.h"
 
 #include "boost/optional.hpp"
 
+#include <memory>
+
 namespace Scine {
 namespace Molassembler {
 namespace Stereopermutations {
@@ -219,9 +222,14 @@ public:
 //!@name Constructors
 //!@{
   /*! @brief Constructor calculating all permutations
+   *
+   * Permutations depend only on the orientation states without their
+   * identifiers and the alignment. They are memoized in a process-wide,
+   * thread-safe cache and shared immutably between Composites.
    *
    * @complexity{@math{O(S!)} where S is the size of the larger shape of the
-   * two OrientationState instances}
+   * two OrientationState instances on a cache miss, @math{\Theta(S)} on a
+   * cache hit}
    *
    * @post Each permutations' dihedrals are sorted (lexicographically)
    */
@@ -258,6 +266,15 @@ public:
     Shapes::Vertex fixedVertex,
     const std::vector<Shapes::Vertex>& perpendicularPlaneVertices
   );
+
+  /*! @brief Usage statistics of the process-wide permutation cache
+   *
+   * @see Options::compositeCacheCapacity
+   */
+  static Temple::CacheStatistics cacheStatistics();
+
+  //! Empties the process-wide permutation cache and resets its statistics
+  static void clearCache();
 //!@}
 
 //!@name Modification
@@ -339,8 +356,8 @@ private:
   //! Stores the relative orientation with which the permutations were generated
   Temple::OrderedPair<OrientationState> orientations_;
 
-  //! List of dihedral sets that comprise all spatial arrangements
-  PermutationsList stereopermutations_;
+  //! List of dihedral sets that comprise all spatial arrangements, shared
+  std::shared_ptr<const PermutationsList> stereopermutations_;
 
   //! Stores with which Alignment the stereopermutations were generated
   Alignment alignment_;
@@ -14,7 +14,7 @@
 #include "boost/optional.hpp"
 #include "boost/integer/common_factor_rt.hpp"
 
-#include <unordered_map>
+#include <map>
 
 namespace Scine {
 namespace Molassembler {
@@ -35,6 +35,31 @@ inline unsigned gcd(const std::vector<unsigned>& c) {
   return result;
 }
 
+/* Generates all elements of a shape's rotation group from its generating
+ * rotations. Applying a stereopermutation's permutation and then a rotation
+ * is the same as applying their composition.
+ */
+std::vector<Shapes::Permutation> rotationGroup(const Shapes::Shape shape) {
+  std::vector<Shapes::Permutation> elements {
+    Temple::iota<Shapes::Vertex>(Shapes::size(shape))
+  };
+
+  for(unsigned i = 0; i < elements.size(); ++i) {
+    for(const auto& rotation : Shapes::rotations(shape)) {
+      Shapes::Permutation composite = Temple::map(
+        rotation,
+        [&](const Shapes::Vertex v) { return elements[i].at(v); }
+      );
+
+      if(Temple::find(elements, composite) == std::end(elements)) {
+        elements.push_back(std::move(composite));
+      }
+    }
+  }
+
+  return elements;
+}
+
 } // namespace
 
 inline void checkArguments(const Stereopermutation& s, const Shapes::Shape shape) {
@@ -116,90 +141,104 @@ Uniques uniques(
 ) {
   checkArguments(base, shape);
 
-  const unsigned S = Shapes::size(shape);
-  auto permutation = Temple::iota<Shapes::Vertex>(S);
-  auto stereopermutation = base;
-
-  /* In case we want to skip trans pairs, the initial stereopermutation must also not
-   * have any trans spanning pairs
+  /* Applying all S! vertex permutations to the base stereopermutation yields
+   * each distinct arrangement equally often, namely once per automorphism of
+   * the base stereopermutation. A unique stereopermutation's weight is
+   * therefore proportional to the number of distinct arrangements in its
+   * rotational orbit, which in turn is the rotation group order divided by
+   * the arrangement's stabilizer order.
+   *
+   * Instead of sweeping all S! permutations, we enumerate arrangements as
+   * distinct permutations of the classes of interchangeable base positions,
+   * i.e. positions whose transposition maps the base stereopermutation onto
+   * itself. Without links, these are exactly the positions with the same
+   * character and every distinct arrangement is enumerated once. Links may
+   * cause repeated enumeration of an arrangement, which is handled by
+   * collecting orbit representatives in a map.
+   *
+   * An arrangement is its orbit's representative if no rotation maps it onto
+   * a lexicographically smaller arrangement.
    */
-  if(removeTransSpanningGroups) {
-    while(hasTransArrangedLinks(stereopermutation, shape)) {
-      bool wasLastPermutation = !Temple::next_permutation(permutation);
-      if(wasLastPermutation) {
-        /* This can happen, e.g. in square-planar AAAB with
-         * links: {0, 3}, {1, 3}, {2, 3}, every possible permutation contains
-         * trans-arranged pairs. Then we return an empty vector.
-         */
-        return {};
-      }
+  const unsigned S = Shapes::size(shape);
+  const std::vector<Shapes::Permutation> group = rotationGroup(shape);
 
-      stereopermutation = base.applyPermutation(permutation);
+  // Partition base positions into classes of interchangeable positions
+  std::vector<unsigned> classes(S, S);
+  std::vector<std::vector<Shapes::Vertex>> classPositions;
+  for(unsigned i = 0; i < S; ++i) {
+    if(classes.at(i) != S) {
+      continue;
     }
-  }
-
-  auto minElement = [](const auto& c) {
-    assert(!c.empty());
-    return *std::min_element(std::begin(c), std::end(c));
-  };
 
-  // Generate all rotations of the base stereopermutation
-  auto rotations = generateAllRotations(stereopermutation, shape);
+    const unsigned classIndex = classPositions.size();
+    classes.at(i) = classIndex;
+    classPositions.push_back({Shapes::Vertex(i)});
 
-  // The lowest rotation of the passed stereopermutation is the first unique stereopermutation
-  Uniques unordered;
-  unordered.list.push_back(minElement(rotations));
-  unordered.weights.push_back(1);
+    for(unsigned j = i + 1; j < S; ++j) {
+      if(classes.at(j) != S || base.characters.at(i) != base.characters.at(j)) {
+        continue;
+      }
 
-  // Map of rotations to the index in the unordered so we can forward matches to those weight counters
-  std::unordered_map<Stereopermutation, unsigned, boost::hash<Stereopermutation>> rotationCounterMap;
-  for(const auto& rotation : rotations) {
-    rotationCounterMap.emplace(rotation, 0);
+      auto transposition = Temple::iota<Shapes::Vertex>(S);
+      std::swap(transposition.at(i), transposition.at(j));
+      if(Stereopermutation::permuteLinks(base.links, transposition) == base.links) {
+        classes.at(j) = classIndex;
+        classPositions.back().push_back(Shapes::Vertex(j));
+      }
+    }
   }
 
-  // Go through all possible permutations of columns
-  while(Temple::next_permutation(permutation)) {
-    stereopermutation = base.applyPermutation(permutation);
-    if(removeTransSpanningGroups && hasTransArrangedLinks(stereopermutation, shape)) {
+  // Orbit representatives mapped to the number of arrangements in the orbit
+  std::map<Stereopermutation, unsigned> representatives;
+
+  // Iterate through distinct permutations of the position classes
+  std::vector<unsigned> layout = Temple::sorted(classes);
+  Shapes::Permutation permutation(S);
+  std::vector<unsigned> classCounters(classPositions.size());
+  do {
+    std::fill(std::begin(classCounters), std::end(classCounters), 0);
+    for(unsigned i = 0; i < S; ++i) {
+      const unsigned classIndex = layout[i];
+      permutation[i] = classPositions[classIndex][classCounters[classIndex]++];
+    }
+
+    const Stereopermutation arrangement = base.applyPermutation(permutation);
+    if(removeTransSpanningGroups && hasTransArrangedLinks(arrangement, shape)) {
       continue;
     }
 
-    // Is the current stereopermutation not contained within the set of rotations?
-    auto findIter = rotationCounterMap.find(stereopermutation);
-    if(findIter == std::end(rotationCounterMap)) {
-      // If so, it is a unique stereopermutation, generate all rotations
-      rotations = generateAllRotations(stereopermutation, shape);
-      unordered.list.push_back(minElement(rotations));
-      unordered.weights.push_back(1);
-      const unsigned key = unordered.weights.size() - 1;
-
-      // Move from rotations
-      for(auto& rotation : rotations) {
-        rotationCounterMap.emplace(std::move(rotation), key);
+    unsigned stabilizerOrder = 0;
+    const bool isRepresentative = Temple::all_of(
+      group,
+      [&](const Shapes::Permutation& rotation) {
+        const Stereopermutation rotated = arrangement.applyPermutation(rotation);
+        if(rotated == arrangement) {
+          ++stabilizerOrder;
+        }
+        return !(rotated < arrangement);
       }
-    } else {
-      const unsigned weightIndex = findIter->second;
-      ++unordered.weights.at(weightIndex);
-    }
-  }
+    );
 
-  // Discover an ordering permutation
-  const unsigned C = unordered.list.size();
-  const std::vector<unsigned> order = Temple::sorted(
-    Temple::iota<unsigned>(C),
-    [&](const unsigned i, const unsigned j) -> bool {
-      return unordered.list.at(i) < unordered.list.at(j);
+    if(isRepresentative) {
+      representatives.emplace(arrangement, group.size() / stabilizerOrder);
     }
-  );
+  } while(Temple::next_permutation(layout));
 
-  // Order the uniques using the discovered ordering permutation
-  Uniques ordered;
-  ordered.list.reserve(C);
-  ordered.weights.resize(C);
+  /* This can happen, e.g. in square-planar AAAB with links: {0, 3}, {1, 3},
+   * {2, 3}, every possible permutation contains trans-arranged pairs. Then we
+   * return an empty vector.
+   */
+  if(representatives.empty()) {
+    return {};
+  }
 
-  for(unsigned i = 0; i < C; ++i) {
-    ordered.list.push_back(std::move(unordered.list.at(order.at(i))));
-    ordered.weights.at(i) = unordered.weights.at(order.at(i));
+  // Representatives are ordered by the map
+  Uniques ordered;
+  ordered.list.reserve(representatives.size());
+  ordered.weights.reserve(representatives.size());
+  for(auto& representativeWeightPair : representatives) {
+    ordered.list.push_back(representativeWeightPair.first);
+    ordered.weights.push_back(representativeWeightPair.second);
   }
 
   // Divide the weights by their gcd
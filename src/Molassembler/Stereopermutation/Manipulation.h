@@ -91,7 +91,15 @@ struct MASM_EXPORT Uniques {
  * to 6 to cis arrangements. Xantphos (with bridge length 7) is the smallest
  * trans-spanning ligand mentioned in Wikipedia.
  *
- * @complexity{@math{O(S!)} where @math{S} is the size of the involved symmetry}
+ * Unique stereopermutations are the lexicographically smallest arrangements
+ * of their rotational orbits. Their weights are the number of distinct
+ * arrangements in their orbits, divided by the weights' greatest common
+ * divisor.
+ *
+ * @complexity{@math{O(A \cdot R)} where @math{A} is the number of distinct
+ * arrangements of the characters (at most @math{S! / \prod_c m_c!} for
+ * @math{m_c} occurrences of character @math{c} if there are no links) and
+ * @math{R} is the order of the shape's rotation group}
  */
 MASM_EXPORT Uniques uniques(
   const Stereopermutation& base,
@@ -5,14 +5,90 @@
  */
 #include "Molassembler/Stereopermutators/AbstractPermutations.h"
 
+#include "Molassembler/Temple/Cache.h"
 #include "Molassembler/Temple/Functional.h"
 
+#include "boost/functional/hash.hpp"
+
 #include <algorithm>
 #include <cassert>
 
 namespace Scine {
 namespace Molassembler {
 namespace Stereopermutators {
+namespace {
+
+//! Graph-independent data of the abstract stereopermutations of a site pattern
+struct CacheEntry {
+  Stereopermutations::Uniques permutations;
+  std::vector<SiteToShapeVertexMap> canonicalVertexMaps;
+};
+
+//! Shape and canonical site pattern as stereopermutation
+using CacheKey = std::pair<Shapes::Shape, Stereopermutations::Stereopermutation>;
+
+struct CacheKeyHash {
+  std::size_t operator() (const CacheKey& key) const {
+    std::size_t seed = 0;
+    boost::hash_combine(seed, static_cast<unsigned>(key.first));
+    boost::hash_combine(seed, Stereopermutations::hash_value(key.second));
+    return seed;
+  }
+};
+
+CacheEntry makeCacheEntry(const CacheKey& key) {
+  const auto& base = key.second;
+
+  CacheEntry entry;
+  entry.permutations = Stereopermutations::uniques(base, key.first, false);
+
+  /* Canonical site positions are grouped by their symbolic characters, which
+   * are consecutive in the base stereopermutation
+   */
+  RankingInformation::RankedSitesType positionalSites;
+  const unsigned S = base.characters.size();
+  for(unsigned i = 0; i < S; ++i) {
+    if(i == 0 || base.characters.at(i) != base.characters.at(i - 1)) {
+      positionalSites.emplace_back();
+    }
+    positionalSites.back().emplace_back(i);
+  }
+
+  const auto positionalLinks = Temple::map(
+    base.links,
+    [](const Stereopermutations::Stereopermutation::Link& link) {
+      RankingInformation::Link positionalLink;
+      positionalLink.sites = std::make_pair(
+        SiteIndex(link.first),
+        SiteIndex(link.second)
+      );
+      return positionalLink;
+    }
+  );
+
+  entry.canonicalVertexMaps = Temple::map(
+    entry.permutations.list,
+    [&](const Stereopermutations::Stereopermutation& stereopermutation) {
+      return siteToShapeVertexMap(
+        stereopermutation,
+        positionalSites,
+        positionalLinks
+      );
+    }
+  );
+
+  return entry;
+}
+
+using AbstractCache = Temple::ConcurrentLruCache<CacheKey, CacheEntry, CacheKeyHash>;
+
+AbstractCache& abstractCache() {
+  // Pursuant to Construct-on-first-use idiom
+  static AbstractCache cache;
+  return cache;
+}
+
+} // namespace
 
 RankingInformation::RankedSitesType Abstract::canonicalize(
   RankingInformation::RankedSitesType rankedSites
@@ -131,23 +207,51 @@ std::vector<char> Abstract::makeStereopermutationCharacters(
   return newStereopermutationCharacters;
 }
 
+CacheStatistics Abstract::cacheStatistics() {
+  return abstractCache().statistics();
+}
+
+void Abstract::clearCache() {
+  abstractCache().clear();
+}
+
 Abstract::Abstract(
   const RankingInformation& ranking,
   const Shapes::Shape shape
 ) : canonicalSites(canonicalize(ranking.siteRanking)),
     symbolicCharacters(transferToSymbolicCharacters(canonicalSites)),
-    selfReferentialLinks(selfReferentialTransform(ranking.links, canonicalSites)),
-    permutations(
-      Stereopermutations::uniques(
-        Stereopermutations::Stereopermutation {
-          symbolicCharacters,
-          selfReferentialLinks
-        },
-        shape,
-        false
-      )
-    )
-{}
+    selfReferentialLinks(selfReferentialTransform(ranking.links, canonicalSites))
+{
+  const CacheKey key {
+    shape,
+    Stereopermutations::Stereopermutation {
+      symbolicCharacters,
+      selfReferentialLinks
+    }
+  };
+  const auto entryPtr = abstractCache().get(
+    key,
+    Options::abstractStereopermutationCacheCapacity,
+    [&]() { return makeCacheEntry(key); }
+  );
+
+  permutations = entryPtr->permutations;
+  canonicalVertexMaps = entryPtr->canonicalVertexMaps;
+}
+
+SiteToShapeVertexMap Abstract::shapeVertexMap(const unsigned permutationIndex) const {
+  const SiteToShapeVertexMap& positionalMap = canonicalVertexMaps.at(permutationIndex);
+  std::vector<Shapes::Vertex> map(positionalMap.size());
+  SiteIndex position {0};
+  for(const auto& equalPrioritySet : canonicalSites) {
+    for(const SiteIndex site : equalPrioritySet) {
+      map.at(site) = positionalMap.at(position);
+      ++position;
+    }
+  }
+
+  return SiteToShapeVertexMap(std::move(map));
+}
 
 } // namespace Stereopermutators
 } // namespace Molassembler
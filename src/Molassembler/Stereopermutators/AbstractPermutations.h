@@ -10,6 +10,7 @@
 
 #include "Molassembler/Stereopermutators/ShapeVertexMaps.h"
 #include "Molassembler/Stereopermutation/Manipulation.h"
+#include "Molassembler/Options.h"
 
 namespace Scine {
 namespace Molassembler {
@@ -92,6 +93,16 @@ struct Abstract {
     const std::vector<char>& canonicalStereopermutationCharacters,
     const Temple::StrongIndexFlatMap<Shapes::Vertex, SiteIndex>& sitesAtShapeVertices
   );
+
+  /*! @brief Usage statistics of the process-wide cache of abstract
+   *   stereopermutations
+   *
+   * @see Options::abstractStereopermutationCacheCapacity
+   */
+  static CacheStatistics cacheStatistics();
+
+  //! Empties the process-wide cache and resets its statistics
+  static void clearCache();
 //!@}
 
 //!@name Constructors
@@ -103,7 +114,13 @@ struct Abstract {
    * @brief Generates the set of abstract stereopermutations and intermediate
    *   data
    *
-   * @complexity{The generation of permutations dominates: @math{\Theta(S!)}}
+   * Abstract stereopermutations and their canonical vertex maps depend only
+   * on the shape, the symbolic characters and the self-referential links.
+   * They are memoized in a process-wide, thread-safe cache.
+   *
+   * @complexity{Generation of the abstract stereopermutations dominates on a
+   * cache miss. On a cache hit, @math{\Theta(S \cdot P)} for @math{P}
+   * abstract stereopermutations}
    *
    * @param ranking Ranking object indicating chemical differences between
    *    substituents and sites
@@ -115,6 +132,18 @@ struct Abstract {
   );
 //!@}
 
+//!@name Information
+//!@{
+  /*! @brief Generates the site to shape vertex map of a stereopermutation
+   *
+   * Equivalent to siteToShapeVertexMap with the canonical sites and ranking
+   * links, but composed from the memoized canonical vertex map.
+   *
+   * @complexity{@math{\Theta(S)}}
+   */
+  SiteToShapeVertexMap shapeVertexMap(unsigned permutationIndex) const;
+//!@}
+
 //!@name Data members
 //!@{
   //! Stably resorted (by set size) site ranking
@@ -128,6 +157,14 @@ struct Abstract {
 
   //! Vector of rotationally unique stereopermutations with associated weights
   Stereopermutations::Uniques permutations;
+
+  /*! @brief For each stereopermutation, shape vertices of canonical site
+   *   positions
+   *
+   * Canonical site positions are the indices of sites when flattening
+   * canonicalSites, as in selfReferentialLinks.
+   */
+  std::vector<SiteToShapeVertexMap> canonicalVertexMaps;
 //!@}
 };
 
@@ -149,20 +149,13 @@ bool Feasible::linkPossiblyFeasible(
 }
 
 bool Feasible::possiblyFeasible(
-  const Stereopermutations::Stereopermutation& stereopermutation,
+  const SiteToShapeVertexMap& shapeVertexMap,
   const AtomIndex placement,
-  const RankingInformation::RankedSitesType& canonicalSites,
   const ConeAngleType& coneAngles,
   const RankingInformation& ranking,
   const Shapes::Shape shape,
   const Graph& graph
 ) {
-  const auto shapeVertexMap = siteToShapeVertexMap(
-    stereopermutation,
-    canonicalSites,
-    ranking.links
-  );
-
   // Check if any haptic site cones intersect
   const unsigned L = ranking.sites.size();
   for(SiteIndex siteI {0}; siteI < L - 1; ++siteI) {
@@ -282,9 +275,8 @@ Feasible::Feasible(
     for(unsigned i = 0; i < P; ++i) {
       if(
         possiblyFeasible(
-          abstractPermutations.permutations.list.at(i),
+          abstractPermutations.shapeVertexMap(i),
           placement,
-          abstractPermutations.canonicalSites,
           coneAngles,
           ranking,
           shape,
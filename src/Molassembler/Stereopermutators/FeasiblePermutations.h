@@ -53,13 +53,14 @@ struct Feasible {
    * Catches some obviously impossible stereopermutations, but does not
    * imply that the stereopermutation is truly feasibly if the test passes.
    *
+   * @param shapeVertexMap Site to shape vertex map of the stereopermutation
+   *
    * @complexity{@math{\Theta(L)}}
    * @todo Move this to SpatialModel
    */
   static bool possiblyFeasible(
-    const Stereopermutations::Stereopermutation& stereopermutation,
+    const SiteToShapeVertexMap& shapeVertexMap,
     AtomIndex placement,
-    const RankingInformation::RankedSitesType& canonicalSites,
     const ConeAngleType& coneAngles,
     const RankingInformation& ranking,
     Shapes::Shape shape,
@@ -42,6 +42,8 @@ public:
    *   level in the tree
    */
   using ChoosingFunction = std::function<ChoiceIndex(const std::vector<ChoiceIndex>&, const boost::dynamic_bitset<>&)>;
+  //! Bit representation of the contained value lists
+  using Structure = boost::dynamic_bitset<std::uint8_t>;
 //!@}
 
 //!@name Constructors
@@ -167,6 +169,37 @@ public:
 
     size_ = 0;
   }
+
+  /*! @brief Replaces the contained value lists with those of an encoded
+   *   structure
+   *
+   * @complexity{Linear in the number of nodes of the decoded trie}
+   *
+   * @param structure Result of structure() of a trie with identical bounds
+   *
+   * @throws std::logic_error If no bounds are set.
+   * @throws std::invalid_argument If the structure is malformed, e.g. if it
+   *   stems from a trie with different bounds.
+   */
+  void setStructure(const Structure& structure) {
+    if(bounds_.empty()) {
+      throw std::logic_error("No bounds are set!");
+    }
+
+    clear();
+    if(structure.empty()) {
+      return;
+    }
+
+    std::size_t position = 0;
+    root_ = decode_(structure, position, bounds_, 0);
+    if(position != structure.size()) {
+      clear();
+      throw std::invalid_argument("Trie structure has excess bits");
+    }
+
+    size_ = root_->size();
+  }
 //!@}
 
 //!@name Information
@@ -216,6 +249,25 @@ public:
   unsigned capacity() const {
     return capacity_;
   }
+
+  /*! @brief Compactly encodes the contained value lists
+   *
+   * Nodes are encoded in preorder. Inner nodes store two bits per child,
+   * whether it exists and whether its subtree is full, and full subtrees are
+   * not descended into. Leaves store one bit per child. Nearly full tries are
+   * therefore as compact as nearly empty ones.
+   *
+   * @complexity{Linear in the number of nodes not in full subtrees}
+   *
+   * @returns An empty bitset if the trie is empty
+   */
+  Structure structure() const {
+    Structure bits;
+    if(root_ && size_ > 0) {
+      root_->encode(bits);
+    }
+    return bits;
+  }
 //!@}
 
 private:
@@ -246,6 +298,8 @@ private:
     ) = 0;
 
     virtual unsigned size() const = 0;
+
+    virtual void encode(Structure& bits) const = 0;
   };
 
   //! Owning pointer to base class
@@ -363,6 +417,69 @@ private:
       return count;
     }
 
+    void encode(Structure& bits) const final {
+      const unsigned N = children.size();
+      for(unsigned i = 0; i < N; ++i) {
+        bits.push_back(static_cast<bool>(children[i]));
+        bits.push_back(fullChildren.test(i));
+      }
+
+      for(unsigned i = 0; i < N; ++i) {
+        if(children[i] && !fullChildren.test(i)) {
+          children[i]->encode(bits);
+        }
+      }
+    }
+
+    //! Creates a node whose subtree contains all value lists
+    static NodePtr full(const ChoiceList& bounds, const unsigned depth) {
+      if(depth == bounds.size() - 1) {
+        auto leafPtr = std::make_unique<Leaf>(bounds.at(depth));
+        leafPtr->children.set();
+        return leafPtr;
+      }
+
+      auto nodePtr = std::make_unique<Node>(bounds.at(depth));
+      for(auto& childPtr : nodePtr->children) {
+        childPtr = full(bounds, depth + 1);
+      }
+      nodePtr->fullChildren.set();
+      return nodePtr;
+    }
+
+    static NodePtr decode(
+      const Structure& bits,
+      std::size_t& position,
+      const ChoiceList& bounds,
+      const unsigned depth
+    ) {
+      const unsigned N = bounds.at(depth);
+      if(position + 2 * N > bits.size()) {
+        throw std::invalid_argument("Trie structure is truncated");
+      }
+
+      auto nodePtr = std::make_unique<Node>(N);
+      boost::dynamic_bitset<> existingChildren(N);
+      for(unsigned i = 0; i < N; ++i) {
+        existingChildren[i] = bits[position++];
+        nodePtr->fullChildren[i] = bits[position++];
+      }
+
+      if(!existingChildren.any() || (nodePtr->fullChildren & ~existingChildren).any()) {
+        throw std::invalid_argument("Trie structure has inconsistent node");
+      }
+
+      for(unsigned i = 0; i < N; ++i) {
+        if(nodePtr->fullChildren.test(i)) {
+          nodePtr->children[i] = full(bounds, depth + 1);
+        } else if(existingChildren.test(i)) {
+          nodePtr->children[i] = decode_(bits, position, bounds, depth + 1);
+        }
+      }
+
+      return nodePtr;
+    }
+
   private:
     std::vector<NodePtr> children;
     boost::dynamic_bitset<> fullChildren;
@@ -386,10 +503,11 @@ private:
 
       InsertResult result;
       result.insertedSomething = !children.test(choice);
-      result.subtreeIsFull = children.all();
 
       children.set(choice);
 
+      result.subtreeIsFull = children.all();
+
       return result;
     }
 
@@ -427,7 +545,37 @@ private:
       return children.count();
     }
 
+    void encode(Structure& bits) const final {
+      const unsigned N = children.size();
+      for(unsigned i = 0; i < N; ++i) {
+        bits.push_back(children.test(i));
+      }
+    }
+
+    static NodePtr decode(
+      const Structure& bits,
+      std::size_t& position,
+      const ChoiceIndex N
+    ) {
+      if(position + N > bits.size()) {
+        throw std::invalid_argument("Trie structure is truncated");
+      }
+
+      auto leafPtr = std::make_unique<Leaf>(N);
+      for(unsigned i = 0; i < N; ++i) {
+        leafPtr->children[i] = bits[position++];
+      }
+
+      if(leafPtr->children.none()) {
+        throw std::invalid_argument("Trie structure has empty leaf");
+      }
+
+      return leafPtr;
+    }
+
   private:
+    friend class Node;
+
     boost::dynamic_bitset<> children;
   };
 //!@}
@@ -443,6 +591,20 @@ private:
     }
   }
 
+  //! Decodes a node from its encoded structure
+  static NodePtr decode_(
+    const Structure& bits,
+    std::size_t& position,
+    const ChoiceList& bounds,
+    const unsigned depth
+  ) {
+    if(depth == bounds.size() - 1) {
+      return Leaf::decode(bits, position, bounds.at(depth));
+    }
+
+    return Node::decode(bits, position, bounds, depth);
+  }
+
   void establishCapacity_() {
     capacity_ = Temple::accumulate(
       bounds_,
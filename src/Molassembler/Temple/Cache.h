@@ -4,7 +4,8 @@
  *   See LICENSE.txt for details.
  * @brief Cache classes
  *
- * Contains a map-like MinimalCache and a full-blown boost::any-Cache.
+ * Contains a map-like MinimalCache, a full-blown boost::any-Cache and a
+ * thread-safe, size-bounded ConcurrentLruCache.
  */
 
 #ifndef INCLUDE_MOLASSEMBLER_TEMPLE_CACHE_H
@@ -17,6 +18,10 @@
 #include <string>
 #include <functional>
 #include <cassert>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace Scine {
@@ -231,6 +236,106 @@ private:
   std::map<KeyType, std::function<boost::any()>> generationMap_;
 };
 
+//! Usage statistics of a cache
+struct CacheStatistics {
+  //! Number of lookups answered by a cached entry
+  std::size_t hits = 0;
+  //! Number of lookups that required computation
+  std::size_t misses = 0;
+  //! Number of currently cached entries
+  std::size_t size = 0;
+};
+
+/**
+ * @brief Thread-safe, size-bounded cache of immutable shared values
+ *
+ * Least recently used entries are evicted beyond the capacity passed on
+ * lookup. Values are generated outside of the lock so that concurrent misses
+ * do not serialize. Concurrent misses of the same key may generate its value
+ * more than once, but only one is kept.
+ */
+template<typename KeyType, typename ValueType, typename Hash = std::hash<KeyType>>
+class ConcurrentLruCache {
+public:
+  using key_type = KeyType;
+  using value_type = ValueType;
+  using ValuePtr = std::shared_ptr<const ValueType>;
+
+//!@name Modification
+//!@{
+  /*! @brief Fetches a key's value, generating and caching it if missing
+   *
+   * @param key Key to look up
+   * @param capacity Maximum number of cached entries. If zero, values are
+   *   generated but not cached.
+   * @param generator Nullary callable returning the key's value
+   */
+  template<typename Generator>
+  ValuePtr get(const KeyType& key, const unsigned capacity, Generator&& generator) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const auto findIter = index_.find(key);
+      if(findIter != std::end(index_)) {
+        ++statistics_.hits;
+        entries_.splice(std::begin(entries_), entries_, findIter->second);
+        return findIter->second->second;
+      }
+
+      ++statistics_.misses;
+    }
+
+    ValuePtr valuePtr = std::make_shared<const ValueType>(generator());
+    if(capacity == 0) {
+      return valuePtr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto findIter = index_.find(key);
+    if(findIter != std::end(index_)) {
+      entries_.splice(std::begin(entries_), entries_, findIter->second);
+      return findIter->second->second;
+    }
+
+    entries_.emplace_front(key, valuePtr);
+    index_.emplace(key, std::begin(entries_));
+    while(entries_.size() > capacity) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+
+    return valuePtr;
+  }
+
+  //! Removes all entries and resets statistics
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    index_.clear();
+    entries_.clear();
+    statistics_ = CacheStatistics {};
+  }
+//!@}
+
+//!@name Information
+//!@{
+  //! Usage statistics since construction or the last clear
+  CacheStatistics statistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CacheStatistics current = statistics_;
+    current.size = entries_.size();
+    return current;
+  }
+//!@}
+
+private:
+  using ListType = std::list<std::pair<KeyType, ValuePtr>>;
+
+  mutable std::mutex mutex_;
+  //! Entries in order of most recent use
+  ListType entries_;
+  std::unordered_map<KeyType, typename ListType::iterator, Hash> index_;
+  CacheStatistics statistics_;
+};
+
 } // namespace Temple
 } // namespace Molassembler
 } // namespace Scine
@@ -324,6 +324,198 @@ private:
   };
 };
 
+/**
+ * @brief Matrix-free trust region Newton minimizer
+ *
+ * Approximately solves the trust region subproblem with the truncated
+ * conjugate gradient method of Steihaug, which only requires hessian-vector
+ * products. This makes it suitable for problems with many parameters, where
+ * the dense hessian required by TrustRegionOptimizer is too expensive to
+ * store or factorize.
+ *
+ * @tparam FloatType floating point type of the objective function
+ */
+template<typename FloatType = double>
+struct TruncatedTrustRegionOptimizer {
+  using VectorType = Eigen::Matrix<FloatType, Eigen::Dynamic, 1>;
+
+  //! Type returned from an optimization
+  struct OptimizationReturnType {
+    //! Number of iterations
+    unsigned iterations;
+    //! Final function value
+    FloatType value;
+    //! Final gradient
+    VectorType gradient;
+  };
+
+  //! Maximum number of conjugate gradient iterations per trust region step
+  unsigned conjugateGradientLimit = 100;
+  //! Initial trust radius
+  FloatType trustRadius = 1.0;
+  //! Maximum trust radius
+  FloatType trustRadiusLimit = 4.0;
+
+  /**
+   * @brief Minimize a function
+   *
+   * @param parameters Initial parameters, overwritten with the minimizer
+   * @param function Function with signature (parameters, value, gradient)
+   *   -> void, setting the value and gradient at @p parameters
+   * @param hessianProduct Function with signature (parameters, direction,
+   *   product) -> void, setting the product of the hessian at @p parameters
+   *   with @p direction
+   * @param check Checker implementing shouldContinue(iteration, value,
+   *   gradient) -> bool
+   */
+  template<
+    typename UpdateFunction,
+    typename HessianProductFunction,
+    typename Checker
+  > OptimizationReturnType minimize(
+    Eigen::Ref<VectorType> parameters,
+    UpdateFunction&& function,
+    HessianProductFunction&& hessianProduct,
+    Checker&& check
+  ) const {
+    constexpr FloatType agreementContractionUpperBound = 0.25;
+    constexpr FloatType agreementExpansionLowerBound = 0.75;
+    constexpr FloatType agreementEta = 0.125;
+
+    const unsigned P = parameters.size();
+    FloatType radius = trustRadius;
+
+    FloatType value;
+    VectorType gradient(P);
+    function(parameters, value, gradient);
+
+    VectorType proposedParameters(P);
+    FloatType proposedValue;
+    VectorType proposedGradient(P);
+    VectorType product(P);
+
+    unsigned iterations = 0;
+    for(
+      ;
+      check.shouldContinue(
+        iterations,
+        Stl17::as_const(value),
+        Stl17::as_const(gradient)
+      );
+      ++iterations
+    ) {
+      const VectorType direction = steihaug(parameters, gradient, hessianProduct, radius);
+
+      hessianProduct(parameters, direction, product);
+      const FloatType predictedReduction = -(
+        gradient.dot(direction)
+        + FloatType {0.5} * direction.dot(product)
+      );
+
+      if(predictedReduction <= 0) {
+        // The model cannot predict a decrease, so there is no sense in continuing
+        break;
+      }
+
+      proposedParameters.noalias() = parameters + direction;
+      function(proposedParameters, proposedValue, proposedGradient);
+
+      const FloatType modelAgreement = (value - proposedValue) / predictedReduction;
+
+      /* Adjust trust radius if necessary */
+      if(modelAgreement < agreementContractionUpperBound) {
+        radius *= agreementContractionUpperBound;
+      } else if(
+        modelAgreement > agreementExpansionLowerBound
+        && direction.norm() >= FloatType {0.99} * radius
+      ) {
+        radius = std::min(2 * radius, trustRadiusLimit);
+      }
+
+      /* Decide what to do with the step */
+      if(modelAgreement > agreementEta) {
+        parameters = proposedParameters;
+        value = proposedValue;
+        std::swap(gradient, proposedGradient);
+      }
+    }
+
+    return {
+      iterations,
+      value,
+      std::move(gradient)
+    };
+  }
+
+private:
+  //! Find the step to the trust radius boundary along a direction
+  static FloatType boundaryStep(
+    const VectorType& z,
+    const VectorType& d,
+    const FloatType radius
+  ) {
+    const FloatType a = d.squaredNorm();
+    const FloatType b = 2 * z.dot(d);
+    const FloatType c = z.squaredNorm() - radius * radius;
+    return (-b + std::sqrt(b * b - 4 * a * c)) / (2 * a);
+  }
+
+  /**
+   * @brief Approximately minimize the quadratic model within the trust region
+   *
+   * Conjugate gradient iterations on the model are truncated on reaching the
+   * trust radius, on encountering a direction of non-positive curvature, or
+   * once the residual is sufficiently reduced.
+   */
+  template<typename HessianProductFunction>
+  VectorType steihaug(
+    const VectorType& parameters,
+    const VectorType& gradient,
+    HessianProductFunction&& hessianProduct,
+    const FloatType radius
+  ) const {
+    const unsigned P = parameters.size();
+    const FloatType gradientNorm = gradient.norm();
+    const FloatType tolerance = std::min(FloatType {0.5}, std::sqrt(gradientNorm)) * gradientNorm;
+
+    VectorType z = VectorType::Zero(P);
+    if(gradientNorm == 0) {
+      return z;
+    }
+
+    VectorType r = gradient;
+    VectorType d = -r;
+    VectorType Bd(P);
+    FloatType rSquaredNorm = r.squaredNorm();
+
+    for(unsigned j = 0; j < conjugateGradientLimit; ++j) {
+      hessianProduct(parameters, d, Bd);
+      const FloatType curvature = d.dot(Bd);
+      if(curvature <= 0) {
+        return z + boundaryStep(z, d, radius) * d;
+      }
+
+      const FloatType alpha = rSquaredNorm / curvature;
+      const VectorType zNext = z + alpha * d;
+      if(zNext.norm() >= radius) {
+        return z + boundaryStep(z, d, radius) * d;
+      }
+
+      z = zNext;
+      r += alpha * Bd;
+      const FloatType rNextSquaredNorm = r.squaredNorm();
+      if(std::sqrt(rNextSquaredNorm) < tolerance) {
+        return z;
+      }
+
+      d = -r + (rNextSquaredNorm / rSquaredNorm) * d;
+      rSquaredNorm = rNextSquaredNorm;
+    }
+
+    return z;
+  }
+};
+
 } // namespace Temple
 } // namespace Molassembler
 } // namespace Scine
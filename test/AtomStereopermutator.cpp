@@ -10,7 +10,9 @@
 #include "Molassembler/Conformers.h"
 #include "Molassembler/Graph.h"
 #include "Molassembler/IO.h"
+#include "Molassembler/IO/SmilesParser.h"
 #include "Molassembler/Molecule.h"
+#include "Molassembler/Options.h"
 #include "Molassembler/StereopermutatorList.h"
 #include "Molassembler/Stereopermutators/ShapeVertexMaps.h"
 #include "Molassembler/Stereopermutation/Manipulation.h"
@@ -360,3 +362,31 @@ BOOST_FIXTURE_TEST_CASE(AtomStereopermutatorContinuity, LowTemperatureFixture) {
     testSymmetryPair(shapePair.first, shapePair.second);
   }
 }
+
+BOOST_AUTO_TEST_CASE(AbstractStereopermutationCache, *boost::unit_test::label("Molassembler")) {
+  const std::string smiles = "C[C@H](Cl)C[C@@H](Cl)C[C@H](Cl)C";
+
+  clearAbstractStereopermutationCache();
+  const Molecule first = IO::Experimental::parseSmilesSingleMolecule(smiles);
+  const CacheStatistics afterFirst = abstractStereopermutationCacheStatistics();
+  // Repeated site patterns, e.g. of methyl groups, are memoized
+  BOOST_CHECK_GT(afterFirst.misses, 0);
+  BOOST_CHECK_GT(afterFirst.hits, 0);
+  BOOST_CHECK_LE(afterFirst.size, afterFirst.misses);
+
+  // All site patterns of the same molecule are cached
+  const Molecule second = IO::Experimental::parseSmilesSingleMolecule(smiles);
+  const CacheStatistics afterSecond = abstractStereopermutationCacheStatistics();
+  BOOST_CHECK_EQUAL(afterSecond.misses, afterFirst.misses);
+  BOOST_CHECK_GT(afterSecond.hits, afterFirst.hits);
+  BOOST_CHECK(second == first);
+
+  // Memoization does not alter stereopermutators
+  const unsigned priorCapacity = Options::abstractStereopermutationCacheCapacity;
+  Options::abstractStereopermutationCacheCapacity = 0;
+  clearAbstractStereopermutationCache();
+  const Molecule uncached = IO::Experimental::parseSmilesSingleMolecule(smiles);
+  BOOST_CHECK_EQUAL(abstractStereopermutationCacheStatistics().size, 0);
+  Options::abstractStereopermutationCacheCapacity = priorCapacity;
+  BOOST_CHECK(uncached == first);
+}
@@ -10,6 +10,10 @@
 #include "boost/test/unit_test.hpp"
 
 #include "Molassembler/DirectedConformerGenerator.h"
+#include "Molassembler/DistanceGeometry/SpatialModel.h"
+#include "Molassembler/DistanceGeometry/Error.h"
+#include "Molassembler/BondStereopermutator.h"
+#include "Molassembler/StereopermutatorList.h"
 #include "Molassembler/Molecule.h"
 #include "Molassembler/Graph.h"
 #include "Molassembler/IO/SmilesParser.h"
@@ -27,6 +31,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <map>
 
 using namespace std::string_literals;
 using namespace Scine;
@@ -107,6 +112,130 @@ BOOST_AUTO_TEST_CASE(DirectedConformerGeneration, *boost::unit_test::label("DG")
   }
 }
 
+BOOST_AUTO_TEST_CASE(DirConfGenDeferredDihedrals, *boost::unit_test::label("DG")) {
+  /* Dihedral constraints of the relevant bonds can be created separately from
+   * a spatial model that defers them
+   */
+  auto mol = IO::read("directed_conformer_generation/pentane.mol");
+  DirectedConformerGenerator generator(mol);
+  const auto& bonds = generator.bondList();
+  BOOST_REQUIRE_EQUAL(bonds.size(), 2);
+
+  const DistanceGeometry::Configuration configuration {};
+  const auto sameConstraints = [](
+    const DistanceGeometry::DihedralConstraint& a,
+    const DistanceGeometry::DihedralConstraint& b
+  ) -> bool {
+    return a.sites == b.sites && a.lower == b.lower && a.upper == b.upper;
+  };
+
+  while(generator.decisionListSetSize() != generator.idealEnsembleSize()) {
+    const auto decisionList = generator.generateNewDecisionList();
+    const Molecule conformationMolecule = generator.conformationMolecule(decisionList);
+    const auto& stereopermutators = conformationMolecule.stereopermutators();
+
+    const auto fullConstraints = DistanceGeometry::SpatialModel {
+      conformationMolecule,
+      configuration
+    }.getDihedralConstraints();
+
+    const auto deferredConstraints = DistanceGeometry::SpatialModel {
+      conformationMolecule,
+      configuration,
+      bonds
+    }.getDihedralConstraints();
+    BOOST_CHECK(deferredConstraints.empty());
+
+    std::vector<DistanceGeometry::DihedralConstraint> separateConstraints;
+    for(const BondIndex& bond : bonds) {
+      const auto bondConstraints = DistanceGeometry::SpatialModel::makeDihedralConstraints(
+        stereopermutators.at(bond),
+        stereopermutators.at(bond.first),
+        stereopermutators.at(bond.second),
+        configuration.spatialModelLoosening
+      );
+      separateConstraints.insert(
+        std::end(separateConstraints),
+        std::begin(bondConstraints),
+        std::end(bondConstraints)
+      );
+    }
+
+    BOOST_REQUIRE_EQUAL(fullConstraints.size(), separateConstraints.size());
+    for(const auto& constraint : separateConstraints) {
+      BOOST_CHECK_MESSAGE(
+        Temple::any_of(
+          fullConstraints,
+          [&](const auto& fullConstraint) { return sameConstraints(constraint, fullConstraint); }
+        ),
+        "Separately made dihedral constraint not found in full spatial model"
+      );
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(DirConfGenFixedPositionsAlternation, *boost::unit_test::label("DG")) {
+  /* Calls with and without fixed positions on the same generator must not
+   * affect one another: results for a seed are the same as from a fresh
+   * generator
+   */
+  auto mol = IO::read("directed_conformer_generation/pentane.mol");
+  const auto fitting = BondStereopermutator::FittingMode::Nearest;
+  const DistanceGeometry::Configuration plain {};
+
+  DirectedConformerGenerator reference(mol);
+  const auto decisionList = reference.generateNewDecisionList();
+  const unsigned maxTries = 10;
+  unsigned seed = 0;
+  auto referencePlain = reference.generateConformation(decisionList, seed, plain, fitting);
+  while(!referencePlain && seed < maxTries) {
+    ++seed;
+    referencePlain = reference.generateConformation(decisionList, seed, plain, fitting);
+  }
+  BOOST_REQUIRE_MESSAGE(
+    referencePlain,
+    "Could not generate pentane conformer w/ decision list "
+      << Temple::stringify(decisionList) << " in " << maxTries << " attempts"
+  );
+
+  DistanceGeometry::Configuration fixed {};
+  for(AtomIndex i = 0; i < mol.graph().N(); ++i) {
+    if(mol.graph().elementType(i) == Utils::ElementType::C) {
+      fixed.fixedPositions.emplace_back(i, referencePlain.value().row(i));
+    }
+  }
+  const auto referenceFixed = DirectedConformerGenerator(mol).generateConformation(
+    decisionList,
+    seed,
+    fixed,
+    fitting
+  );
+
+  const auto sameResult = [](const auto& a, const auto& b) -> bool {
+    if(a && b) {
+      return a.value().isApprox(b.value(), 1e-6);
+    }
+
+    return !a && !b && a.error() == b.error();
+  };
+
+  // Fixed positions after a call without
+  DirectedConformerGenerator plainFirst(mol);
+  BOOST_CHECK(sameResult(plainFirst.generateConformation(decisionList, seed, plain, fitting), referencePlain));
+  BOOST_CHECK_MESSAGE(
+    sameResult(plainFirst.generateConformation(decisionList, seed, fixed, fitting), referenceFixed),
+    "Fixed positions are ignored after a call without them"
+  );
+
+  // Calls without fixed positions after one with
+  DirectedConformerGenerator fixedFirst(mol);
+  BOOST_CHECK(sameResult(fixedFirst.generateConformation(decisionList, seed, fixed, fitting), referenceFixed));
+  BOOST_CHECK_MESSAGE(
+    sameResult(fixedFirst.generateConformation(decisionList, seed, plain, fitting), referencePlain),
+    "Calls without fixed positions differ after a call with them"
+  );
+}
+
 BOOST_FIXTURE_TEST_CASE(DirectedConfGenHomomorphicSwap, LowTemperatureFixture, *boost::unit_test::label("DG")) {
   auto mol = IO::Experimental::parseSmilesSingleMolecule("CCN");
   DirectedConformerGenerator generator {mol};
@@ -226,4 +355,226 @@ BOOST_AUTO_TEST_CASE(DirConfGenRelabeler, *boost::unit_test::label("DG")) {
   auto bins = relabeler.bins();
   auto binIndices = relabeler.binIndices(bins);
   auto midpoints = relabeler.binMidpointIntegers(binIndices, bins);
+
+  // The streaming relabeler reproduces bins and labels in two passes
+  auto streamingRelabeler = generator.streamingRelabeler();
+  for(const auto& pos : conformers) {
+    streamingRelabeler.add(pos);
+  }
+
+  const auto streamingBins = streamingRelabeler.bins();
+  BOOST_CHECK(streamingBins == bins);
+  for(unsigned i = 0; i < conformers.size(); ++i) {
+    const auto structureBinIndices = streamingRelabeler.binIndices(conformers.at(i), streamingBins);
+    BOOST_CHECK(structureBinIndices == binIndices.at(i));
+    BOOST_CHECK(
+      streamingRelabeler.binMidpointIntegers(structureBinIndices, streamingBins)
+      == midpoints.at(i)
+    );
+  }
+
+  BOOST_CHECK_THROW(
+    streamingRelabeler.bins(streamingRelabeler.cellWidth() / 2),
+    std::invalid_argument
+  );
+}
+
+BOOST_AUTO_TEST_CASE(DirConfGenEnumeration, *boost::unit_test::label("DG")) {
+  // Octane's decision list space is large enough to be split into shards
+  auto mol = IO::Experimental::parseSmilesSingleMolecule("CCCCCCCC");
+  auto generator = DirectedConformerGenerator(mol);
+  const unsigned seed = 1007;
+
+  using ResultMap = std::map<
+    DirectedConformerGenerator::DecisionList,
+    Utils::PositionCollection
+  >;
+
+  auto enumerate = [&]() {
+    ResultMap results;
+    generator.enumerate(
+      [&](const auto& decisionList, const auto& conformer) {
+        BOOST_CHECK_MESSAGE(
+          results.emplace(decisionList, conformer).second,
+          "Decision list " << Temple::stringify(decisionList) << " enumerated twice"
+        );
+      },
+      seed
+    );
+    return results;
+  };
+
+  const ResultMap a = enumerate();
+  BOOST_CHECK_EQUAL(generator.decisionListSetSize(), generator.idealEnsembleSize());
+  BOOST_CHECK_GT(a.size(), 0);
+
+  const ResultMap b = enumerate();
+  BOOST_REQUIRE_EQUAL(a.size(), b.size());
+  for(const auto& result : a) {
+    const auto findIter = b.find(result.first);
+    BOOST_REQUIRE_MESSAGE(
+      findIter != std::end(b),
+      "Decision list " << Temple::stringify(result.first) << " not reproduced"
+    );
+    BOOST_CHECK(result.second.isApprox(findIter->second, 1e-3));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(DirConfGenCheckpoint, *boost::unit_test::label("DG")) {
+  auto mol = IO::Experimental::parseSmilesSingleMolecule("CCCCCCC");
+  const unsigned seed = 1009;
+
+  using ResultMap = std::map<
+    DirectedConformerGenerator::DecisionList,
+    Utils::PositionCollection
+  >;
+
+  // Checkpoint partway through an uninterrupted enumeration
+  DirectedConformerGenerator generator(mol);
+  const unsigned checkpointAfter = 20;
+  ResultMap full;
+  ResultMap priorToCheckpoint;
+  DirectedConformerGenerator::Checkpoint checkpoint;
+  generator.enumerate(
+    [&](const auto& decisionList, const auto& conformer) {
+      full.emplace(decisionList, conformer);
+      if(full.size() <= checkpointAfter) {
+        priorToCheckpoint.emplace(decisionList, conformer);
+        if(full.size() == checkpointAfter) {
+          checkpoint = generator.checkpoint();
+        }
+      }
+    },
+    seed
+  );
+  BOOST_REQUIRE_GT(full.size(), checkpointAfter);
+  BOOST_REQUIRE(!checkpoint.empty());
+
+  // Resume with a separate generator
+  DirectedConformerGenerator resumingGenerator(mol);
+  ResultMap resumed;
+  resumingGenerator.resumeEnumeration(
+    checkpoint,
+    [&](const auto& decisionList, const auto& conformer) {
+      BOOST_CHECK_MESSAGE(
+        priorToCheckpoint.count(decisionList) == 0,
+        "Resumed enumeration repeats " << Temple::stringify(decisionList)
+      );
+      resumed.emplace(decisionList, conformer);
+    }
+  );
+  BOOST_CHECK_EQUAL(
+    resumingGenerator.decisionListSetSize(),
+    resumingGenerator.idealEnsembleSize()
+  );
+
+  // Together, both parts are the uninterrupted enumeration
+  BOOST_CHECK_EQUAL(priorToCheckpoint.size() + resumed.size(), full.size());
+  for(const auto& result : resumed) {
+    const auto findIter = full.find(result.first);
+    BOOST_REQUIRE(findIter != std::end(full));
+    BOOST_CHECK(result.second.isApprox(findIter->second, 1e-3));
+  }
+
+  // Checkpoints are bound to the considered bonds
+  DirectedConformerGenerator otherGenerator(
+    IO::Experimental::parseSmilesSingleMolecule("CCCCCC")
+  );
+  BOOST_CHECK_THROW(
+    otherGenerator.resumeEnumeration(checkpoint, [](const auto&, const auto&) {}),
+    std::invalid_argument
+  );
+}
+
+BOOST_AUTO_TEST_CASE(DirConfGenDecisionListBatch, *boost::unit_test::label("DG")) {
+  auto mol = IO::Experimental::parseSmilesSingleMolecule("CCCCCC");
+  auto generator = DirectedConformerGenerator(mol);
+  const unsigned N = mol.graph().N();
+
+  // Collect a few conformers as a trajectory
+  std::vector<Utils::PositionCollection> conformers;
+  generator.enumerate(
+    [&](const auto& /* decisionList */, const auto& conformer) {
+      conformers.push_back(conformer);
+    },
+    1011
+  );
+  BOOST_REQUIRE_GT(conformers.size(), 1);
+
+  Utils::PositionCollection frames(conformers.size() * N, 3);
+  for(unsigned f = 0; f < conformers.size(); ++f) {
+    frames.middleRows(f * N, N) = conformers.at(f);
+  }
+
+  for(const auto mode : {
+    BondStereopermutator::FittingMode::Thresholded,
+    BondStereopermutator::FittingMode::Nearest
+  }) {
+    const auto decisions = generator.getDecisionLists(frames, mode);
+    BOOST_REQUIRE_EQUAL(decisions.rows(), conformers.size());
+    BOOST_REQUIRE_EQUAL(decisions.cols(), generator.bondList().size());
+    for(unsigned f = 0; f < conformers.size(); ++f) {
+      const auto decisionList = generator.getDecisionList(conformers.at(f), mode);
+      for(unsigned b = 0; b < decisionList.size(); ++b) {
+        BOOST_CHECK_EQUAL(
+          static_cast<unsigned>(decisions(f, b)),
+          static_cast<unsigned>(decisionList.at(b))
+        );
+      }
+    }
+  }
+
+  // Frame rows must be a multiple of the number of atoms
+  BOOST_CHECK_THROW(
+    generator.getDecisionLists(frames.topRows(N + 1)),
+    std::invalid_argument
+  );
+}
+
+BOOST_AUTO_TEST_CASE(DirConfGenFragmentEmbedding, *boost::unit_test::label("DG")) {
+  /* Conformers from the invariant model must be embeddable in fragments,
+   * which need the pairwise bounds after smoothing
+   */
+  auto mol = IO::Experimental::parseSmilesSingleMolecule("CCCCCCCC");
+  DirectedConformerGenerator generator(mol);
+  BOOST_REQUIRE(!generator.bondList().empty());
+
+  DistanceGeometry::Configuration configuration {};
+  configuration.fragmentSize = 10;
+  BOOST_REQUIRE_GT(mol.graph().N(), configuration.fragmentSize);
+
+  /* Some decision lists are embedded successfully in fragments only in about
+   * one in six attempts. Seeded attempts keep the test reproducible.
+   */
+  const auto fitting = BondStereopermutator::FittingMode::Nearest;
+  const unsigned maxTries = 40;
+  for(unsigned i = 0; i < 3; ++i) {
+    const auto decisionList = generator.generateNewDecisionList();
+    bool success = false;
+    for(unsigned attempt = 0; attempt < maxTries; ++attempt) {
+      const auto conformerResult = generator.generateConformation(
+        decisionList,
+        attempt,
+        configuration,
+        fitting
+      );
+      if(conformerResult) {
+        success = true;
+        break;
+      }
+
+      // Embedding failures are acceptable, unexpected exceptions are not
+      BOOST_REQUIRE_MESSAGE(
+        conformerResult.error() != DgError::UnknownException,
+        "Fragment embedding of conformer w/ decision list "
+          << Temple::stringify(decisionList) << " encountered an exception"
+      );
+    }
+
+    BOOST_CHECK_MESSAGE(
+      success,
+      "Could not generate fragment embedded conformer w/ decision list: "
+        << Temple::stringify(decisionList) << " in " << maxTries << " attempts"
+    );
+  }
 }
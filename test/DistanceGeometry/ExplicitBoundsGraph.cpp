@@ -107,3 +107,84 @@ BOOST_AUTO_TEST_CASE(ExplicitBoundsGraphStructure, *boost::unit_test::label("DG"
   }
 #endif
 }
+
+BOOST_AUTO_TEST_CASE(ExplicitBoundsGraphCopies, *boost::unit_test::label("DG")) {
+  using namespace Scine::Molassembler;
+
+  Molecule molecule = IO::read("stereocenter_detection_molecules/2R-chlorobutane.mol");
+  DistanceGeometry::SpatialModel spatialModel {molecule, DistanceGeometry::Configuration {}};
+
+  using EG = DistanceGeometry::ExplicitBoundsGraph;
+  const EG pristine {
+    molecule.graph().inner(),
+    spatialModel.makePairwiseBounds()
+  };
+
+  const auto edgeCount = boost::num_edges(pristine.graph());
+  const unsigned N = molecule.graph().N();
+  const auto upperBound = pristine.upperBound(0, 1);
+
+  // Distance choices on a copy must leave the original untouched
+  EG copy = pristine;
+  auto distancesMatrixResult = copy.makeDistanceMatrix(randomnessEngine());
+  BOOST_REQUIRE(distancesMatrixResult);
+
+  BOOST_CHECK_EQUAL(boost::num_edges(pristine.graph()), edgeCount);
+  BOOST_CHECK_EQUAL(pristine.upperBound(0, 1), upperBound);
+
+  // After all distance choices, every pair is represented by six edges
+  BOOST_CHECK_EQUAL(boost::num_edges(copy.graph()), 3 * N * (N - 1));
+  BOOST_CHECK_EQUAL(copy.upperBound(0, 1), distancesMatrixResult.value()(0, 1));
+}
+
+BOOST_AUTO_TEST_CASE(ExplicitBoundsGraphSparseBounds, *boost::unit_test::label("DG")) {
+  using namespace Scine::Molassembler;
+
+  for(
+    const boost::filesystem::path& currentFilePath :
+    boost::filesystem::recursive_directory_iterator("stereocenter_detection_molecules")
+  ) {
+    Molecule molecule = IO::read(currentFilePath.string());
+    const auto& inner = molecule.graph().inner();
+    const unsigned N = molecule.graph().N();
+
+    DistanceGeometry::SpatialModel spatialModel {molecule, DistanceGeometry::Configuration {}};
+    const auto dense = spatialModel.makePairwiseBounds();
+    const auto sparse = spatialModel.makeSparsePairwiseBounds();
+
+    // Sparse bounds store exactly the pairs set in the dense bounds
+    BOOST_REQUIRE_EQUAL(sparse.N(), N);
+    BOOST_CHECK_MESSAGE(
+      sparse.dense() == dense,
+      "Sparse and dense pairwise bounds differ for " << currentFilePath.string()
+    );
+    BOOST_CHECK_LT(sparse.explicitCount(), N * (N - 1) / 2 + 1);
+
+    // Round trip through a dense matrix preserves the explicit pairs
+    const DistanceGeometry::SparseBounds roundTrip {inner, dense};
+    BOOST_CHECK_EQUAL(roundTrip.explicitCount(), sparse.explicitCount());
+
+    // Graphs from either representation are identical
+    using EG = DistanceGeometry::ExplicitBoundsGraph;
+    const EG fromDense {inner, dense};
+    const EG fromSparse {inner, sparse};
+    BOOST_REQUIRE_EQUAL(
+      boost::num_edges(fromDense.graph()),
+      boost::num_edges(fromSparse.graph())
+    );
+    for(AtomIndex i = 0; i < N; ++i) {
+      for(AtomIndex j = i + 1; j < N; ++j) {
+        // Bounds are only queryable for explicit pairs
+        const bool explicitPair = boost::edge(EG::left(i), EG::left(j), fromDense.graph()).second;
+        BOOST_REQUIRE_EQUAL(
+          explicitPair,
+          boost::edge(EG::left(i), EG::left(j), fromSparse.graph()).second
+        );
+        if(explicitPair) {
+          BOOST_CHECK_EQUAL(fromDense.lowerBound(i, j), fromSparse.lowerBound(i, j));
+          BOOST_CHECK_EQUAL(fromDense.upperBound(i, j), fromSparse.upperBound(i, j));
+        }
+      }
+    }
+  }
+}
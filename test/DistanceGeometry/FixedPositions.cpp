@@ -10,6 +10,7 @@
 #include "boost/test/unit_test.hpp"
 
 #include "Molassembler/Conformers.h"
+#include "Molassembler/Graph.h"
 #include "Molassembler/Molecule.h"
 #include "Molassembler/IO.h"
 
@@ -86,3 +87,39 @@ BOOST_AUTO_TEST_CASE(FixedPositionsWork, *boost::unit_test::label("DG")) {
     "The ring-like positions aren't fixed as required."
   );
 }
+
+BOOST_AUTO_TEST_CASE(FixedAtomElimination, *boost::unit_test::label("DG")) {
+  auto octadecane = IO::read("various/octadecane.mol");
+
+  // Fix all carbon atoms at the positions of a generated conformer
+  auto referenceResult = generateRandomConformation(octadecane, DistanceGeometry::Configuration {});
+  BOOST_REQUIRE(referenceResult);
+
+  DistanceGeometry::Configuration config;
+  config.fixedAtomElimination = true;
+  for(AtomIndex i = 0; i < octadecane.graph().N(); ++i) {
+    if(octadecane.graph().elementType(i) == Utils::ElementType::C) {
+      config.fixedPositions.emplace_back(i, referenceResult.value().row(i));
+    }
+  }
+  BOOST_REQUIRE(!config.fixedPositions.empty());
+
+  auto conformerResult = generateRandomConformation(octadecane, config);
+  if(!conformerResult) {
+    BOOST_FAIL(
+      "Could not generate a conformer for octadecane with carbon atoms "
+      "eliminated from refinement: " << conformerResult.error().message()
+    );
+  }
+
+  // Eliminated atoms are placed exactly
+  for(const auto& fixedPositionPair : config.fixedPositions) {
+    BOOST_CHECK_MESSAGE(
+      conformerResult.value().row(fixedPositionPair.first).isApprox(
+        fixedPositionPair.second,
+        1e-6
+      ),
+      "Fixed atom " << fixedPositionPair.first << " is not exactly placed"
+    );
+  }
+}
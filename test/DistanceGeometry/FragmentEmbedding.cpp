@@ -0,0 +1,90 @@
+/*!@file
+ * @copyright This code is licensed under the 3-clause BSD license.
+ *   Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.
+ *   See LICENSE.txt for details.
+ */
+
+#include "boost/test/unit_test.hpp"
+
+#include "Molassembler/DistanceGeometry/FragmentEmbedding.h"
+#include "Molassembler/Graph/PrivateGraph.h"
+#include "Molassembler/Conformers.h"
+#include "Molassembler/Graph.h"
+#include "Molassembler/IO/SmilesParser.h"
+#include "Molassembler/Molecule.h"
+
+#include "Molassembler/Temple/Functional.h"
+
+using namespace Scine;
+using namespace Molassembler;
+using namespace DistanceGeometry;
+
+namespace {
+
+const std::string longChain = "CCCCCCCCCCCC[C@H](Cl)CCCCCCCCCCCC";
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(FragmentationPartition, *boost::unit_test::label("DG")) {
+  const Molecule mol = IO::Experimental::parseSmilesSingleMolecule(longChain);
+  const PrivateGraph& inner = mol.graph().inner();
+  const unsigned N = inner.N();
+  const unsigned targetSize = 20;
+
+  const auto data = gatherDGInformation(mol, Configuration {});
+  const auto fragmentation = Fragmentation::make(inner, data.rotatableGroups, targetSize);
+  BOOST_REQUIRE_GT(fragmentation.fragments.size(), 1);
+  BOOST_CHECK_EQUAL(fragmentation.fragments.size(), fragmentation.cutBonds.size() + 1);
+  BOOST_CHECK_EQUAL(fragmentation.extendedFragments.size(), fragmentation.fragments.size());
+
+  // Fragments partition the atoms and are no larger than the target size
+  std::vector<unsigned> fragmentOf(N, fragmentation.fragments.size());
+  for(unsigned f = 0; f < fragmentation.fragments.size(); ++f) {
+    const auto& fragment = fragmentation.fragments.at(f);
+    BOOST_CHECK_LE(fragment.size(), targetSize);
+    BOOST_CHECK(std::is_sorted(std::begin(fragment), std::end(fragment)));
+    for(const AtomIndex i : fragment) {
+      BOOST_CHECK_EQUAL(fragmentOf.at(i), fragmentation.fragments.size());
+      fragmentOf.at(i) = f;
+    }
+  }
+  BOOST_CHECK(
+    Temple::all_of(fragmentOf, [&](unsigned f) { return f < fragmentation.fragments.size(); })
+  );
+
+  // Cut bonds join distinct fragments
+  for(const BondIndex& bond : fragmentation.cutBonds) {
+    BOOST_CHECK_NE(fragmentOf.at(bond.first), fragmentOf.at(bond.second));
+  }
+
+  // No fragmentation if the molecule is small enough
+  BOOST_CHECK_EQUAL(
+    Fragmentation::make(inner, data.rotatableGroups, N).fragments.size(),
+    1
+  );
+}
+
+BOOST_AUTO_TEST_CASE(FragmentEmbeddingConformers, *boost::unit_test::label("DG")) {
+  const Molecule mol = IO::Experimental::parseSmilesSingleMolecule(longChain);
+  const unsigned seed = 1013;
+  const unsigned ensembleSize = 3;
+
+  Configuration configuration;
+  configuration.fragmentSize = 20;
+
+  const auto a = generateEnsemble(mol, ensembleSize, seed, configuration);
+  const auto b = generateEnsemble(mol, ensembleSize, seed, configuration);
+  BOOST_REQUIRE_EQUAL(a.size(), ensembleSize);
+  BOOST_REQUIRE_EQUAL(b.size(), ensembleSize);
+
+  for(unsigned i = 0; i < ensembleSize; ++i) {
+    if(!a.at(i)) {
+      BOOST_FAIL("Fragment embedded conformer #" << i << " failed: " << a.at(i).error().message());
+    }
+    BOOST_REQUIRE(b.at(i).has_value());
+    BOOST_CHECK_MESSAGE(
+      a.at(i).value().isApprox(b.at(i).value(), 1e-3),
+      "Fragment embedded conformer #" << i << " is not reproducible"
+    );
+  }
+}
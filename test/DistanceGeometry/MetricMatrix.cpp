@@ -182,7 +182,7 @@ BOOST_AUTO_TEST_CASE(MetricMatrixConstructionIsInvariantUnderOrderingSwap, *boos
 
     DistanceBoundsMatrix distanceBounds {
       molecule.graph().inner(),
-      DgData.bounds
+      DgData.boundsPtr->dense()
     };
 
     // choose a random reordering
@@ -264,3 +264,41 @@ BOOST_AUTO_TEST_CASE(ExplicitExampleFromLecture, *boost::unit_test::label("DG"))
     << expectedMetricMatrix << "\ngot " << metric.access() << " instead.\n"
   );
 }
+
+BOOST_AUTO_TEST_CASE(PartialDiagonalizationEmbedding, *boost::unit_test::label("DG")) {
+  auto pairwiseDistances = [](const Eigen::MatrixXd& positions) -> Eigen::MatrixXd {
+    const unsigned N = positions.cols();
+    Eigen::MatrixXd distances(N, N);
+    for(unsigned i = 0; i < N; ++i) {
+      for(unsigned j = 0; j < N; ++j) {
+        distances(i, j) = (positions.col(i) - positions.col(j)).norm();
+      }
+    }
+    return distances;
+  };
+
+  std::uniform_real_distribution<double> noise(0.9, 1.1);
+  for(const unsigned N : {40u, 200u}) {
+    // Noisy distances between random points in a cube
+    const Eigen::MatrixXd points = Eigen::MatrixXd::Random(3, N) * std::cbrt(N);
+    Eigen::MatrixXd distances = pairwiseDistances(points);
+    for(unsigned i = 0; i < N; ++i) {
+      for(unsigned j = i + 1; j < N; ++j) {
+        distances(i, j) *= noise(randomnessEngine());
+      }
+    }
+
+    const MetricMatrix metric {distances};
+    const Eigen::MatrixXd fullEmbedding = metric.embedWithFullDiagonalization();
+    const auto partialEmbedding = metric.embedWithPartialDiagonalization();
+    BOOST_REQUIRE_MESSAGE(partialEmbedding, "Partial diagonalization did not converge for N = " << N);
+
+    // Eigenvector signs are arbitrary, so compare embedded distances instead
+    const Eigen::MatrixXd fullDistances = pairwiseDistances(fullEmbedding);
+    const Eigen::MatrixXd partialDistances = pairwiseDistances(partialEmbedding.value());
+    BOOST_CHECK_MESSAGE(
+      partialDistances.isApprox(fullDistances, 1e-6),
+      "Partial and full diagonalization embeddings differ for N = " << N
+    );
+  }
+}
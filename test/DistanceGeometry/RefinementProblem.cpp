@@ -24,6 +24,7 @@
 #include "Molassembler/DistanceGeometry/MetricMatrix.h"
 #include "Molassembler/DistanceGeometry/DistanceBoundsMatrix.h"
 #include "Molassembler/DistanceGeometry/EigenRefinement.h"
+#include "Molassembler/DistanceGeometry/FixedAtomsRefinement.h"
 #include "Molassembler/Graph/PrivateGraph.h"
 #include "Molassembler/IO.h"
 
@@ -63,7 +64,7 @@ struct RefinementBaseData {
 
     distanceBounds = DistanceBoundsMatrix {
       molecule.graph().inner(),
-      DgInfo.bounds
+      DgInfo.boundsPtr->dense()
     };
 
     chiralConstraints = std::move(DgInfo.chiralConstraints);
@@ -545,7 +546,15 @@ struct CompareImplementations {
               - static_cast<double>(uError)
             );
 
-            if(errorAbsDifference > Traits::Floating<SmallerFPType>::tolerance) {
+            /* Implementations may sum the error terms in different orders, so
+             * the tolerance is relative for large error values
+             */
+            const double errorTolerance = Traits::Floating<SmallerFPType>::tolerance * std::max(
+              1.0,
+              std::fabs(static_cast<double>(uError))
+            );
+
+            if(errorAbsDifference > errorTolerance) {
               std::cout << "Error values for component "
                 << std::get<0>(comparisonTuple) << " do not match between "
                 << RefinementT::name() << " and " << RefinementU::name() << " for "
@@ -607,3 +616,173 @@ BOOST_AUTO_TEST_CASE(RefinementProblemEquivalence, *boost::unit_test::label("DG"
     "Not all refinement template argument of float variations match pair-wise!"
   );
 }
+
+BOOST_AUTO_TEST_CASE(RefinementProblemDistancePruning, *boost::unit_test::label("DG")) {
+  using RefinementType = EigenRefinementProblem<4, double, false>;
+  using VectorType = typename RefinementType::VectorType;
+
+  for(
+    const boost::filesystem::path& currentFilePath :
+    boost::filesystem::recursive_directory_iterator("ez_stereocenters")
+  ) {
+    RefinementBaseData baseData {currentFilePath.string()};
+
+    RefinementType pruned {
+      baseData.squaredBounds(),
+      baseData.chiralConstraints,
+      baseData.dihedralConstraints
+    };
+    RefinementType unpruned = pruned;
+    unpruned.pruneDistanceTerms = false;
+
+    VectorType positions = baseData.linearizeEmbeddedPositions();
+
+    /* Alternate small displacements (reusing the active pair list) and large
+     * displacements (forcing a rebuild)
+     */
+    for(unsigned step = 0; step < 20; ++step) {
+      const double scale = (step % 5 == 4) ? 1.0 : 0.05;
+      positions += scale * VectorType::Random(positions.size());
+
+      double prunedValue = 0;
+      VectorType prunedGradient = VectorType::Zero(positions.size());
+      pruned.distanceContributions(positions, prunedValue, prunedGradient);
+
+      double unprunedValue = 0;
+      VectorType unprunedGradient = VectorType::Zero(positions.size());
+      unpruned.distanceContributions(positions, unprunedValue, unprunedGradient);
+
+      BOOST_CHECK_MESSAGE(
+        std::fabs(prunedValue - unprunedValue) <= 1e-12 * std::max(1.0, std::fabs(unprunedValue)),
+        "Pruned distance error " << prunedValue << " differs from unpruned "
+        << unprunedValue << " for " << currentFilePath.string()
+      );
+      BOOST_CHECK_MESSAGE(
+        prunedGradient.isApprox(unprunedGradient, 1e-12) || (prunedGradient - unprunedGradient).norm() <= 1e-12,
+        "Pruned distance gradient differs from unpruned for " << currentFilePath.string()
+      );
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(RefinementProblemHessianVectorProducts, *boost::unit_test::label("DG")) {
+  using RefinementType = EigenRefinementProblem<4, double, false>;
+  using VectorType = typename RefinementType::VectorType;
+
+  for(
+    const boost::filesystem::path& currentFilePath :
+    boost::filesystem::recursive_directory_iterator("ez_stereocenters")
+  ) {
+    RefinementBaseData baseData {currentFilePath.string()};
+
+    // Dihedral terms only contribute an approximate hessian
+    RefinementType refinementFunctor {
+      baseData.squaredBounds(),
+      baseData.chiralConstraints,
+      {}
+    };
+    refinementFunctor.compressFourthDimension = true;
+
+    const VectorType positions = baseData.linearizeEmbeddedPositions();
+    const unsigned P = positions.size();
+
+    for(unsigned repeat = 0; repeat < 5; ++repeat) {
+      const VectorType direction = VectorType::Random(P);
+
+      VectorType product(P);
+      refinementFunctor.hessianVectorProduct(positions, direction, product);
+
+      // Central finite difference of the analytical gradient
+      constexpr double h = 1e-6;
+      double value;
+      VectorType forwardGradient(P);
+      VectorType backwardGradient(P);
+      refinementFunctor(positions + h * direction, value, forwardGradient);
+      refinementFunctor(positions - h * direction, value, backwardGradient);
+      const VectorType finiteDifference = (forwardGradient - backwardGradient) / (2 * h);
+
+      BOOST_CHECK_MESSAGE(
+        (product - finiteDifference).norm() <= 1e-4 * std::max(1.0, finiteDifference.norm()),
+        "Hessian-vector product deviates from finite difference of gradients for "
+        << currentFilePath.string() << ": " << (product - finiteDifference).norm()
+      );
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(RefinementProblemFixedAtomElimination, *boost::unit_test::label("DG")) {
+  using RefinementType = EigenRefinementProblem<4, double, false>;
+  using FixedRefinementType = FixedAtomsRefinementProblem<4, double, false>;
+  using VectorType = typename RefinementType::VectorType;
+
+  for(
+    const boost::filesystem::path& currentFilePath :
+    boost::filesystem::recursive_directory_iterator("ez_stereocenters")
+  ) {
+    RefinementBaseData baseData {currentFilePath.string()};
+    VectorType positions = baseData.linearizeEmbeddedPositions();
+    const unsigned N = positions.size() / 4;
+
+    // Fix every other atom
+    std::vector<bool> fixedAtoms(N, false);
+    for(unsigned i = 0; i < N; i += 2) {
+      fixedAtoms.at(i) = true;
+    }
+
+    RefinementType full {
+      baseData.squaredBounds(),
+      baseData.chiralConstraints,
+      baseData.dihedralConstraints
+    };
+    FixedRefinementType reduced {
+      baseData.squaredBounds(),
+      baseData.chiralConstraints,
+      baseData.dihedralConstraints,
+      fixedAtoms
+    };
+    full.compressFourthDimension = reduced.compressFourthDimension = true;
+    full.dihedralTerms = reduced.dihedralTerms = true;
+
+    VectorType parameters = reduced.reduce(positions);
+    BOOST_REQUIRE_EQUAL(reduced.freeAtomCount(), N / 2);
+    BOOST_REQUIRE_EQUAL(parameters.size(), 4 * (N / 2));
+
+    boost::optional<double> valueOffset;
+    for(unsigned step = 0; step < 10; ++step) {
+      parameters += 0.1 * VectorType::Random(parameters.size());
+      positions = reduced.expand(parameters);
+
+      double fullValue = 0;
+      VectorType fullGradient(positions.size());
+      full(positions, fullValue, fullGradient);
+
+      double reducedValue = 0;
+      VectorType reducedGradient(parameters.size());
+      reduced(parameters, reducedValue, reducedGradient);
+
+      // Free atom gradients match, values differ by constant terms only
+      for(unsigned k = 0, i = 0; i < N; ++i) {
+        if(fixedAtoms.at(i)) {
+          continue;
+        }
+
+        BOOST_CHECK_MESSAGE(
+          (reducedGradient.segment<4>(4 * k) - fullGradient.segment<4>(4 * i)).norm() <= 1e-10 * std::max(1.0, fullGradient.segment<4>(4 * i).norm()),
+          "Gradient of free atom " << i << " differs with fixed atoms eliminated for "
+          << currentFilePath.string()
+        );
+        ++k;
+      }
+
+      const double offset = fullValue - reducedValue;
+      if(!valueOffset) {
+        valueOffset = offset;
+      }
+      BOOST_CHECK_MESSAGE(
+        std::fabs(offset - valueOffset.value()) <= 1e-8 * std::max(1.0, std::fabs(fullValue)),
+        "Error function of eliminated problem does not differ by a constant for "
+        << currentFilePath.string()
+      );
+    }
+  }
+}
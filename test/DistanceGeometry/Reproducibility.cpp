@@ -123,3 +123,127 @@ BOOST_AUTO_TEST_CASE(ReproducibleEnsembles, *boost::unit_test::label("DG")) {
     "Not all conformers could be matched between two re-seeded ensemble generations"
   );
 }
+
+BOOST_AUTO_TEST_CASE(StreamedEnsembles, *boost::unit_test::label("DG")) {
+  const unsigned seed = 6564;
+  const unsigned ensembleSize = 10;
+
+  Molecule mol = IO::read("stereocenter_detection_molecules/RSs-halogenated-propane.mol");
+  const auto collected = generateEnsemble(mol, ensembleSize, seed);
+
+  std::vector<unsigned> callCounts(ensembleSize, 0);
+  generateEnsemble(mol, ensembleSize, seed,
+    [&](const unsigned i, outcome::result<Scine::Utils::PositionCollection> streamed) {
+      BOOST_REQUIRE_LT(i, ensembleSize);
+      ++callCounts.at(i);
+      BOOST_REQUIRE_EQUAL(streamed.has_value(), collected.at(i).has_value());
+      if(streamed) {
+        BOOST_CHECK_MESSAGE(
+          streamed.value().isApprox(collected.at(i).value(), 1e-3),
+          "Streamed conformer #" << i << " differs from collected conformer"
+        );
+      }
+    }
+  );
+
+  BOOST_CHECK_MESSAGE(
+    Temple::all_of(callCounts, [](const unsigned count) { return count == 1; }),
+    "Not every conformer index was delivered exactly once: "
+    << Temple::stringify(callCounts)
+  );
+}
+
+BOOST_AUTO_TEST_CASE(BudgetedEnsembles, *boost::unit_test::label("DG")) {
+  const unsigned seed = 6564;
+  const unsigned ensembleSize = 10;
+
+  Molecule mol = IO::read("stereocenter_detection_molecules/RSs-halogenated-propane.mol");
+  const auto collected = generateEnsemble(mol, ensembleSize, seed);
+  const unsigned collectedSuccesses = Temple::accumulate(collected, 0u,
+    [](const unsigned count, const auto& result) -> unsigned {
+      return count + static_cast<unsigned>(result.has_value());
+    }
+  );
+  BOOST_REQUIRE_GT(collectedSuccesses, 0);
+
+  DistanceGeometry::EnsembleBudget budget;
+  budget.successes = 3;
+  budget.maxAttempts = ensembleSize;
+  const auto budgeted = generateEnsemble(mol, budget, seed);
+  BOOST_REQUIRE(budgeted);
+  BOOST_CHECK_EQUAL(
+    budgeted.value().size(),
+    std::min(budget.successes, collectedSuccesses)
+  );
+
+  // Every budgeted structure is one of the unbudgeted ensemble's
+  for(const auto& positions : budgeted.value()) {
+    BOOST_CHECK_MESSAGE(
+      Temple::any_of(collected,
+        [&](const auto& result) -> bool {
+          return result && result.value().isApprox(positions, 1e-3);
+        }
+      ),
+      "Budgeted structure not found in unbudgeted ensemble with same seed"
+    );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(BatchedEnsembles, *boost::unit_test::label("DG")) {
+  const unsigned seed = 6564;
+
+  const Molecule propane = IO::read("stereocenter_detection_molecules/RSs-halogenated-propane.mol");
+  const Molecule chlorobutane = IO::read("stereocenter_detection_molecules/2R-chlorobutane.mol");
+  const Molecule octadecane = IO::read("various/octadecane.mol");
+
+  const auto a = generateEnsembles({propane, chlorobutane}, {4, 3}, seed);
+  const auto b = generateEnsembles({propane, octadecane}, {4, 2}, seed);
+  BOOST_REQUIRE_EQUAL(a.size(), 2);
+  BOOST_REQUIRE_EQUAL(b.size(), 2);
+  BOOST_CHECK_EQUAL(a.front().size(), 4);
+  BOOST_CHECK_EQUAL(a.back().size(), 3);
+  BOOST_CHECK_EQUAL(b.back().size(), 2);
+
+  // A molecule's results are independent of the other molecules in the batch
+  for(unsigned i = 0; i < 4; ++i) {
+    const auto& x = a.front().at(i);
+    const auto& y = b.front().at(i);
+    BOOST_REQUIRE_EQUAL(x.has_value(), y.has_value());
+    if(x) {
+      BOOST_CHECK_MESSAGE(
+        x.value().isApprox(y.value(), 1e-3),
+        "Batched conformer #" << i << " depends on other molecules in the batch"
+      );
+    }
+  }
+
+  BOOST_CHECK_THROW(
+    generateEnsembles({propane, chlorobutane}, {4}, seed),
+    std::invalid_argument
+  );
+}
+
+BOOST_AUTO_TEST_CASE(MixedPrecisionEnsembles, *boost::unit_test::label("DG")) {
+  const unsigned seed = 6564;
+  const unsigned ensembleSize = 5;
+
+  Molecule mol = IO::read("stereocenter_detection_molecules/RSs-halogenated-propane.mol");
+  DistanceGeometry::Configuration configuration;
+  configuration.mixedPrecisionRefinement = true;
+
+  const auto a = generateEnsemble(mol, ensembleSize, seed, configuration);
+  const auto b = generateEnsemble(mol, ensembleSize, seed, configuration);
+  BOOST_REQUIRE_EQUAL(a.size(), ensembleSize);
+  BOOST_REQUIRE_EQUAL(b.size(), ensembleSize);
+
+  for(unsigned i = 0; i < ensembleSize; ++i) {
+    if(!a.at(i)) {
+      BOOST_FAIL("Mixed precision conformer #" << i << " failed: " << a.at(i).error().message());
+    }
+    BOOST_REQUIRE(b.at(i).has_value());
+    BOOST_CHECK_MESSAGE(
+      a.at(i).value().isApprox(b.at(i).value(), 1e-3),
+      "Mixed precision conformer #" << i << " is not reproducible"
+    );
+  }
+}
@@ -12,7 +12,77 @@
 using namespace Scine::Molassembler;
 using namespace DistanceGeometry;
 
+namespace {
+
+//! Unblocked triple loop Floyd's algorithm for reference
+void referenceSmooth(Eigen::Ref<Eigen::MatrixXd> matrix) {
+  const unsigned N = matrix.cols();
+
+  for(AtomIndex k = 0; k < N; ++k) {
+    for(AtomIndex i = 0; i < N - 1; ++i) {
+      auto upperLowerIK = (i < k
+        ? std::pair<double&, double&>(matrix(i, k), matrix(k, i))
+        : std::pair<double&, double&>(matrix(k, i), matrix(i, k))
+      );
+      double& upperIK = upperLowerIK.first;
+      double& lowerIK = upperLowerIK.second;
+
+      if(lowerIK > upperIK) {
+        throw std::runtime_error("Triangle smoothing encountered bound inversion");
+      }
+
+      for(AtomIndex j = i + 1; j < N; ++j) {
+        double& upperIJ = matrix(i, j);
+        double& lowerIJ = matrix(j, i);
+
+        auto upperLowerJK = (j < k
+          ? std::pair<double&, double&>(matrix(j, k), matrix(k, j))
+          : std::pair<double&, double&>(matrix(k, j), matrix(j, k))
+        );
+        double& upperJK = upperLowerJK.first;
+        double& lowerJK = upperLowerJK.second;
+
+        if(upperIJ > upperIK + upperJK) {
+          upperIJ = upperIK + upperJK;
+        }
+
+        if(lowerIJ < lowerIK - upperJK) {
+          lowerIJ = lowerIK - upperJK;
+        } else if(lowerIJ < lowerJK - upperIK) {
+          lowerIJ = lowerJK - upperIK;
+        }
+
+        if(lowerIJ > upperIJ) {
+          throw std::runtime_error("Triangle smoothing encountered bound inversion");
+        }
+      }
+    }
+  }
+}
+
+/* Consistent bounds from random points in a cube: Tight bounds for close
+ * pairs and some distant pairs, default bounds for all others
+ */
+Eigen::MatrixXd randomBounds(const unsigned N) {
+  const Eigen::MatrixXd points = Eigen::MatrixXd::Random(3, N) * 2 * std::cbrt(N);
+  Eigen::MatrixXd bounds(N, N);
+  bounds.diagonal().setZero();
+  for(unsigned i = 0; i < N; ++i) {
+    for(unsigned j = i + 1; j < N; ++j) {
+      const double distance = (points.col(i) - points.col(j)).norm();
+      if(distance < 3 || (i + j) % 37 == 0) {
+        bounds(i, j) = 1.05 * distance;
+        bounds(j, i) = 0.95 * distance;
+      } else {
+        bounds(i, j) = DistanceBoundsMatrix::defaultUpper;
+        bounds(j, i) = DistanceBoundsMatrix::defaultLower;
+      }
+    }
+  }
+  return bounds;
+}
 
+} // namespace
 
 BOOST_AUTO_TEST_CASE(TriangleSmoothingFloydExplicit, *boost::unit_test::label("DG")) {
   Eigen::Matrix4d input;
@@ -77,3 +147,36 @@ BOOST_AUTO_TEST_CASE(TetrangleSmoothingDetectsViolations, *boost::unit_test::lab
 
   BOOST_CHECK_THROW(tetrangleSmooth(impossibleBounds), std::runtime_error);
 }
+
+BOOST_AUTO_TEST_CASE(TriangleSmoothingBlocked, *boost::unit_test::label("DG")) {
+  // Three pivot blocks, the last one partial
+  const unsigned N = 2 * DistanceBoundsMatrix::smoothingBlockSize + 22;
+  const Eigen::MatrixXd bounds = randomBounds(N);
+
+  Eigen::MatrixXd blocked = bounds;
+  DistanceBoundsMatrix::smooth(blocked);
+  Eigen::MatrixXd reference = bounds;
+  referenceSmooth(reference);
+
+  const double maxDeviation = (blocked - reference).cwiseAbs().maxCoeff();
+  BOOST_CHECK_MESSAGE(
+    maxDeviation < 1e-10,
+    "Blocked triangle smoothing deviates from the unblocked reference by "
+    << maxDeviation
+  );
+
+  /* Contradict the bounds across blocks: Atoms 0 and 70 are at most two apart
+   * through atom 140, but must be at least five apart
+   */
+  Eigen::MatrixXd impossibleBounds = bounds;
+  impossibleBounds(0, 140) = 1.0;
+  impossibleBounds(140, 0) = 0.5;
+  impossibleBounds(70, 140) = 1.0;
+  impossibleBounds(140, 70) = 0.5;
+  impossibleBounds(0, 70) = DistanceBoundsMatrix::defaultUpper;
+  impossibleBounds(70, 0) = 5.0;
+
+  reference = impossibleBounds;
+  BOOST_CHECK_THROW(referenceSmooth(reference), std::runtime_error);
+  BOOST_CHECK_THROW(DistanceBoundsMatrix::smooth(impossibleBounds), std::runtime_error);
+}
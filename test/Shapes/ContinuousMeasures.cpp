@@ -603,6 +603,67 @@ BOOST_AUTO_TEST_CASE(ShapeMeasuresHeuristics, *boost::unit_test::label("Shapes")
   }
 }
 
+BOOST_AUTO_TEST_CASE(ShapeMeasuresBranchAndBound, *boost::unit_test::label("Shapes")) {
+#ifdef NDEBUG
+  constexpr unsigned testingShapeSizeLimit = 7;
+#else
+  constexpr unsigned testingShapeSizeLimit = 5;
+#endif
+
+  for(const Shape shape : allShapes) {
+    auto shapeCoordinates = Continuous::normalize(
+      addOrigin(coordinates(shape))
+    );
+    randomlyRotate(shapeCoordinates);
+    const double ideal = Continuous::shapeBranchAndBoundCentroidLast(shapeCoordinates, shape).measure;
+    BOOST_CHECK_MESSAGE(
+      ideal < 0.1,
+      "Expected CShM < 0.1 for rotated coordinates of " << name(shape) << ", but got " << ideal
+    );
+
+    if(size(shape) > testingShapeSizeLimit) {
+      continue;
+    }
+
+    for(unsigned i = 1; i < 5; ++i) {
+      const double distortionNorm = 0.1 * i;
+      auto distorted = shapeCoordinates;
+      distort(distorted, distortionNorm);
+      distorted = Continuous::normalize(distorted);
+
+      const double alternate = Continuous::shapeAlternateImplementation(distorted, shape).measure;
+      const double exact = Continuous::shapeBranchAndBound(distorted, shape).measure;
+      BOOST_CHECK_CLOSE(alternate, exact, 1e-6);
+
+      const double alternateCentroidLast = Continuous::shapeAlternateImplementationCentroidLast(distorted, shape).measure;
+      const double exactCentroidLast = Continuous::shapeBranchAndBoundCentroidLast(distorted, shape).measure;
+      BOOST_CHECK_CLOSE(alternateCentroidLast, exactCentroidLast, 1e-6);
+    }
+  }
+
+  /* The largest shapes are too big for the alternate implementation, but
+   * branch and bound must still not be beaten by the heuristics
+   */
+  for(const Shape shape : allShapes) {
+    if(size(shape) < 10 || size(shape) > 12) {
+      continue;
+    }
+
+    auto distorted = Continuous::normalize(addOrigin(coordinates(shape)));
+    randomlyRotate(distorted);
+    distort(distorted, 0.2);
+    distorted = Continuous::normalize(distorted);
+
+    const double heuristic = Continuous::shapeHeuristics(distorted, shape).measure;
+    const double exact = Continuous::shapeBranchAndBound(distorted, shape).measure;
+    BOOST_CHECK_MESSAGE(
+      exact <= heuristic + 1e-6,
+      "Exact CShM " << exact << " of distorted " << name(shape)
+        << " exceeds heuristic CShM " << heuristic
+    );
+  }
+}
+
 BOOST_AUTO_TEST_CASE(MinimumDistortionConstants, *boost::unit_test::label("Shapes")) {
   /* NOTES
    * - These constants are from https://pubs.acs.org/doi/10.1021/ja036479n
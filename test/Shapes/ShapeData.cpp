@@ -21,6 +21,8 @@
 #include "Molassembler/Shapes/PropertyCaching.h"
 #include "Molassembler/Shapes/Data.h"
 
+#include <cassert>
+#include <cstring>
 #include <set>
 #include <numeric>
 #include <iostream>
@@ -768,3 +770,183 @@ BOOST_AUTO_TEST_CASE(DimensionalityProperty, *boost::unit_test::label("Shapes"))
   BOOST_CHECK(!threeDimensional(Shape::Hexagon));
   BOOST_CHECK(threeDimensional(Shape::Icosahedron));
 }
+
+namespace {
+
+/* Encodes a mappings table with a single transition as CBOR by hand, since
+ * tests have no JSON library at hand
+ */
+struct CborWriter {
+  std::vector<std::uint8_t> bytes;
+
+  void head(const std::uint8_t major, const unsigned value) {
+    assert(value < 256);
+    if(value < 24) {
+      bytes.push_back((major << 5) | value);
+    } else {
+      bytes.push_back((major << 5) | 24);
+      bytes.push_back(value);
+    }
+  }
+
+  void integer(const int value) {
+    if(value >= 0) {
+      head(0, value);
+    } else {
+      head(1, -1 - value);
+    }
+  }
+
+  void floating(const double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(double));
+    bytes.push_back(0xfb);
+    for(int shift = 56; shift >= 0; shift -= 8) {
+      bytes.push_back((bits >> shift) & 0xff);
+    }
+  }
+
+  void text(const std::string& value) {
+    head(3, value.size());
+    bytes.insert(std::end(bytes), std::begin(value), std::end(value));
+  }
+};
+
+std::vector<std::uint8_t> singleTransitionTable(
+  const Shape a,
+  const Shape b,
+  const int removed,
+  const std::vector<unsigned>& mapping,
+  const double angularDistortion
+) {
+  CborWriter writer;
+  writer.head(5, 2);
+  writer.text("n");
+  writer.integer(nShapes);
+  writer.text("t");
+  writer.head(4, 1);
+  writer.head(4, 6);
+  writer.integer(nameIndex(a));
+  writer.integer(nameIndex(b));
+  writer.integer(removed);
+  writer.floating(angularDistortion);
+  writer.floating(0.0);
+  writer.head(4, 1);
+  writer.head(4, mapping.size());
+  for(const unsigned v : mapping) {
+    writer.integer(v);
+  }
+  return writer.bytes;
+}
+
+std::vector<unsigned> identityMapping(const unsigned size) {
+  std::vector<unsigned> mapping(size);
+  std::iota(std::begin(mapping), std::end(mapping), 0);
+  return mapping;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(MappingsTable, *boost::unit_test::label("Shapes")) {
+  const unsigned maxShapeSize = 5;
+  Shapes::populateMappings(maxShapeSize);
+
+  // Every transition between small shapes is stored and consistent
+  for(const Shape a : allShapes) {
+    for(const Shape b : allShapes) {
+      if(a == b || size(a) > maxShapeSize || size(b) > maxShapeSize) {
+        continue;
+      }
+
+      const int sizeDiff = static_cast<int>(size(b)) - static_cast<int>(size(a));
+      if(sizeDiff == 0 || sizeDiff == 1) {
+        const auto mappingOption = Shapes::getMapping(a, b);
+        BOOST_REQUIRE(mappingOption);
+        const auto expected = Properties::selectBestTransitionMappings(
+          Properties::shapeTransitionMappings(a, b)
+        );
+        BOOST_CHECK_CLOSE(mappingOption->angularDistortion, expected.angularDistortion, 1e-8);
+        BOOST_CHECK_EQUAL(mappingOption->indexMappings.size(), expected.indexMappings.size());
+      } else if(sizeDiff == -1) {
+        BOOST_CHECK(Shapes::getMapping(a, b, Vertex(0)));
+      }
+    }
+  }
+
+  // Tables round-trip
+  const std::vector<std::uint8_t> table = Shapes::dumpMappings();
+  BOOST_CHECK_NO_THROW(Shapes::loadMappings(table));
+  BOOST_CHECK(Shapes::dumpMappings() == table);
+
+  // Malformed tables are rejected
+  BOOST_CHECK_THROW(
+    Shapes::loadMappings(std::vector<std::uint8_t>(table.begin(), table.begin() + table.size() / 2)),
+    std::invalid_argument
+  );
+
+  /* Transitions between the largest shapes are not stored, so loading them
+   * must store them. A distinct distortion marks the loaded transitions.
+   */
+  const double marker = 42.0;
+  BOOST_REQUIRE_NO_THROW(
+    Shapes::loadMappings(
+      singleTransitionTable(Shape::Icosahedron, Shape::Cuboctahedron, -1, identityMapping(12), marker)
+    )
+  );
+  const auto loadedOption = Shapes::getMapping(Shape::Icosahedron, Shape::Cuboctahedron);
+  BOOST_REQUIRE(loadedOption);
+  BOOST_CHECK_EQUAL(loadedOption->angularDistortion, marker);
+  BOOST_REQUIRE_EQUAL(loadedOption->indexMappings.size(), 1);
+  BOOST_CHECK_EQUAL(loadedOption->indexMappings.front().size(), 12);
+
+  BOOST_REQUIRE_NO_THROW(
+    Shapes::loadMappings(
+      singleTransitionTable(Shape::Icosahedron, Shape::EdgeContractedIcosahedron, 3, identityMapping(11), marker)
+    )
+  );
+  const auto lossOption = Shapes::getMapping(Shape::Icosahedron, Shape::EdgeContractedIcosahedron, Vertex(3));
+  BOOST_REQUIRE(lossOption);
+  BOOST_CHECK_EQUAL(lossOption->angularDistortion, marker);
+
+  // Mappings must have the length the transition requires
+  BOOST_CHECK_THROW(
+    Shapes::loadMappings(
+      singleTransitionTable(Shape::Cuboctahedron, Shape::Icosahedron, -1, identityMapping(11), marker)
+    ),
+    std::invalid_argument
+  );
+  BOOST_CHECK_THROW(
+    Shapes::loadMappings(
+      singleTransitionTable(Shape::Icosahedron, Shape::EdgeContractedIcosahedron, 4, identityMapping(12), marker)
+    ),
+    std::invalid_argument
+  );
+
+  // Only transitions to a shape of one size less have a removed vertex
+  BOOST_CHECK_THROW(
+    Shapes::loadMappings(
+      singleTransitionTable(Shape::Cuboctahedron, Shape::Icosahedron, 0, identityMapping(12), marker)
+    ),
+    std::invalid_argument
+  );
+  BOOST_CHECK_THROW(
+    Shapes::loadMappings(
+      singleTransitionTable(Shape::EdgeContractedIcosahedron, Shape::Icosahedron, 0, identityMapping(12), marker)
+    ),
+    std::invalid_argument
+  );
+  BOOST_CHECK_THROW(
+    Shapes::loadMappings(
+      singleTransitionTable(Shape::Icosahedron, Shape::EdgeContractedIcosahedron, -1, identityMapping(11), marker)
+    ),
+    std::invalid_argument
+  );
+
+  // Shapes must differ in size by at most one
+  BOOST_CHECK_THROW(
+    Shapes::loadMappings(
+      singleTransitionTable(Shape::Icosahedron, Shape::BicappedSquareAntiprism, 0, identityMapping(10), marker)
+    ),
+    std::invalid_argument
+  );
+}
@@ -5,6 +5,7 @@
  */
 #include <boost/test/unit_test.hpp>
 
+#include "Molassembler/Options.h"
 #include "Molassembler/Shapes/Data.h"
 #include "Molassembler/Stereopermutation/Composites.h"
 #include "Molassembler/Temple/Adaptors/Zip.h"
@@ -601,3 +602,53 @@ BOOST_AUTO_TEST_CASE(CompositeCombinedAlignments, *boost::unit_test::label("Ster
   };
   BOOST_CHECK_EQUAL(bothTriangleTetrahedron.allPermutations().size(), 6);
 }
+
+BOOST_AUTO_TEST_CASE(CompositeMemoization, *boost::unit_test::label("Stereopermutations")) {
+  const auto makeComposite = [](const std::size_t left, const std::size_t right) {
+    return Composite {
+      Composite::OrientationState {
+        Shapes::Shape::Octahedron,
+        4_v,
+        {'A', 'B', 'C', 'D', 'E', 'F'},
+        left
+      },
+      Composite::OrientationState {
+        Shapes::Shape::Tetrahedron,
+        0_v,
+        {'A', 'B', 'C', 'D'},
+        right
+      },
+      Composite::Alignment::Staggered
+    };
+  };
+
+  clearCompositeCache();
+  const Composite a = makeComposite(0, 1);
+  BOOST_CHECK_EQUAL(compositeCacheStatistics().misses, 1);
+
+  // Identifiers do not affect the generated permutations
+  const Composite b = makeComposite(4, 7);
+  const auto statistics = compositeCacheStatistics();
+  BOOST_CHECK_EQUAL(statistics.misses, 1);
+  BOOST_CHECK_EQUAL(statistics.hits, 1);
+  BOOST_CHECK_EQUAL(statistics.size, 1);
+  BOOST_CHECK_EQUAL(&a.allPermutations(), &b.allPermutations());
+  BOOST_CHECK_EQUAL(b.orientations().first.identifier, 7);
+
+  // Memoization does not alter the generated permutations
+  const unsigned priorCapacity = Options::compositeCacheCapacity;
+  Options::compositeCacheCapacity = 0;
+  clearCompositeCache();
+  const Composite c = makeComposite(0, 1);
+  BOOST_CHECK_EQUAL(compositeCacheStatistics().size, 0);
+  Options::compositeCacheCapacity = priorCapacity;
+
+  BOOST_REQUIRE_EQUAL(c.allPermutations().size(), a.allPermutations().size());
+  for(unsigned i = 0; i < a.allPermutations().size(); ++i) {
+    const auto& p = a.allPermutations().at(i);
+    const auto& q = c.allPermutations().at(i);
+    BOOST_CHECK(p.alignedVertices == q.alignedVertices);
+    BOOST_CHECK(p.rankingEquivalentTo == q.rankingEquivalentTo);
+    BOOST_CHECK(p.close(q.dihedrals));
+  }
+}
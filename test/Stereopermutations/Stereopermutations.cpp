@@ -10,7 +10,11 @@
 #include <vector>
 #include <cassert>
 #include <functional>
+#include <map>
 #include <numeric>
+#include <tuple>
+
+#include "boost/integer/common_factor_rt.hpp"
 
 #include "Molassembler/Shapes/Data.h"
 #include "Molassembler/Shapes/Properties.h"
@@ -19,6 +23,7 @@
 #include "Molassembler/Stereopermutation/RotationEnumerator.h"
 
 #include "Molassembler/Temple/Functional.h"
+#include "Molassembler/Temple/Permutations.h"
 #include "Molassembler/Temple/Random.h"
 #include "Molassembler/Temple/Stringify.h"
 #include "Molassembler/Temple/constexpr/LogicalOperatorTests.h"
@@ -405,6 +410,79 @@ BOOST_AUTO_TEST_CASE(OctahedralCaseWithoutTransRemoval, *boost::unit_test::label
   BOOST_CHECK_EQUAL(unique.list.size(), 4);
 }
 
+//! Reference uniques by sweeping all vertex permutations
+Uniques sweepUniques(
+  const Stereopermutation& base,
+  const Shapes::Shape shape,
+  const bool removeTransSpanningGroups
+) {
+  std::map<Stereopermutation, unsigned> counts;
+  auto permutation = Temple::iota<Shapes::Vertex>(Shapes::size(shape));
+  do {
+    const auto stereopermutation = base.applyPermutation(permutation);
+    if(removeTransSpanningGroups && hasTransArrangedLinks(stereopermutation, shape)) {
+      continue;
+    }
+
+    const auto rotations = generateAllRotations(stereopermutation, shape);
+    ++counts[*std::min_element(std::begin(rotations), std::end(rotations))];
+  } while(Temple::next_permutation(permutation));
+
+  Uniques sweep;
+  for(const auto& countPair : counts) {
+    sweep.list.push_back(countPair.first);
+    sweep.weights.push_back(countPair.second);
+  }
+
+  if(!sweep.weights.empty()) {
+    const unsigned divisor = Temple::accumulate(
+      sweep.weights,
+      sweep.weights.front(),
+      [](const unsigned a, const unsigned b) { return boost::integer::gcd(a, b); }
+    );
+    for(unsigned& weight : sweep.weights) {
+      weight /= divisor;
+    }
+  }
+
+  return sweep;
+}
+
+BOOST_AUTO_TEST_CASE(UniquesMatchPermutationSweep, *boost::unit_test::label("Stereopermutations")) {
+  const std::vector<std::tuple<Shapes::Shape, Characters, PairSet>> cases {
+    {Shapes::Shape::Tetrahedron, {'A', 'A', 'B', 'C'}, {}},
+    {Shapes::Shape::Tetrahedron, {'A', 'A', 'B', 'B'}, {{0, 1}}},
+    {Shapes::Shape::Square, {'A', 'A', 'A', 'B'}, {{0, 1}, {1, 2}, {2, 3}}},
+    {Shapes::Shape::Square, {'A', 'A', 'B', 'B'}, {{0, 1}, {2, 3}}},
+    {Shapes::Shape::TrigonalBipyramid, {'A', 'A', 'B', 'B', 'C'}, {{0, 1}}},
+    {Shapes::Shape::Octahedron, {'A', 'A', 'A', 'A', 'B', 'B'}, {}},
+    {Shapes::Shape::Octahedron, {'A', 'A', 'A', 'A', 'A', 'A'}, {{0, 1}, {2, 3}, {4, 5}}},
+    {Shapes::Shape::Octahedron, {'A', 'B', 'A', 'B', 'C', 'C'}, {{0, 1}, {2, 3}}},
+    {Shapes::Shape::Octahedron, {'A', 'A', 'B', 'B', 'C', 'D'}, {{0, 1}, {1, 2}}},
+  };
+
+  for(const auto& testCase : cases) {
+    const Shapes::Shape shape = std::get<0>(testCase);
+    const Stereopermutation base {
+      std::get<1>(testCase),
+      makeLinks(std::get<2>(testCase))
+    };
+
+    for(const bool removeTrans : {false, true}) {
+      const auto orbits = uniques(base, shape, removeTrans);
+      const auto sweep = sweepUniques(base, shape, removeTrans);
+      BOOST_CHECK_MESSAGE(
+        orbits.list == sweep.list && orbits.weights == sweep.weights,
+        "Uniques of " << base.toString() << " in " << Shapes::name(shape)
+        << (removeTrans ? " without trans links" : "")
+        << " differ from permutation sweep: weights "
+        << Temple::stringify(orbits.weights) << " vs "
+        << Temple::stringify(sweep.weights)
+      );
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(numUnlinkedStereopermutationsTest, *boost::unit_test::label("Stereopermutations")) {
   // Crosscheck number of unlinked stereopermutations with shapes
   for(const Shapes::Shape shape : Shapes::allShapes) {
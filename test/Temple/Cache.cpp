@@ -113,3 +113,43 @@ BOOST_AUTO_TEST_CASE(SimpleCacheTest, *boost::unit_test::label("Temple")) {
   bar.changeCacheValue();
   BOOST_CHECK(bar.getAckermann() == 4);
 }
+
+BOOST_AUTO_TEST_CASE(ConcurrentLruCacheTest, *boost::unit_test::label("Temple")) {
+  Temple::ConcurrentLruCache<unsigned, unsigned> cache;
+  unsigned generations = 0;
+  const auto square = [&](const unsigned i) {
+    return [&generations, i]() {
+      ++generations;
+      return i * i;
+    };
+  };
+
+  const unsigned capacity = 2;
+  BOOST_CHECK_EQUAL(*cache.get(3, capacity, square(3)), 9);
+  BOOST_CHECK_EQUAL(*cache.get(3, capacity, square(3)), 9);
+  BOOST_CHECK_EQUAL(generations, 1);
+
+  // Least recently used entries are evicted beyond capacity
+  cache.get(4, capacity, square(4));
+  cache.get(3, capacity, square(3));
+  cache.get(5, capacity, square(5));
+  BOOST_CHECK_EQUAL(generations, 3);
+  cache.get(3, capacity, square(3));
+  BOOST_CHECK_EQUAL(generations, 3);
+  cache.get(4, capacity, square(4));
+  BOOST_CHECK_EQUAL(generations, 4);
+
+  auto statistics = cache.statistics();
+  BOOST_CHECK_EQUAL(statistics.hits, 3);
+  BOOST_CHECK_EQUAL(statistics.misses, 4);
+  BOOST_CHECK_EQUAL(statistics.size, capacity);
+
+  // Zero capacity generates without caching
+  cache.clear();
+  cache.get(3, 0, square(3));
+  cache.get(3, 0, square(3));
+  statistics = cache.statistics();
+  BOOST_CHECK_EQUAL(statistics.hits, 0);
+  BOOST_CHECK_EQUAL(statistics.misses, 2);
+  BOOST_CHECK_EQUAL(statistics.size, 0);
+}
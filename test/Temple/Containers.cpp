@@ -238,4 +238,34 @@ BOOST_AUTO_TEST_CASE(TrieTests, *boost::unit_test::label("Temple")) {
       listsSet.insert(list);
     }
   }
+  {
+    // Structure encoding round trip
+    using TrieType = Temple::BoundedNodeTrie<std::uint8_t>;
+    const TrieType::ChoiceList boundaries {3, 2, 4, 3};
+    TrieType trie {boundaries};
+    auto chooseFunctor = make_ChooseFunctor(trie, generator);
+
+    std::set<TrieType::ChoiceList> listsSet;
+    while(trie.size() != trie.capacity()) {
+      TrieType decoded {boundaries};
+      decoded.setStructure(trie.structure());
+      BOOST_REQUIRE_EQUAL(decoded.size(), trie.size());
+      BOOST_CHECK(
+        Temple::all_of(listsSet, [&](const auto& l) { return decoded.contains(l); })
+      );
+
+      // Generation continues from the decoded trie
+      const auto list = decoded.generateNewEntry(chooseFunctor);
+      BOOST_REQUIRE(listsSet.count(list) == 0);
+      listsSet.insert(list);
+      trie.insert(list);
+    }
+
+    // Full tries encode compactly
+    BOOST_CHECK_EQUAL(trie.structure().size(), 2 * boundaries.front());
+
+    TrieType::Structure truncated = trie.structure();
+    truncated.resize(3);
+    BOOST_CHECK_THROW(trie.setStructure(truncated), std::invalid_argument);
+  }
 }
@@ -78,3 +78,32 @@ BOOST_AUTO_TEST_CASE(TrustRegionNewton, *boost::unit_test::label("Temple")) {
     << " iterations at " << parameters.transpose() << ". Gradient norm is " << optimizationResult.gradient.norm()
   );
 }
+
+BOOST_AUTO_TEST_CASE(TruncatedTrustRegionNewton, *boost::unit_test::label("Temple")) {
+  Eigen::VectorXd parameters = Eigen::VectorXd::Random(2);
+
+  Himmelblau function;
+  auto optimizationResult = Temple::TruncatedTrustRegionOptimizer<> {}.minimize(
+    parameters,
+    [&](const Eigen::VectorXd& p, double& value, Eigen::Ref<Eigen::VectorXd> gradient) {
+      Eigen::MatrixXd hessian(2, 2);
+      function(p, value, gradient, hessian);
+    },
+    [&](const Eigen::VectorXd& p, const Eigen::VectorXd& direction, Eigen::Ref<Eigen::VectorXd> product) {
+      double value;
+      Eigen::VectorXd gradient(2);
+      Eigen::MatrixXd hessian(2, 2);
+      function(p, value, gradient, hessian);
+      product = hessian * direction;
+    },
+    function
+  );
+
+  BOOST_CHECK_MESSAGE(
+    std::fabs(optimizationResult.value) <= 1e-5,
+    "Truncated trust region does not find minimization of Himmelblau function, value is "
+    << optimizationResult.value << " after " << optimizationResult.iterations
+    << " iterations at " << parameters.transpose() << ". Gradient norm is " << optimizationResult.gradient.norm()
+  );
+  BOOST_CHECK_CLOSE(function(parameters), optimizationResult.value, 1e-8);
+}